@@ -19,6 +19,7 @@
 #include "Sdk/C/Alloc.h"
 #include "Sdk/C/7zFile.h"
 #include "Sdk/C/7zVersion.h"
+#include "Sdk/C/CpuArch.h"
 #include "Sdk/C/LzmaDec.h"
 #include "Sdk/C/LzmaEnc.h"
 #include "Sdk/C/Bra.h"
@@ -27,6 +28,15 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Chunked container: a 16 byte header ('LZCK', chunk size, chunk count and
+// uncompressed size, all little endian UInt32) followed by one UInt32 offset
+// per chunk and by the chunks, each one being a regular LZMA stream.
+//
+#define LZMA_CHUNKED_SIGNATURE          0x4B435A4C
+#define LZMA_CHUNKED_HEADER_SIZE        16
+#define LZMA_CHUNKED_DEFAULT_CHUNK_SIZE (1 << 20)
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -41,6 +51,8 @@ const char *kInvalidParamValMessage = "Invalid parameter value";
 
 static BoolInt mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static BoolInt mChunked = False;
+static UInt32 mChunkSize = LZMA_CHUNKED_DEFAULT_CHUNK_SIZE;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
@@ -60,6 +72,8 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunked: use the chunked container, whose chunks can be decoded in parallel\n"
+             "  --chunk-size Size: set the chunk size in bytes for --chunked, default: 1048576\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -174,6 +188,166 @@ Done:
   return res;
 }
 
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t outPos;
+  UInt32 chunkCount;
+  UInt32 i;
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = (UInt32)((fileSize + mChunkSize - 1) / mChunkSize);
+
+  // we allocate 105% of original size + 64KB for every chunk
+  outSize = LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * 4 +
+            inSize / 20 * 21 + (size_t)chunkCount * (LZMA_HEADER_SIZE + 21 + (1 << 16));
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  SetUi32(outBuffer, LZMA_CHUNKED_SIGNATURE);
+  SetUi32(outBuffer + 4, mChunkSize);
+  SetUi32(outBuffer + 8, chunkCount);
+  SetUi32(outBuffer + 12, (UInt32)inSize);
+  outPos = LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * 4;
+
+  for (i = 0; i < chunkCount; i++) {
+    CLzmaEncProps chunkProps = *props;
+    size_t chunkStart = (size_t)i * mChunkSize;
+    size_t chunkSize = inSize - chunkStart < mChunkSize ? inSize - chunkStart : mChunkSize;
+    size_t outSizeProcessed = outSize - outPos - LZMA_HEADER_SIZE;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int j;
+
+    //
+    // Chunks never reference each other, so a dictionary larger than the
+    // chunk only wastes encoder memory.
+    //
+    chunkProps.reduceSize = chunkSize;
+
+    SetUi32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + i * 4, (UInt32)outPos);
+    for (j = 0; j < 8; j++)
+      outBuffer[outPos + LZMA_PROPS_SIZE + j] = (Byte)((UInt64)chunkSize >> (8 * j));
+
+    res = LzmaEncode(outBuffer + outPos + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + chunkStart, chunkSize,
+        &chunkProps, outBuffer + outPos, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+
+    if (res != SZ_OK)
+      goto Done;
+
+    outPos += LZMA_HEADER_SIZE + outSizeProcessed;
+    if (outPos > 0xFFFFFFFF) {
+      res = SZ_ERROR_PARAM;
+      goto Done;
+    }
+  }
+
+  if (outStream->Write(outStream, outBuffer, outPos) != outPos)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  UInt32 chunkSize;
+  UInt32 chunkCount;
+  size_t outSize;
+  UInt32 i;
+
+  if (inSize < LZMA_CHUNKED_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkSize = GetUi32(inBuffer + 4);
+  chunkCount = GetUi32(inBuffer + 8);
+  outSize = GetUi32(inBuffer + 12);
+  if (GetUi32(inBuffer) != LZMA_CHUNKED_SIGNATURE || chunkSize == 0 ||
+      chunkCount != (UInt32)(((UInt64)outSize + chunkSize - 1) / chunkSize) ||
+      chunkCount > (inSize - LZMA_CHUNKED_HEADER_SIZE) / 4) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  if (outSize == 0) {
+    res = SZ_OK;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  for (i = 0; i < chunkCount; i++) {
+    size_t chunkStart = GetUi32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + i * 4);
+    size_t chunkEnd = i + 1 < chunkCount ? GetUi32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + (i + 1) * 4) : inSize;
+    size_t destSize = i + 1 < chunkCount ? chunkSize : outSize - (size_t)i * chunkSize;
+    size_t inSizePure;
+    ELzmaStatus status;
+
+    if (chunkEnd > inSize || chunkStart + LZMA_HEADER_SIZE > chunkEnd) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    inSizePure = chunkEnd - chunkStart - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + (size_t)i * chunkSize, &destSize,
+        inBuffer + chunkStart + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + chunkStart, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+
+    if (res != SZ_OK)
+      goto Done;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -272,6 +446,18 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      mChunked = True;
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      UINT64 chunkSize;
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      if (AsciiStringToUint64(args[++param], FALSE, &chunkSize) != EFI_SUCCESS ||
+          chunkSize < (1 << 12) || chunkSize > (1 << 30)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      mChunkSize = (UInt32)chunkSize;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +528,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunked && mConType != NoConverter) {
+    return PrintError(rs, "--f86 can not be used with --chunked");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +554,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mChunked) {
+      res = EncodeChunked(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mChunked) {
+      res = DecodeChunked(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
@@ -404,6 +404,250 @@ FatGetCachePage (
   return Status;
 }
 
+/**
+
+  Check whether a Data cache page holds the current data of a page. This is
+  the test FatFlushDataCacheRange() uses, so a page that is dirty in the cache
+  is never read from disk instead.
+
+  @param  DiskCache             - The Data cache.
+  @param  PageNo                - The page to check.
+
+  @retval TRUE                  - The page is in the cache.
+  @retval FALSE                 - The page is not in the cache.
+
+**/
+STATIC
+BOOLEAN
+FatIsDataPageCached (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+
+  CacheTag = &DiskCache->CacheTag[PageNo & DiskCache->GroupMask];
+  return (BOOLEAN)((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo));
+}
+
+/**
+
+  Read aligned Data pages for a blocking read. The pages that are in the
+  Data cache are copied from it, and each run of consecutive pages that are
+  not cached is read from disk with one request.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The first page to read.
+  @param  PageCount             - The number of pages to read.
+  @param  Buffer                - Buffer receiving the data.
+
+  @retval EFI_SUCCESS           - The data was read correctly.
+  @return Others                - An error occurred when reading the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAlignedDataPages (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       PageNo,
+  IN  UINTN       PageCount,
+  OUT UINT8       *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  UINT8       PageAlignment;
+  UINTN       Index;
+  UINTN       Run;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+
+  Index = 0;
+  while (Index < PageCount) {
+    if (FatIsDataPageCached (DiskCache, PageNo + Index)) {
+      CopyMem (
+        Buffer + (Index << PageAlignment),
+        DiskCache->CacheBase + (((PageNo + Index) & DiskCache->GroupMask) << PageAlignment),
+        (UINTN)1 << PageAlignment
+        );
+      Index++;
+      continue;
+    }
+
+    Run = 1;
+    while ((Index + Run < PageCount) && !FatIsDataPageCached (DiskCache, PageNo + Index + Run)) {
+      Run++;
+    }
+
+    Status = FatDiskIo (
+               Volume,
+               ReadDisk,
+               DiskCache->BaseAddress + LShiftU64 (PageNo + Index, PageAlignment),
+               Run << PageAlignment,
+               Buffer + (Index << PageAlignment),
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Index += Run;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Read the data pages that cover a disk range into the Data cache ahead of use.
+
+  Pages at the start of the range that are cached already are skipped. The
+  remaining pages are read with one disk request, which stops at the first page
+  that is cached, whose cache slot holds dirty data, or whose slot would wrap
+  around the end of the cache. Nothing is read if fewer than MinPageCount pages
+  qualify. The read-ahead is a hint; errors are ignored.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset of the range on the disk.
+  @param  Length                - The number of bytes in the range.
+  @param  MinPageCount          - The minimum number of pages worth a disk request.
+
+**/
+VOID
+FatReadAheadDataCache (
+  IN FAT_VOLUME  *Volume,
+  IN UINT64      Offset,
+  IN UINTN       Length,
+  IN UINTN       MinPageCount
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINT8       PageAlignment;
+  UINTN       PageSize;
+  UINTN       PageNo;
+  UINTN       EndPageNo;
+  UINTN       PageCount;
+  UINTN       Index;
+  UINT64      EntryPos;
+  UINT64      MaxSize;
+  UINTN       ReadSize;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
+  if ((Length == 0) || (Offset < DiskCache->BaseAddress) || (Offset + Length > DiskCache->LimitAddress)) {
+    return;
+  }
+
+  PageNo    = (UINTN)RShiftU64 (Offset - DiskCache->BaseAddress, PageAlignment);
+  EndPageNo = (UINTN)RShiftU64 (Offset + Length - DiskCache->BaseAddress + PageSize - 1, PageAlignment);
+  while ((PageNo < EndPageNo) && FatIsDataPageCached (DiskCache, PageNo)) {
+    PageNo++;
+  }
+
+  for (PageCount = 0; PageNo + PageCount < EndPageNo; PageCount++) {
+    CacheTag = &DiskCache->CacheTag[(PageNo + PageCount) & DiskCache->GroupMask];
+    if ((PageCount > 0) && (((PageNo + PageCount) & DiskCache->GroupMask) == 0)) {
+      break;
+    }
+
+    if ((CacheTag->RealSize > 0) && ((CacheTag->PageNo == PageNo + PageCount) || CacheTag->Dirty)) {
+      break;
+    }
+  }
+
+  if ((PageCount == 0) || (PageCount < MinPageCount)) {
+    return;
+  }
+
+  //
+  // The slots are overwritten by the read, so invalidate them first.
+  //
+  for (Index = 0; Index < PageCount; Index++) {
+    DiskCache->CacheTag[(PageNo + Index) & DiskCache->GroupMask].RealSize = 0;
+  }
+
+  EntryPos = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  MaxSize  = DiskCache->LimitAddress - EntryPos;
+  ReadSize = PageCount << PageAlignment;
+  if (MaxSize < ReadSize) {
+    ReadSize = (UINTN)MaxSize;
+  }
+
+  Status = Volume->DiskIo->ReadDisk (
+                             Volume->DiskIo,
+                             Volume->MediaId,
+                             EntryPos,
+                             ReadSize,
+                             DiskCache->CacheBase + ((PageNo & DiskCache->GroupMask) << PageAlignment)
+                             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag         = &DiskCache->CacheTag[(PageNo + Index) & DiskCache->GroupMask];
+    CacheTag->PageNo = PageNo + Index;
+    ClearCacheTagDirtyState (CacheTag);
+    CacheTag->RealSize = MIN (PageSize, ReadSize - (Index << PageAlignment));
+  }
+}
+
+/**
+
+  Get the address of FAT data in the FAT cache, loading the cache page if needed.
+
+  The address is only valid until the FAT cache is accessed again.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The byte offset of the FAT data on the disk.
+  @param  Buffer                - Returns the address of the FAT data.
+  @param  Length                - Returns the number of valid bytes at Buffer.
+
+  @retval EFI_SUCCESS           - The FAT data is in the cache.
+  @return Others                - An error occurred when loading the cache page.
+
+**/
+EFI_STATUS
+FatGetFatCacheData (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINT64      Offset,
+  OUT UINT8       **Buffer,
+  OUT UINTN       *Length
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINT64      EntryPos;
+  UINTN       PageNo;
+  UINTN       GroupNo;
+  UINTN       PageOffset;
+
+  DiskCache  = &Volume->DiskCache[CacheFat];
+  EntryPos   = Offset - DiskCache->BaseAddress;
+  PageNo     = (UINTN)RShiftU64 (EntryPos, DiskCache->PageAlignment);
+  PageOffset = (UINTN)EntryPos & (((UINTN)1 << DiskCache->PageAlignment) - 1);
+  GroupNo    = PageNo & DiskCache->GroupMask;
+  CacheTag   = &DiskCache->CacheTag[GroupNo];
+
+  Status = FatGetCachePage (Volume, CacheFat, PageNo, CacheTag);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (PageOffset >= CacheTag->RealSize) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  *Buffer = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + PageOffset;
+  *Length = CacheTag->RealSize - PageOffset;
+  return EFI_SUCCESS;
+}
+
 /**
 
   Read Length bytes from the position of Offset into Buffer, or
@@ -473,8 +717,10 @@ FatAccessUnalignedCachePage (
      the right cache page.
   2. Access of Data cache (CACHE_DATA):
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
-     The UnderRun data and OverRun data will be accessed by the Data cache,
-     but the Aligned data will be accessed with disk directly.
+     The UnderRun data and OverRun data will be accessed by the Data cache.
+     Blocking reads of the Aligned data copy the pages that are in the Data cache
+     and read the others from disk; other accesses of the Aligned data go to
+     disk directly.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -550,18 +796,25 @@ FatAccessCache (
     //
     ASSERT (CacheDataType == CacheData);
 
-    EntryPos    = Volume->RootPos + LShiftU64 (PageNo, PageAlignment);
     AlignedSize = AlignedPageCount << PageAlignment;
-    Status      = FatDiskIo (Volume, IoMode, EntryPos, AlignedSize, Buffer, Task);
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+    if ((IoMode == ReadDisk) && (Task == NULL)) {
+      Status = FatReadAlignedDataPages (Volume, PageNo, AlignedPageCount, Buffer);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    } else {
+      EntryPos = Volume->RootPos + LShiftU64 (PageNo, PageAlignment);
+      Status   = FatDiskIo (Volume, IoMode, EntryPos, AlignedSize, Buffer, Task);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
 
-    //
-    // If these access data over laps the relative cache range, these cache pages need
-    // to be updated.
-    //
-    FatFlushDataCacheRange (Volume, IoMode, PageNo, OverRunPageNo, Buffer);
+      //
+      // If these access data over laps the relative cache range, these cache pages need
+      // to be updated.
+      //
+      FatFlushDataCacheRange (Volume, IoMode, PageNo, OverRunPageNo, Buffer);
+    }
     Buffer     += AlignedSize;
     BufferSize -= AlignedSize;
   }
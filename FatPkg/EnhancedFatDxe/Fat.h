@@ -80,7 +80,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_GROUP_COUNT         FixedPcdGet32 (PcdFatDataCachePageCount)
+#define FAT_READ_AHEAD_PAGE_COUNT         MIN (FixedPcdGet32 (PcdFatReadAheadPageCount), FAT_DATACACHE_GROUP_COUNT / 2)
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
@@ -97,6 +98,11 @@ typedef UINT64 DIRTY_BLOCKS;
 
 STATIC_ASSERT ((((1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT) / (1 << MIN_BLOCK_ALIGNMENT)) % sizeof (DIRTY_BLOCKS)) == 0, "DIRTY_BLOCKS not a proper size");
 
+STATIC_ASSERT (
+  (FAT_DATACACHE_GROUP_COUNT >= FAT_FATCACHE_GROUP_MAX_COUNT) && ((FAT_DATACACHE_GROUP_COUNT & (FAT_DATACACHE_GROUP_COUNT - 1)) == 0),
+  "PcdFatDataCachePageCount must be a power of 2 of at least FAT_FATCACHE_GROUP_MAX_COUNT"
+  );
+
 //
 // Used in 8.3 generation algorithm
 //
@@ -120,6 +126,15 @@ STATIC_ASSERT ((((1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT) / (1 << MIN_BLOCK_ALIGN
 #define FAT_MAX_DIRENTRY_COUNT   0xFFFF
 typedef CHAR8 LC_ISO_639_2;
 
+//
+// The free cluster bitmap is loaded from the FAT in chunks of this many clusters.
+// The allocator searches at most FAT_FREE_SEARCH_LIMIT clusters past the first
+// free one for a run that is long enough.
+//
+#define FAT_FREE_CHUNK_CLUSTERS  4096
+#define FAT_FREE_CHUNK_UNLOADED  MAX_UINT32
+#define FAT_FREE_SEARCH_LIMIT    (16 * FAT_FREE_CHUNK_CLUSTERS)
+
 //
 // The fat types we support
 //
@@ -286,6 +301,11 @@ struct _FAT_OFILE {
   UINT64        PosDisk;        // on the disk
   UINTN         PosRem;         // remaining in this disk run
   //
+  // The position where the last blocking read ended, used to
+  // detect sequential reads
+  //
+  UINTN         ReadAheadPos;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE     *Parent;
@@ -350,6 +370,15 @@ struct _FAT_VOLUME {
   UINTN                              FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                            FreeInfoValid;  // If free cluster info is valid
   //
+  // Free cluster bitmap, a bit is set if the cluster is free. FreeChunkCount
+  // holds the number of free clusters of each chunk, or FAT_FREE_CHUNK_UNLOADED
+  // if the chunk has not been read from the FAT yet. FreeChunkNum is 0 if the
+  // bitmap could not be allocated.
+  //
+  UINT8                              *FreeBitmap;
+  UINT32                             *FreeChunkCount;
+  UINTN                              FreeChunkNum;
+  //
   // Unpacked Fat BPB info
   //
   UINTN                              NumFats;
@@ -739,8 +768,10 @@ FatInitializeDiskCache (
      the right cache page.
   2. Access of Data cache (CACHE_DATA):
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
-     The UnderRun data and OverRun data will be accessed by the Data cache,
-     but the Aligned data will be accessed with disk directly.
+     The UnderRun data and OverRun data will be accessed by the Data cache.
+     Blocking reads of the Aligned data copy the pages that are in the Data cache
+     and read the others from disk; other accesses of the Aligned data go to
+     disk directly.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -766,6 +797,53 @@ FatAccessCache (
   IN     FAT_TASK         *Task
   );
 
+/**
+
+  Read the data pages that cover a disk range into the Data cache ahead of use.
+
+  Pages at the start of the range that are cached already are skipped. The
+  remaining pages are read with one disk request, which stops at the first page
+  that is cached, whose cache slot holds dirty data, or whose slot would wrap
+  around the end of the cache. Nothing is read if fewer than MinPageCount pages
+  qualify. The read-ahead is a hint; errors are ignored.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset of the range on the disk.
+  @param  Length                - The number of bytes in the range.
+  @param  MinPageCount          - The minimum number of pages worth a disk request.
+
+**/
+VOID
+FatReadAheadDataCache (
+  IN FAT_VOLUME  *Volume,
+  IN UINT64      Offset,
+  IN UINTN       Length,
+  IN UINTN       MinPageCount
+  );
+
+/**
+
+  Get the address of FAT data in the FAT cache, loading the cache page if needed.
+
+  The address is only valid until the FAT cache is accessed again.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The byte offset of the FAT data on the disk.
+  @param  Buffer                - Returns the address of the FAT data.
+  @param  Length                - Returns the number of valid bytes at Buffer.
+
+  @retval EFI_SUCCESS           - The FAT data is in the cache.
+  @return Others                - An error occurred when loading the cache page.
+
+**/
+EFI_STATUS
+FatGetFatCacheData (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINT64      Offset,
+  OUT UINT8       **Buffer,
+  OUT UINTN       *Length
+  );
+
 /**
 
   Flush all the dirty cache back, include the FAT cache and the Data cache.
@@ -975,6 +1053,20 @@ FatComputeFreeInfo (
   IN FAT_VOLUME  *Volume
   );
 
+/**
+
+  Allocate the free cluster bitmap of the volume. The bitmap is filled in from
+  the FAT one chunk at a time when the chunk is first needed. If there is not
+  enough memory the volume works without the bitmap.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeBitmap (
+  IN FAT_VOLUME  *Volume
+  );
+
 /**
 
   Get the FAT entry value of the volume, which is identified with the Index.
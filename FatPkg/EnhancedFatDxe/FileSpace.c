@@ -70,6 +70,142 @@ FatLoadFatEntry (
   return &Volume->FatEntryBuffer;
 }
 
+/**
+
+  Read the FAT entries of one chunk of clusters into the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Chunk                 - The chunk to load.
+
+  @retval EFI_SUCCESS           - The chunk is loaded.
+  @return other                 - An error occurred when reading the FAT.
+
+**/
+STATIC
+EFI_STATUS
+FatLoadFreeChunk (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Chunk
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       Last;
+  UINT32      Count;
+  UINT8       *Entries;
+  UINTN       Length;
+  UINTN       Available;
+  UINTN       Value;
+
+  Index = Chunk * FAT_FREE_CHUNK_CLUSTERS;
+  Last  = MIN (Index + FAT_FREE_CHUNK_CLUSTERS, Volume->MaxCluster + 2);
+  Count = 0;
+  ZeroMem (Volume->FreeBitmap + Index / 8, FAT_FREE_CHUNK_CLUSTERS / 8);
+
+  Index = MAX (Index, FAT_MIN_CLUSTER);
+  while (Index < Last) {
+    if (Volume->FatType == Fat12) {
+      //
+      // FAT12 entries are not byte aligned, and FAT12 volumes are small.
+      //
+      Available = 1;
+    } else {
+      //
+      // Decode the FAT16/FAT32 entries in place in the FAT cache.
+      //
+      Status = FatGetFatCacheData (Volume, Volume->FatPos + Index * Volume->FatEntrySize, &Entries, &Length);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Available = MIN (Length / Volume->FatEntrySize, Last - Index);
+      if (Available == 0) {
+        return EFI_VOLUME_CORRUPTED;
+      }
+    }
+
+    for ( ; Available > 0; Available--, Index++) {
+      if (Volume->FatType == Fat12) {
+        Value = FatGetFatEntry (Volume, Index);
+        if (Volume->DiskError) {
+          return EFI_DEVICE_ERROR;
+        }
+      } else if (Volume->FatType == Fat16) {
+        Value   = ReadUnaligned16 ((UINT16 *)Entries);
+        Entries = Entries + sizeof (UINT16);
+      } else {
+        Value   = ReadUnaligned32 ((UINT32 *)Entries) & FAT_CLUSTER_MASK_FAT32;
+        Entries = Entries + sizeof (UINT32);
+      }
+
+      if (Value == FAT_CLUSTER_FREE) {
+        Volume->FreeBitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+        Count++;
+      }
+    }
+  }
+
+  Volume->FreeChunkCount[Chunk] = Count;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Make sure the chunk of the free cluster bitmap that holds Cluster is loaded.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The cluster.
+
+  @retval EFI_SUCCESS           - The chunk is loaded.
+  @return other                 - An error occurred when reading the FAT.
+
+**/
+STATIC
+EFI_STATUS
+FatEnsureFreeChunk (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Cluster
+  )
+{
+  UINTN  Chunk;
+
+  Chunk = Cluster / FAT_FREE_CHUNK_CLUSTERS;
+  if (Volume->FreeChunkCount[Chunk] != FAT_FREE_CHUNK_UNLOADED) {
+    return EFI_SUCCESS;
+  }
+
+  return FatLoadFreeChunk (Volume, Chunk);
+}
+
+/**
+
+  Check whether a cluster is free according to the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The cluster.
+
+  @retval TRUE                  - The cluster is free.
+  @retval FALSE                 - The cluster is in use, or the FAT cannot be read.
+
+**/
+STATIC
+BOOLEAN
+FatIsClusterFree (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Cluster
+  )
+{
+  if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+    return FALSE;
+  }
+
+  if (EFI_ERROR (FatEnsureFreeChunk (Volume, Cluster))) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)((Volume->FreeBitmap[Cluster / 8] & (1 << (Cluster % 8))) != 0);
+}
+
 /**
 
   Get the FAT entry value of the volume, which is identified with the Index.
@@ -149,21 +285,33 @@ FatSetFatEntry (
   UINTN       Accum;
   EFI_STATUS  Status;
   UINTN       OriginalVal;
+  UINTN       Chunk;
 
   if (Index < FAT_MIN_CLUSTER) {
     return EFI_VOLUME_CORRUPTED;
   }
 
   OriginalVal = FatGetFatEntry (Volume, Index);
+  Chunk       = Index / FAT_FREE_CHUNK_CLUSTERS;
   if ((Value == FAT_CLUSTER_FREE) && (OriginalVal != FAT_CLUSTER_FREE)) {
     Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
     if (Index < Volume->FatInfoSector.FreeInfo.NextCluster) {
       Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)Index;
     }
+
+    if ((Volume->FreeChunkNum != 0) && (Volume->FreeChunkCount[Chunk] != FAT_FREE_CHUNK_UNLOADED)) {
+      Volume->FreeBitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+      Volume->FreeChunkCount[Chunk] += 1;
+    }
   } else if ((Value != FAT_CLUSTER_FREE) && (OriginalVal == FAT_CLUSTER_FREE)) {
     if (Volume->FatInfoSector.FreeInfo.ClusterCount != 0) {
       Volume->FatInfoSector.FreeInfo.ClusterCount -= 1;
     }
+
+    if ((Volume->FreeChunkNum != 0) && (Volume->FreeChunkCount[Chunk] != FAT_FREE_CHUNK_UNLOADED)) {
+      Volume->FreeBitmap[Index / 8] &= (UINT8) ~(1 << (Index % 8));
+      Volume->FreeChunkCount[Chunk] -= 1;
+    }
   }
 
   //
@@ -313,6 +461,162 @@ FatAllocateCluster (
   return Cluster;
 }
 
+/**
+
+  Find a run of free clusters in the free cluster bitmap.
+
+  The search starts at FreeInfo.NextCluster and wraps around the end of the
+  volume. Chunks and bytes of the bitmap without free clusters are skipped.
+  The first run that is long enough is returned; otherwise the longest run
+  seen within FAT_FREE_SEARCH_LIMIT clusters past the first free one.
+
+  @param  Volume                - FAT file system volume.
+  @param  Wanted                - The number of clusters wanted.
+
+  @return The first cluster of the run, or FAT_CLUSTER_FREE if there is no free cluster.
+
+**/
+STATIC
+UINTN
+FatFindFreeRun (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Wanted
+  )
+{
+  UINTN  Cluster;
+  UINTN  Remaining;
+  UINTN  Step;
+  UINTN  RunStart;
+  UINTN  RunLength;
+  UINTN  BestStart;
+  UINTN  BestLength;
+  UINTN  FirstFree;
+  UINTN  Scanned;
+
+  Cluster = Volume->FatInfoSector.FreeInfo.NextCluster;
+  if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+    Cluster = FAT_MIN_CLUSTER;
+  }
+
+  RunStart   = FAT_CLUSTER_FREE;
+  RunLength  = 0;
+  BestStart  = FAT_CLUSTER_FREE;
+  BestLength = 0;
+  FirstFree  = 0;
+  for (Remaining = Volume->MaxCluster, Scanned = 0; Remaining > 0; Remaining -= Step, Scanned += Step) {
+    if (Cluster > Volume->MaxCluster + 1) {
+      Cluster   = FAT_MIN_CLUSTER;
+      RunLength = 0;
+    }
+
+    if ((BestLength != 0) && (Scanned - FirstFree > FAT_FREE_SEARCH_LIMIT)) {
+      break;
+    }
+
+    if (EFI_ERROR (FatEnsureFreeChunk (Volume, Cluster))) {
+      break;
+    }
+
+    Step = 1;
+    if (Volume->FreeChunkCount[Cluster / FAT_FREE_CHUNK_CLUSTERS] == 0) {
+      Step = FAT_FREE_CHUNK_CLUSTERS - Cluster % FAT_FREE_CHUNK_CLUSTERS;
+    } else if ((Cluster % 8 == 0) && (Volume->FreeBitmap[Cluster / 8] == 0)) {
+      Step = 8;
+    }
+
+    if (Step > 1) {
+      Step       = MIN (Step, MIN (Remaining, Volume->MaxCluster + 2 - Cluster));
+      Cluster   += Step;
+      RunLength  = 0;
+      continue;
+    }
+
+    if ((Volume->FreeBitmap[Cluster / 8] & (1 << (Cluster % 8))) == 0) {
+      Cluster++;
+      RunLength = 0;
+      continue;
+    }
+
+    if (RunLength == 0) {
+      RunStart = Cluster;
+    }
+
+    if (BestLength == 0) {
+      FirstFree = Scanned;
+    }
+
+    RunLength++;
+    if (RunLength > BestLength) {
+      BestStart  = RunStart;
+      BestLength = RunLength;
+      if (BestLength >= Wanted) {
+        break;
+      }
+    }
+
+    Cluster++;
+  }
+
+  return BestStart;
+}
+
+/**
+
+  Allocate a run of contiguous free clusters. The clusters are not marked
+  as used in the FAT; the caller links them into a cluster chain.
+
+  @param  Volume                - FAT file system volume.
+  @param  LastCluster           - The last cluster of the file, or FAT_CLUSTER_FREE
+                                  if the file has no cluster yet.
+  @param  Wanted                - The number of clusters wanted.
+  @param  RunLength             - Returns the number of clusters in the run,
+                                  between 1 and Wanted.
+
+  @return The first cluster of the run, or FAT_CLUSTER_LAST if the volume is full.
+
+**/
+STATIC
+UINTN
+FatAllocateClusterRun (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       LastCluster,
+  IN  UINTN       Wanted,
+  OUT UINTN       *RunLength
+  )
+{
+  UINTN  Cluster;
+  UINTN  Length;
+
+  if (Volume->DiskError) {
+    return (UINTN)FAT_CLUSTER_LAST;
+  }
+
+  if (Volume->FreeChunkNum == 0) {
+    *RunLength = 1;
+    return FatAllocateCluster (Volume);
+  }
+
+  //
+  // Grow the file in place if the cluster after its end is free,
+  // otherwise look for a run that holds all the wanted clusters.
+  //
+  if ((LastCluster != FAT_CLUSTER_FREE) && FatIsClusterFree (Volume, LastCluster + 1)) {
+    Cluster = LastCluster + 1;
+  } else {
+    Cluster = FatFindFreeRun (Volume, Wanted);
+    if (Cluster == FAT_CLUSTER_FREE) {
+      return (UINTN)FAT_CLUSTER_LAST;
+    }
+  }
+
+  for (Length = 1; Length < Wanted && FatIsClusterFree (Volume, Cluster + Length); Length++) {
+  }
+
+  *RunLength                                 = Length;
+  Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)(Cluster + Length);
+  return Cluster;
+}
+
 /**
 
   Count the number of clusters given a size.
@@ -438,6 +742,7 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  UINTN       RunLength;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -493,7 +798,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateClusterRun (Volume, LastCluster, NewSize - CurSize, &RunLength);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN)FAT_CLUSTER_LAST);
@@ -504,27 +809,33 @@ FatGrowEof (
         goto Done;
       }
 
-      if ((NewCluster < FAT_MIN_CLUSTER) || (NewCluster > Volume->MaxCluster + 1)) {
+      if ((NewCluster < FAT_MIN_CLUSTER) || (NewCluster + RunLength - 1 > Volume->MaxCluster + 1)) {
         Status = EFI_VOLUME_CORRUPTED;
         goto Done;
       }
 
-      if (LastCluster != 0) {
-        FatSetFatEntry (Volume, LastCluster, NewCluster);
-      } else {
-        OFile->FileCluster        = NewCluster;
-        OFile->FileCurrentCluster = NewCluster;
-      }
+      //
+      // Link the run into the cluster chain. The clusters of the run are
+      // still free in the FAT until they are linked.
+      //
+      for ( ; RunLength > 0; RunLength--, NewCluster++) {
+        if (LastCluster != 0) {
+          FatSetFatEntry (Volume, LastCluster, NewCluster);
+        } else {
+          OFile->FileCluster        = NewCluster;
+          OFile->FileCurrentCluster = NewCluster;
+        }
 
-      LastCluster = NewCluster;
-      CurSize    += 1;
+        LastCluster = NewCluster;
+        CurSize    += 1;
+      }
 
       //
       // Terminate the cluster list
       //
-      // Note that we must do this EVERY time we allocate a cluster, because
-      // FatAllocateCluster scans the FAT looking for a free cluster and
-      // "LastCluster" is no longer free!  Usually, FatAllocateCluster will
+      // Note that we must do this EVERY time we allocate a run, because
+      // the allocator scans the FAT looking for free clusters and
+      // "LastCluster" is no longer free!  Usually, the allocator will
       // start looking with the cluster after "LastCluster"; however, when
       // there is only one free cluster left, it will find "LastCluster"
       // a second time.  There are other, less predictable scenarios
@@ -721,10 +1032,37 @@ FatComputeFreeInfo (
   )
 {
   UINTN  Index;
+  UINTN  Chunk;
 
   //
   // If we don't have valid info, compute it now
   //
+  if (!Volume->FreeInfoValid && (Volume->FreeChunkNum != 0)) {
+    //
+    // Load the whole free cluster bitmap; the chunks keep the counts up to date from now on
+    //
+    Volume->FreeInfoValid                       = TRUE;
+    Volume->FatInfoSector.FreeInfo.ClusterCount = 0;
+    for (Chunk = 0; Chunk < Volume->FreeChunkNum; Chunk++) {
+      if (Volume->DiskError || EFI_ERROR (FatEnsureFreeChunk (Volume, Chunk * FAT_FREE_CHUNK_CLUSTERS))) {
+        break;
+      }
+
+      if ((Volume->FatInfoSector.FreeInfo.ClusterCount == 0) && (Volume->FreeChunkCount[Chunk] != 0)) {
+        for (Index = Chunk * FAT_FREE_CHUNK_CLUSTERS; !FatIsClusterFree (Volume, Index); Index++) {
+        }
+
+        Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)Index;
+      }
+
+      Volume->FatInfoSector.FreeInfo.ClusterCount += Volume->FreeChunkCount[Chunk];
+    }
+
+    Volume->FatInfoSector.Signature          = FAT_INFO_SIGNATURE;
+    Volume->FatInfoSector.InfoBeginSignature = FAT_INFO_BEGIN_SIGNATURE;
+    Volume->FatInfoSector.InfoEndSignature   = FAT_INFO_END_SIGNATURE;
+  }
+
   if (!Volume->FreeInfoValid) {
     Volume->FreeInfoValid                       = TRUE;
     Volume->FatInfoSector.FreeInfo.ClusterCount = 0;
@@ -744,3 +1082,41 @@ FatComputeFreeInfo (
     Volume->FatInfoSector.InfoEndSignature   = FAT_INFO_END_SIGNATURE;
   }
 }
+
+/**
+
+  Allocate the free cluster bitmap of the volume. The bitmap is filled in from
+  the FAT one chunk at a time when the chunk is first needed. If there is not
+  enough memory the volume works without the bitmap.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeBitmap (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  UINTN  ChunkNum;
+
+  ChunkNum               = (Volume->MaxCluster + 2 + FAT_FREE_CHUNK_CLUSTERS - 1) / FAT_FREE_CHUNK_CLUSTERS;
+  Volume->FreeBitmap     = AllocatePool (ChunkNum * FAT_FREE_CHUNK_CLUSTERS / 8);
+  Volume->FreeChunkCount = AllocatePool (ChunkNum * sizeof (UINT32));
+  if ((Volume->FreeBitmap == NULL) || (Volume->FreeChunkCount == NULL)) {
+    DEBUG ((DEBUG_WARN, "FatInitializeFreeBitmap: no memory for the free cluster bitmap\n"));
+    if (Volume->FreeBitmap != NULL) {
+      FreePool (Volume->FreeBitmap);
+      Volume->FreeBitmap = NULL;
+    }
+
+    if (Volume->FreeChunkCount != NULL) {
+      FreePool (Volume->FreeChunkCount);
+      Volume->FreeChunkCount = NULL;
+    }
+
+    return;
+  }
+
+  SetMem32 (Volume->FreeChunkCount, ChunkNum * sizeof (UINT32), FAT_FREE_CHUNK_UNLOADED);
+  Volume->FreeChunkNum = ChunkNum;
+}
@@ -469,5 +469,6 @@ FatOpenDevice (
     return EFI_VOLUME_CORRUPTED;
   }
 
+  FatInitializeFreeBitmap (Volume);
   return EFI_SUCCESS;
 }
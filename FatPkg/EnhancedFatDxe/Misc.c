@@ -468,6 +468,17 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
 
+  //
+  // Free free cluster bitmap
+  //
+  if (Volume->FreeBitmap != NULL) {
+    FreePool (Volume->FreeBitmap);
+  }
+
+  if (Volume->FreeChunkCount != NULL) {
+    FreePool (Volume->FreeChunkCount);
+  }
+
   //
   // Free directory cache
   //
@@ -440,6 +440,46 @@ FatWriteEx (
   return FatIFileAccess (FHand, WriteData, &Token->BufferSize, Token->Buffer, Token);
 }
 
+/**
+
+  Read the extent of the file that follows Position into the Data cache.
+
+  The read-ahead follows the cluster chain of the file, but stops at the end
+  of the contiguous run of clusters that Position is in.
+
+  @param  OFile                 - The open file.
+  @param  Position              - The position where the next read is expected.
+
+**/
+STATIC
+VOID
+FatReadAheadOFile (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Position
+  )
+{
+  FAT_VOLUME  *Volume;
+  UINTN       PageCount;
+  UINTN       Length;
+
+  Volume    = OFile->Volume;
+  PageCount = FAT_READ_AHEAD_PAGE_COUNT;
+  if ((PageCount == 0) || (Position >= OFile->FileSize)) {
+    return;
+  }
+
+  Length = MIN (PageCount << Volume->DiskCache[CacheData].PageAlignment, OFile->FileSize - Position);
+  if (EFI_ERROR (FatOFilePosition (OFile, Position, Length))) {
+    return;
+  }
+
+  //
+  // Issue the read-ahead once half of the window has been consumed, so that
+  // it is done with few large requests rather than one request per page.
+  //
+  FatReadAheadDataCache (Volume, OFile->PosDisk, MIN (Length, OFile->PosRem), MAX (PageCount / 2, 1));
+}
+
 /**
 
   This function reads data from a file or writes data to a file.
@@ -470,11 +510,14 @@ FatAccessOFile (
   UINTN       Len;
   EFI_STATUS  Status;
   UINTN       BufferSize;
+  BOOLEAN     Sequential;
 
   BufferSize = *DataBufferSize;
   Volume     = OFile->Volume;
   ASSERT_VOLUME_LOCKED (Volume);
 
+  Sequential = (BOOLEAN)(Position == OFile->ReadAheadPos);
+
   Status = EFI_SUCCESS;
   while (BufferSize > 0) {
     //
@@ -515,6 +558,17 @@ FatAccessOFile (
     ASSERT (Position <= OFile->FileSize);
   }
 
+  //
+  // Read ahead when a blocking read continues where the previous one ended.
+  //
+  if ((IoMode == ReadData) && (Task == NULL) && !EFI_ERROR (Status)) {
+    if (Sequential) {
+      FatReadAheadOFile (OFile, Position);
+    }
+
+    OFile->ReadAheadPos = Position;
+  }
+
   //
   // Update the number of bytes accessed
   //
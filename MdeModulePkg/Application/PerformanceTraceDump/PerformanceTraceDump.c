@@ -0,0 +1,634 @@
+/** @file
+  Shell application to export the performance trace rings of DxeCorePerformanceLib
+  in the Chrome trace event format, which can be loaded by chrome://tracing and
+  the Perfetto UI.
+
+  Usage: PerformanceTraceDump [FileName]
+
+  Without FileName, the trace is printed to the console.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <PiDxe.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PeCoffGetEntryPointLib.h>
+
+#include <Protocol/LoadedImage.h>
+#include <Protocol/DriverBinding.h>
+#include <Protocol/Shell.h>
+#include <Protocol/ShellParameters.h>
+
+#include <Guid/PerformanceTrace.h>
+
+#define TRACE_LINE_LENGTH         512
+#define TRACE_PRINT_LENGTH        128
+#define TRACE_BUFFER_INCREMENT    SIZE_64KB
+#define TRACE_MODULE_NAME_LENGTH  36
+
+typedef struct {
+  EFI_HANDLE    Handle;
+  UINT64        ImageBase;
+  UINT64        ImageSize;
+  CHAR8         Name[TRACE_MODULE_NAME_LENGTH];
+} TRACE_IMAGE_INFO;
+
+TRACE_IMAGE_INFO  *mImages;
+UINTN             mImageCount;
+
+CHAR8  *mTraceBuffer;
+UINTN  mTraceBufferSize;
+UINTN  mTraceLength;
+
+/**
+  Get the file name portion of the Pdb File Name.
+
+  The portion of the Pdb File Name between the last backslash and
+  either a following period or the end of the string is copied into
+  AsciiBuffer.  The name is truncated, if necessary, to ensure that
+  AsciiBuffer is not overrun.
+
+  @param[in]  PdbFileName     Pdb file name.
+  @param[out] AsciiBuffer     The resultant Ascii File Name.
+
+**/
+VOID
+GetShortPdbFileName (
+  IN  CHAR8  *PdbFileName,
+  OUT CHAR8  *AsciiBuffer
+  )
+{
+  UINTN  IndexPdb;    // Current work location within a Pdb string.
+  UINTN  IndexBuffer; // Current work location within a Buffer string.
+  UINTN  StartIndex;
+  UINTN  EndIndex;
+
+  ZeroMem (AsciiBuffer, TRACE_MODULE_NAME_LENGTH);
+
+  StartIndex = 0;
+  for (EndIndex = 0; PdbFileName[EndIndex] != 0; EndIndex++) {
+  }
+
+  for (IndexPdb = 0; PdbFileName[IndexPdb] != 0; IndexPdb++) {
+    if ((PdbFileName[IndexPdb] == '\\') || (PdbFileName[IndexPdb] == '/')) {
+      StartIndex = IndexPdb + 1;
+    }
+
+    if (PdbFileName[IndexPdb] == '.') {
+      EndIndex = IndexPdb;
+    }
+  }
+
+  IndexBuffer = 0;
+  for (IndexPdb = StartIndex; IndexPdb < EndIndex; IndexPdb++) {
+    AsciiBuffer[IndexBuffer] = PdbFileName[IndexPdb];
+    IndexBuffer++;
+    if (IndexBuffer >= TRACE_MODULE_NAME_LENGTH - 1) {
+      break;
+    }
+  }
+}
+
+/**
+  Collect the address range and name of every loaded image, so that the
+  handles and function addresses in the trace can be mapped to modules.
+
+  @retval EFI_SUCCESS            The image list is built.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory for the image list.
+**/
+EFI_STATUS
+CollectImages (
+  VOID
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_HANDLE                 *Handles;
+  UINTN                      HandleCount;
+  UINTN                      Index;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+  TRACE_IMAGE_INFO           *Image;
+  CHAR8                      *PdbFileName;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiLoadedImageProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &Handles
+                  );
+  if (EFI_ERROR (Status)) {
+    return EFI_SUCCESS;
+  }
+
+  mImages = AllocateZeroPool (HandleCount * sizeof (TRACE_IMAGE_INFO));
+  if (mImages == NULL) {
+    FreePool (Handles);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (Handles[Index], &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    Image            = &mImages[mImageCount++];
+    Image->Handle    = Handles[Index];
+    Image->ImageBase = (UINT64)(UINTN)LoadedImage->ImageBase;
+    Image->ImageSize = LoadedImage->ImageSize;
+
+    PdbFileName = PeCoffLoaderGetPdbPointer (LoadedImage->ImageBase);
+    if (PdbFileName != NULL) {
+      GetShortPdbFileName (PdbFileName, Image->Name);
+    } else {
+      AsciiSPrint (Image->Name, sizeof (Image->Name), "Image@0x%lx", Image->ImageBase);
+    }
+  }
+
+  FreePool (Handles);
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the name of the module an image or driver binding handle belongs to.
+
+  @param[in] Handle     The handle logged in the trace.
+
+  @return The module name, or NULL if the handle is not an image handle.
+**/
+CHAR8 *
+GetModuleNameByHandle (
+  IN UINT64  Handle
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding;
+  UINTN                        Index;
+
+  for (Index = 0; Index < mImageCount; Index++) {
+    if ((UINT64)(UINTN)mImages[Index].Handle == Handle) {
+      return mImages[Index].Name;
+    }
+  }
+
+  //
+  // Handles that are no longer valid are rejected by the handle database.
+  //
+  Status = gBS->HandleProtocol ((EFI_HANDLE)(UINTN)Handle, &gEfiDriverBindingProtocolGuid, (VOID **)&DriverBinding);
+  if (!EFI_ERROR (Status)) {
+    for (Index = 0; Index < mImageCount; Index++) {
+      if (mImages[Index].Handle == DriverBinding->ImageHandle) {
+        return mImages[Index].Name;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find the name of the module that contains an address.
+
+  @param[in] Address    The address logged in the trace.
+
+  @return The module name, or NULL if no loaded image contains Address.
+**/
+CHAR8 *
+GetModuleNameByAddress (
+  IN UINT64  Address
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mImageCount; Index++) {
+    if ((Address >= mImages[Index].ImageBase) &&
+        (Address - mImages[Index].ImageBase < mImages[Index].ImageSize))
+    {
+      return mImages[Index].Name;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get a readable name for the measurements logged without a string.
+
+  @param[in] ProgressId     The performance identifier of the entry.
+
+  @return The name, or NULL for other identifiers.
+**/
+CONST CHAR8 *
+GetProgressIdName (
+  IN UINT16  ProgressId
+  )
+{
+  switch (ProgressId) {
+    case MODULE_START_ID:
+    case MODULE_END_ID:
+      return "StartImage";
+    case MODULE_LOADIMAGE_START_ID:
+    case MODULE_LOADIMAGE_END_ID:
+      return "LoadImage";
+    case MODULE_DB_START_ID:
+    case MODULE_DB_END_ID:
+      return "DriverBinding.Start";
+    case MODULE_DB_SUPPORT_START_ID:
+    case MODULE_DB_SUPPORT_END_ID:
+      return "DriverBinding.Supported";
+    case MODULE_DB_STOP_START_ID:
+    case MODULE_DB_STOP_END_ID:
+      return "DriverBinding.Stop";
+    default:
+      return NULL;
+  }
+}
+
+/**
+  Append formatted text to the trace buffer, growing it as needed.
+
+  @param[in] Format     A Null-terminated ASCII format string.
+  @param[in] ...        The variable argument list.
+
+  @retval EFI_SUCCESS            The text is appended.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to grow the buffer.
+**/
+EFI_STATUS
+EFIAPI
+TraceAppend (
+  IN CONST CHAR8  *Format,
+  ...
+  )
+{
+  VA_LIST  Marker;
+  CHAR8    Line[TRACE_LINE_LENGTH];
+  UINTN    Length;
+  CHAR8    *NewBuffer;
+
+  VA_START (Marker, Format);
+  Length = AsciiVSPrint (Line, sizeof (Line), Format, Marker);
+  VA_END (Marker);
+
+  if (mTraceLength + Length + 1 > mTraceBufferSize) {
+    NewBuffer = ReallocatePool (mTraceBufferSize, mTraceBufferSize + TRACE_BUFFER_INCREMENT, mTraceBuffer);
+    if (NewBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mTraceBuffer      = NewBuffer;
+    mTraceBufferSize += TRACE_BUFFER_INCREMENT;
+  }
+
+  CopyMem (mTraceBuffer + mTraceLength, Line, Length + 1);
+  mTraceLength += Length;
+  return EFI_SUCCESS;
+}
+
+/**
+  Copy a name into a JSON string, replacing the characters that would need
+  escaping.
+
+  @param[in]  Name      The Null-terminated ASCII name.
+  @param[out] Buffer    The buffer receiving the JSON safe name.
+  @param[in]  Size      The size of Buffer in bytes.
+**/
+VOID
+CopyJsonName (
+  IN  CONST CHAR8  *Name,
+  OUT CHAR8        *Buffer,
+  IN  UINTN        Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; (Index < Size - 1) && (Name[Index] != 0); Index++) {
+    if ((Name[Index] == '"') || (Name[Index] == '\\') || (Name[Index] < ' ') || (Name[Index] > '~')) {
+      Buffer[Index] = '_';
+    } else {
+      Buffer[Index] = Name[Index];
+    }
+  }
+
+  Buffer[Index] = 0;
+}
+
+/**
+  Convert a performance counter value to nanoseconds.
+
+  @param[in] Table      The performance trace table.
+  @param[in] Ticker     The performance counter value.
+
+  @return The time in nanoseconds.
+**/
+UINT64
+TickerToNanoSecond (
+  IN PERFORMANCE_TRACE_TABLE  *Table,
+  IN UINT64                   Ticker
+  )
+{
+  UINT64  Seconds;
+  UINT64  Remainder;
+
+  if (Table->TimerStartValue > Table->TimerEndValue) {
+    Ticker = Table->TimerStartValue - Ticker;
+  }
+
+  Seconds = DivU64x64Remainder (Ticker, Table->Frequency, &Remainder);
+  return MultU64x32 (Seconds, 1000000000) +
+         DivU64x64Remainder (MultU64x32 (Remainder, 1000000000), Table->Frequency, NULL);
+}
+
+/**
+  Append one trace entry as a Chrome trace event.
+
+  @param[in] Table      The performance trace table.
+  @param[in] Cpu        The processor that logged the entry.
+  @param[in] Entry      The trace entry.
+  @param[in] First      TRUE if this is the first event of the trace.
+
+  @retval EFI_SUCCESS            The event is appended.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to grow the buffer.
+**/
+EFI_STATUS
+DumpTraceEntry (
+  IN PERFORMANCE_TRACE_TABLE  *Table,
+  IN UINTN                    Cpu,
+  IN PERFORMANCE_TRACE_ENTRY  *Entry,
+  IN BOOLEAN                  First
+  )
+{
+  CHAR8        Name[TRACE_LINE_LENGTH / 4];
+  CHAR8        RawName[PERFORMANCE_TRACE_NAME_LENGTH];
+  CONST CHAR8  *Category;
+  CONST CHAR8  *Label;
+  CHAR8        *Module;
+  UINT64       Time;
+
+  CopyMem (RawName, Entry->Name, sizeof (RawName));
+  RawName[sizeof (RawName) - 1] = 0;
+
+  Label = GetProgressIdName (Entry->ProgressId);
+  if ((Entry->ProgressId == PERF_TRACE_START_ID) || (Entry->ProgressId == PERF_TRACE_END_ID)) {
+    Category = "core";
+    Module   = GetModuleNameByAddress (Entry->Address);
+  } else if (Label != NULL) {
+    Category = "image";
+    Module   = GetModuleNameByHandle (Entry->Handle);
+  } else {
+    Category = "perf";
+    Module   = GetModuleNameByHandle (Entry->Handle);
+  }
+
+  if (RawName[0] != 0) {
+    CopyJsonName (RawName, Name, sizeof (Name));
+  } else if (Label != NULL) {
+    AsciiSPrint (Name, sizeof (Name), "%a %a", Label, (Module != NULL) ? Module : "");
+  } else {
+    AsciiSPrint (Name, sizeof (Name), "0x%x", Entry->ProgressId);
+  }
+
+  Time = TickerToNanoSecond (Table, Entry->Timestamp);
+  return TraceAppend (
+           "%a\n{\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"%c\",\"ts\":%ld.%03ld,\"pid\":1,\"tid\":%d,"
+           "\"args\":{\"id\":\"0x%x\",\"handle\":\"0x%lx\",\"address\":\"0x%lx\",\"guid\":\"%g\",\"module\":\"%a\"}}",
+           First ? "" : ",",
+           Name,
+           Category,
+           Entry->Phase,
+           DivU64x32 (Time, 1000),
+           (UINT64)ModU64x32 (Time, 1000),
+           (UINT32)Cpu,
+           Entry->ProgressId,
+           Entry->Handle,
+           Entry->Address,
+           &Entry->Guid,
+           (Module != NULL) ? Module : ""
+           );
+}
+
+/**
+  Convert the performance trace rings to a Chrome trace event JSON document in
+  the trace buffer.
+
+  @param[in] Table      The performance trace table.
+
+  @retval EFI_SUCCESS            The trace is converted.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory for the trace.
+**/
+EFI_STATUS
+DumpTraceTable (
+  IN PERFORMANCE_TRACE_TABLE  *Table
+  )
+{
+  EFI_STATUS               Status;
+  PERFORMANCE_TRACE_RING   *Ring;
+  PERFORMANCE_TRACE_ENTRY  Entry;
+  UINTN                    Cpu;
+  UINT32                   Head;
+  UINT32                   Index;
+  UINT32                   Mask;
+  UINTN                    Lost;
+  BOOLEAN                  First;
+
+  Status = TraceAppend ("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  First  = TRUE;
+  Lost   = 0;
+  Mask   = Table->EntryCount - 1;
+
+  for (Cpu = 0; (Cpu < Table->CpuCount) && !EFI_ERROR (Status); Cpu++) {
+    Ring = (PERFORMANCE_TRACE_RING *)(UINTN)Table->Ring[Cpu];
+    if (Ring == NULL) {
+      continue;
+    }
+
+    Status = TraceAppend (
+               "%a\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"CPU %d\"}}",
+               First ? "" : ",",
+               (UINT32)Cpu,
+               (UINT32)Cpu
+               );
+    First = FALSE;
+
+    //
+    // Events keep being logged while the rings are read, so take a snapshot of
+    // each entry and drop it if it was overwritten during the copy.
+    //
+    Head  = Ring->Head;
+    Index = (Head > Table->EntryCount) ? Head - Table->EntryCount : 0;
+    for ( ; (Index != Head) && !EFI_ERROR (Status); Index++) {
+      CopyMem (&Entry, &Ring->Entries[Index & Mask], sizeof (Entry));
+      MemoryFence ();
+      if ((Entry.Sequence != Index + 1) || (Ring->Entries[Index & Mask].Sequence != Index + 1) ||
+          (Entry.Timestamp == 0))
+      {
+        Lost++;
+        continue;
+      }
+
+      Status = DumpTraceEntry (Table, Cpu, &Entry, FALSE);
+    }
+
+    if (Head > Table->EntryCount) {
+      Lost += Head - Table->EntryCount;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = TraceAppend ("\n]}\n");
+  }
+
+  if (Lost != 0) {
+    Print (L"PerformanceTraceDump: %d events were overwritten or incomplete.\n", (UINT32)Lost);
+  }
+
+  return Status;
+}
+
+/**
+  Write the trace buffer to a file.
+
+  @param[in] FileName   The name of the file.
+
+  @retval EFI_SUCCESS    The file is written.
+  @retval EFI_NOT_FOUND  The shell protocol is not found.
+  @retval others         The file cannot be written.
+**/
+EFI_STATUS
+WriteTraceFile (
+  IN CHAR16  *FileName
+  )
+{
+  EFI_STATUS          Status;
+  EFI_SHELL_PROTOCOL  *ShellProtocol;
+  SHELL_FILE_HANDLE   Handle;
+  UINTN               BufferSize;
+
+  Status = gBS->LocateProtocol (&gEfiShellProtocolGuid, NULL, (VOID **)&ShellProtocol);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Replace any previous trace with the same name.
+  //
+  Status = ShellProtocol->OpenFileByName (FileName, &Handle, EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE);
+  if (!EFI_ERROR (Status)) {
+    ShellProtocol->DeleteFile (Handle);
+  }
+
+  Status = ShellProtocol->OpenFileByName (
+                            FileName,
+                            &Handle,
+                            EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE
+                            );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  BufferSize = mTraceLength;
+  Status     = ShellProtocol->WriteFile (Handle, &BufferSize, mTraceBuffer);
+  ShellProtocol->CloseFile (Handle);
+  return Status;
+}
+
+/**
+  Print the trace buffer to the console.
+
+  The buffer is printed in pieces that fit the print buffer of UefiLib.
+**/
+VOID
+PrintTrace (
+  VOID
+  )
+{
+  UINTN  Offset;
+  UINTN  Length;
+
+  for (Offset = 0; Offset < mTraceLength; Offset += Length) {
+    Length = MIN (mTraceLength - Offset, TRACE_PRINT_LENGTH);
+    Print (L"%.*a", Length, mTraceBuffer + Offset);
+  }
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this
+  function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                     Status;
+  PERFORMANCE_TRACE_TABLE        *Table;
+  EFI_SHELL_PARAMETERS_PROTOCOL  *ShellParameters;
+  CHAR16                         *FileName;
+
+  FileName = NULL;
+  Status   = gBS->HandleProtocol (ImageHandle, &gEfiShellParametersProtocolGuid, (VOID **)&ShellParameters);
+  if (!EFI_ERROR (Status)) {
+    if (ShellParameters->Argc > 2) {
+      Print (L"Usage: PerformanceTraceDump [FileName]\n");
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (ShellParameters->Argc == 2) {
+      FileName = ShellParameters->Argv[1];
+    }
+  }
+
+  Status = EfiGetSystemConfigurationTable (&gEdkiiPerformanceTraceGuid, (VOID **)&Table);
+  if (EFI_ERROR (Status) || (Table->Signature != PERFORMANCE_TRACE_SIGNATURE) ||
+      (Table->Revision != PERFORMANCE_TRACE_REVISION) || (Table->Frequency == 0))
+  {
+    Print (L"PerformanceTraceDump: No performance trace, set PcdPerformanceTraceRingSize to enable it.\n");
+    return EFI_NOT_FOUND;
+  }
+
+  Status = CollectImages ();
+  if (!EFI_ERROR (Status)) {
+    Status = DumpTraceTable (Table);
+  }
+
+  if (EFI_ERROR (Status)) {
+    Print (L"PerformanceTraceDump: %r\n", Status);
+  } else if (FileName != NULL) {
+    Status = WriteTraceFile (FileName);
+    if (EFI_ERROR (Status)) {
+      Print (L"PerformanceTraceDump: Cannot write %s - %r\n", FileName, Status);
+    }
+  } else {
+    PrintTrace ();
+  }
+
+  if (mTraceBuffer != NULL) {
+    FreePool (mTraceBuffer);
+  }
+
+  if (mImages != NULL) {
+    FreePool (mImages);
+  }
+
+  return Status;
+}
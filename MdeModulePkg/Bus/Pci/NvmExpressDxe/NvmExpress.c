@@ -555,42 +555,29 @@ UnregisterNvmeNamespace (
 }
 
 /**
-  Call back function when the timer event is signaled.
+  Submit the queued BlockIo2 subtasks of a controller to its asynchronous I/O
+  queues, until the queues are full.
 
-  @param[in]  Event     The Event this notify function registered to.
-  @param[in]  Context   Pointer to the context data registered to the
-                        Event.
+  The function must be called at TPL_NOTIFY.
+
+  @param[in] Private      The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
 
 **/
 VOID
-EFIAPI
-ProcessAsyncTaskList (
-  IN EFI_EVENT  Event,
-  IN VOID       *Context
+NvmeSubmitAsyncSubtasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
-  EFI_PCI_IO_PROTOCOL           *PciIo;
-  NVME_CQ                       *Cq;
-  UINT16                        QueueId;
-  UINT32                        Data;
-  LIST_ENTRY                    *Link;
-  LIST_ENTRY                    *NextLink;
-  NVME_PASS_THRU_ASYNC_REQ      *AsyncRequest;
-  NVME_BLKIO2_SUBTASK           *Subtask;
-  NVME_BLKIO2_REQUEST           *BlkIo2Request;
-  EFI_BLOCK_IO2_TOKEN           *Token;
-  BOOLEAN                       HasNewItem;
-  EFI_STATUS                    Status;
-
-  Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
-  PciIo      = Private->PciIo;
+  LIST_ENTRY           *Link;
+  LIST_ENTRY           *NextLink;
+  NVME_BLKIO2_SUBTASK  *Subtask;
+  NVME_BLKIO2_REQUEST  *BlkIo2Request;
+  EFI_BLOCK_IO2_TOKEN  *Token;
+  EFI_STATUS           Status;
 
   //
-  // Submit asynchronous subtasks to the NVMe Submission Queue
+  // Submit asynchronous subtasks to the NVMe Submission Queues
   //
   for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
        !IsNull (&Private->UnsubmittedSubtasks, Link);
@@ -662,87 +649,217 @@ ProcessAsyncTaskList (
       }
     }
   }
+}
 
-  while (Cq->Pt != Private->Pt[QueueId]) {
-    ASSERT (Cq->Sqid == QueueId);
+/**
+  Call back function when the timer event is signaled.
 
-    HasNewItem = TRUE;
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
 
-    //
-    // Find the command with given Command Id.
-    //
-    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
-         !IsNull (&Private->AsyncPassThruQueue, Link);
-         Link = NextLink)
-    {
-      NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
-      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
-      if (AsyncRequest->CommandId == Cq->Cid) {
-        //
-        // Copy the Respose Queue entry for this command to the callers
-        // response buffer.
-        //
-        CopyMem (
-          AsyncRequest->Packet->NvmeCompletion,
-          Cq,
-          sizeof (EFI_NVM_EXPRESS_COMPLETION)
-          );
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  NVME_CQ                       *Cq;
+  UINT16                        QueueId;
+  UINT32                        Data;
+  LIST_ENTRY                    *Link;
+  LIST_ENTRY                    *NextLink;
+  NVME_PASS_THRU_ASYNC_REQ      *AsyncRequest;
+  BOOLEAN                       HasNewItem;
 
-        //
-        // Free the resources allocated before cmd submission
-        //
-        if (AsyncRequest->MapData != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapData);
-        }
+  Private = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
+  PciIo   = Private->PciIo;
 
-        if (AsyncRequest->MapMeta != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
-        }
+  //
+  // Reap the completions of all asynchronous I/O queues first, so that the
+  // submission below finds the freed submission queue slots.
+  //
+  for (QueueId = NVME_ASYNC_QUEUE_BASE;
+       QueueId < NVME_ASYNC_QUEUE_BASE + Private->AsyncQueueCount;
+       QueueId++)
+  {
+    Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    HasNewItem = FALSE;
+
+    while (Cq->Pt != Private->Pt[QueueId]) {
+      ASSERT (Cq->Sqid == QueueId);
 
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
+      HasNewItem = TRUE;
+
+      //
+      // Find the command with given Command Id.
+      //
+      for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+           !IsNull (&Private->AsyncPassThruQueue, Link);
+           Link = NextLink)
+      {
+        NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
+        AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+        if ((AsyncRequest->QueueId == QueueId) &&
+            (AsyncRequest->CommandId == Cq->Cid))
+        {
+          //
+          // Copy the Respose Queue entry for this command to the callers
+          // response buffer.
+          //
+          CopyMem (
+            AsyncRequest->Packet->NvmeCompletion,
+            Cq,
+            sizeof (EFI_NVM_EXPRESS_COMPLETION)
+            );
+
+          //
+          // Free the resources allocated before cmd submission
+          //
+          if (AsyncRequest->MapData != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapData);
+          }
+
+          if (AsyncRequest->MapMeta != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
+          }
+
+          NvmeFreePrpList (
+            Private,
+            AsyncRequest->PrpListHost,
+            AsyncRequest->PrpListNo,
+            AsyncRequest->MapPrpList
+            );
+
+          RemoveEntryList (Link);
+          gBS->SignalEvent (AsyncRequest->CallerEvent);
+          FreePool (AsyncRequest);
+
+          //
+          // Update submission queue head.
+          //
+          Private->AsyncSqHead[QueueId] = Cq->Sqhd;
+          break;
         }
+      }
+
+      Private->CqHdbl[QueueId].Cqh++;
+      if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
+        Private->CqHdbl[QueueId].Cqh = 0;
+        Private->Pt[QueueId]        ^= 1;
+      }
+
+      Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    }
 
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
+    if (HasNewItem) {
+      Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
+      PciIo->Mem.Write (
                    PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
+                   EfiPciIoWidthUint32,
+                   NVME_BAR,
+                   NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
+                   1,
+                   &Data
                    );
-        }
+    }
+  }
 
-        RemoveEntryList (Link);
-        gBS->SignalEvent (AsyncRequest->CallerEvent);
-        FreePool (AsyncRequest);
+  NvmeSubmitAsyncSubtasks (Private);
+}
 
-        //
-        // Update submission queue head.
-        //
-        Private->AsyncSqHead = Cq->Sqhd;
-        break;
-      }
-    }
+/**
+  Allocate and map the pool of PRP lists of a controller.
 
-    Private->CqHdbl[QueueId].Cqh++;
-    if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
-      Private->CqHdbl[QueueId].Cqh = 0;
-      Private->Pt[QueueId]        ^= 1;
+  Failure is not fatal: without the pool, a PRP list is allocated and mapped
+  for every command that needs one.
+
+  @param[in,out] Private  The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
+
+**/
+STATIC
+VOID
+NvmeCreatePrpListPool (
+  IN OUT NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  EFI_STATUS            Status;
+  VOID                  *Pool;
+  UINTN                 Bytes;
+  EFI_PHYSICAL_ADDRESS  MappedAddr;
+
+  PciIo  = Private->PciIo;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    NVME_PRP_LIST_POOL_SIZE,
+                    &Pool,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "NvmeCreatePrpListPool: allocation failed (%r)\n", Status));
+    return;
+  }
+
+  Bytes  = EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_SIZE);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Pool,
+                    &Bytes,
+                    &MappedAddr,
+                    &Private->PrpListPoolMapping
+                    );
+  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_SIZE))) {
+    DEBUG ((DEBUG_WARN, "NvmeCreatePrpListPool: mapping failed (%r)\n", Status));
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Private->PrpListPoolMapping);
     }
 
-    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    Private->PrpListPoolMapping = NULL;
+    PciIo->FreeBuffer (PciIo, NVME_PRP_LIST_POOL_SIZE, Pool);
+    return;
   }
 
-  if (HasNewItem) {
-    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
-    PciIo->Mem.Write (
-                 PciIo,
-                 EfiPciIoWidthUint32,
-                 NVME_BAR,
-                 NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
-                 1,
-                 &Data
-                 );
+  Private->PrpListPool        = Pool;
+  Private->PrpListPoolPciAddr = (UINT8 *)(UINTN)MappedAddr;
+  Private->PrpListPoolFree    = MAX_UINT64 >> (64 - NVME_PRP_LIST_POOL_SIZE);
+}
+
+/**
+  Unmap and free the pool of PRP lists of a controller, if any.
+
+  @param[in,out] Private  The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
+
+**/
+STATIC
+VOID
+NvmeDestroyPrpListPool (
+  IN OUT NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  if (Private->PrpListPool == NULL) {
+    return;
   }
+
+  Private->PciIo->Unmap (Private->PciIo, Private->PrpListPoolMapping);
+  Private->PciIo->FreeBuffer (
+                    Private->PciIo,
+                    NVME_PRP_LIST_POOL_SIZE,
+                    Private->PrpListPool
+                    );
+  Private->PrpListPool        = NULL;
+  Private->PrpListPoolPciAddr = NULL;
+  Private->PrpListPoolMapping = NULL;
+  Private->PrpListPoolFree    = 0;
 }
 
 /**
@@ -1029,21 +1146,18 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
-    // 1st 4kB boundary is the start of the admin submission queue.
-    // 2nd 4kB boundary is the start of the admin completion queue.
-    // 3rd 4kB boundary is the start of I/O submission queue #1.
-    // 4th 4kB boundary is the start of I/O completion queue #1.
-    // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // NVME_QUEUE_BUFFER_PAGES x 4kB aligned buffers will be carved out of this
+    // buffer, for the admin queues, the synchronous I/O queues and the
+    // asynchronous I/O queues. See NVME_CONTROLLER_PRIVATE_DATA.Buffer.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate NVME_QUEUE_BUFFER_PAGES pages of memory, then map it for bus
+    // master read and write.
     //
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      NVME_QUEUE_BUFFER_PAGES,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1051,7 +1165,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (NVME_QUEUE_BUFFER_PAGES);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1061,7 +1175,7 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_QUEUE_BUFFER_PAGES))) {
       goto Exit;
     }
 
@@ -1082,6 +1196,8 @@ NvmExpressDriverBindingStart (
     InitializeListHead (&Private->AsyncPassThruQueue);
     InitializeListHead (&Private->UnsubmittedSubtasks);
 
+    NvmeCreatePrpListPool (Private);
+
     Status = NvmeControllerInit (Private);
     if (EFI_ERROR (Status)) {
       goto Exit;
@@ -1171,7 +1287,11 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, NVME_QUEUE_BUFFER_PAGES, Private->Buffer);
+  }
+
+  if ((Private != NULL) && (Private->PciIo != NULL)) {
+    NvmeDestroyPrpListPool (Private);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1293,9 +1413,11 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, NVME_QUEUE_BUFFER_PAGES, Private->Buffer);
       }
 
+      NvmeDestroyPrpListPool (Private);
+
       FreePool (Private->ControllerData);
       FreePool (Private);
     }
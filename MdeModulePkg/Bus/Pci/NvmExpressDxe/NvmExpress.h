@@ -69,16 +69,44 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 //
 // Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// The asynchronous I/O submission queue size is 16kB in total.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_ASYNC_CSQ_SIZE   255
+#define NVME_ASYNC_CSQ_PAGES  4
 //
 // Number of asynchronous I/O completion queue entries, which is 0-based.
 // The asynchronous I/O completion queue size is 4kB in total.
 //
-#define NVME_ASYNC_CCQ_SIZE  255
+#define NVME_ASYNC_CCQ_SIZE   255
+#define NVME_ASYNC_CCQ_PAGES  1
 
-#define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
+//
+// Maximum number of asynchronous I/O queue pairs. Non-blocking requests are
+// spread over the asynchronous I/O queue pairs granted by the controller.
+//
+#define NVME_MAX_ASYNC_QUEUES  4
+
+#define NVME_ASYNC_QUEUE_BASE  2                        // Queue ID of the first asynchronous I/O queue pair
+#define NVME_MAX_QUEUES        (NVME_ASYNC_QUEUE_BASE + NVME_MAX_ASYNC_QUEUES) // Number of queues supported by the driver
+
+//
+// Number of pages carved into the admin, the synchronous I/O and the
+// asynchronous I/O queues.
+//
+#define NVME_QUEUE_BUFFER_PAGES  \
+  (4 + NVME_MAX_ASYNC_QUEUES * (NVME_ASYNC_CSQ_PAGES + NVME_ASYNC_CCQ_PAGES))
+
+//
+// Number of single-page PRP lists pre-allocated and mapped per controller, so
+// that transfers spanning up to 513 pages do not allocate and map a PRP list
+// for every command. At most 64 (one bit each in PrpListPoolFree).
+//
+#define NVME_PRP_LIST_POOL_SIZE  64
+
+//
+// Set Features - Number of Queues feature identifier
+//
+#define NVME_FEATURE_NUMBER_OF_QUEUES  0x07
 
 //
 // FormatNVM Admin Command LBA Format (LBAF) Mask
@@ -145,13 +173,14 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // NVME_QUEUE_BUFFER_PAGES x 4kB will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // Then, for each asynchronous I/O queue pair #2 to #(1 + NVME_MAX_ASYNC_QUEUES),
+  // NVME_ASYNC_CSQ_PAGES x 4kB of submission queue followed by
+  // NVME_ASYNC_CCQ_PAGES x 4kB of completion queue.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
@@ -169,7 +198,14 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_SQTDBL    SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
-  UINT16         AsyncSqHead;
+  UINT16         AsyncSqHead[NVME_MAX_QUEUES];
+
+  //
+  // Number of asynchronous I/O queue pairs in use, and the queue ID that the
+  // next non-blocking request is submitted to, unless that queue is full.
+  //
+  UINT16         AsyncQueueCount;
+  UINT16         NextAsyncQueue;
 
   //
   // Flag to indicate internal IO queue creation.
@@ -186,6 +222,15 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
 
   VOID           *Mapping;
 
+  //
+  // Pool of NVME_PRP_LIST_POOL_SIZE single-page PRP lists, and the bitmap of
+  // the free ones. PrpListPool is NULL if the pool could not be set up.
+  //
+  UINT8          *PrpListPool;
+  UINT8          *PrpListPoolPciAddr;
+  VOID           *PrpListPoolMapping;
+  UINT64         PrpListPoolFree;
+
   //
   // For Non-blocking operations.
   //
@@ -329,6 +374,7 @@ typedef struct {
   LIST_ENTRY                                  Link;
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
+  UINT16                                      QueueId;
   UINT16                                      CommandId;
   VOID                                        *MapPrpList;
   UINTN                                       PrpListNo;
@@ -759,6 +805,42 @@ NvmeDumpStatus (
   IN NVME_CQ  *Cq
   );
 
+/**
+  Release a PRP list built for an NVMe command, either back to the PRP list
+  pool of the controller, or to the PCI I/O protocol.
+
+  @param[in] Private      The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
+  @param[in] PrpListHost  The host base address of the PRP lists. NULL if the
+                          command did not need a PRP list.
+  @param[in] PrpListNo    The number of PRP lists.
+  @param[in] Mapping      The mapping of the PRP lists. NULL if the PRP list
+                          was taken from the pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  );
+
+/**
+  Submit the queued BlockIo2 subtasks of a controller to its asynchronous I/O
+  queues, until the queues are full.
+
+  The function must be called at TPL_NOTIFY.
+
+  @param[in] Private      The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
+
+**/
+VOID
+NvmeSubmitAsyncSubtasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
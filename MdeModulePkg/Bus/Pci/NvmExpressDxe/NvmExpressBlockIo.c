@@ -813,6 +813,14 @@ NvmeAsyncRead (
     }
   }
 
+  //
+  // Submit the subtasks to the asynchronous I/O queues right away, rather than
+  // at the next tick of the asynchronous I/O timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  NvmeSubmitAsyncSubtasks (Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -941,6 +949,14 @@ NvmeAsyncWrite (
     }
   }
 
+  //
+  // Submit the subtasks to the asynchronous I/O queues right away, rather than
+  // at the next tick of the asynchronous I/O timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  NvmeSubmitAsyncSubtasks (Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -314,6 +314,110 @@ EXIT:
   return NULL;
 }
 
+STATIC_ASSERT (
+  NVME_PRP_LIST_POOL_SIZE <= 64,
+  "PrpListPoolFree has one bit per pooled PRP list"
+  );
+
+/**
+  Take a PRP list from the pool of the controller, and fill it in for a data
+  transfer which spans more than 2 memory pages.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PhysicalAddr        The physical base address of data buffer.
+  @param[in]     Pages               The number of pages to be transfered.
+  @param[out]    PrpListHost         The host base address of the PRP list.
+
+  @retval NULL   The transfer needs more than one PRP list, or the pool is
+                 exhausted. The caller should fall back to NvmeCreatePrpList().
+  @return        The pointer to the PRP list.
+
+**/
+STATIC
+VOID *
+NvmeAllocatePrpListFromPool (
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost
+  )
+{
+  UINT64   *PrpList;
+  UINTN    Slot;
+  UINTN    PrpEntryIndex;
+  EFI_TPL  OldTpl;
+
+  if ((Private->PrpListPool == NULL) || (Pages > EFI_PAGE_SIZE / sizeof (UINT64))) {
+    return NULL;
+  }
+
+  //
+  // The pool is shared by blocking requests and by the asynchronous
+  // submission from the TPL_NOTIFY timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Private->PrpListPoolFree == 0) {
+    gBS->RestoreTPL (OldTpl);
+    return NULL;
+  }
+
+  Slot                      = (UINTN)LowBitSet64 (Private->PrpListPoolFree);
+  Private->PrpListPoolFree &= ~LShiftU64 (1, Slot);
+  gBS->RestoreTPL (OldTpl);
+
+  PrpList = (UINT64 *)(Private->PrpListPool + EFI_PAGES_TO_SIZE (Slot));
+  for (PrpEntryIndex = 0; PrpEntryIndex < Pages; ++PrpEntryIndex) {
+    PrpList[PrpEntryIndex] = PhysicalAddr;
+    PhysicalAddr          += EFI_PAGE_SIZE;
+  }
+
+  *PrpListHost = PrpList;
+  return Private->PrpListPoolPciAddr + EFI_PAGES_TO_SIZE (Slot);
+}
+
+/**
+  Release a PRP list built for an NVMe command, either back to the PRP list
+  pool of the controller, or to the PCI I/O protocol.
+
+  @param[in] Private      The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                          structure.
+  @param[in] PrpListHost  The host base address of the PRP lists. NULL if the
+                          command did not need a PRP list.
+  @param[in] PrpListNo    The number of PRP lists.
+  @param[in] Mapping      The mapping of the PRP lists. NULL if the PRP list
+                          was taken from the pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  )
+{
+  UINTN    Slot;
+  EFI_TPL  OldTpl;
+
+  if (PrpListHost == NULL) {
+    return;
+  }
+
+  if (Mapping == NULL) {
+    ASSERT ((UINT8 *)PrpListHost >= Private->PrpListPool);
+    Slot = ((UINTN)PrpListHost - (UINTN)Private->PrpListPool) >> EFI_PAGE_SHIFT;
+    ASSERT (Slot < NVME_PRP_LIST_POOL_SIZE);
+
+    OldTpl                    = gBS->RaiseTPL (TPL_NOTIFY);
+    Private->PrpListPoolFree |= LShiftU64 (1, Slot);
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Private->PciIo->Unmap (Private->PciIo, Mapping);
+  Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+}
+
 /**
   Aborts the asynchronous PassThru requests.
 
@@ -384,17 +488,12 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
-    if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
-    }
+    NvmeFreePrpList (
+      Private,
+      AsyncRequest->PrpListHost,
+      AsyncRequest->PrpListNo,
+      AsyncRequest->MapPrpList
+      );
 
     RemoveEntryList (Link);
     gBS->SignalEvent (AsyncRequest->CallerEvent);
@@ -463,6 +562,7 @@ NvmExpressPassThru (
   volatile NVME_CQ               *Cq;
   UINT16                         QueueId;
   UINT16                         QueueSize;
+  UINT16                         Index;
   UINT32                         Bytes;
   UINT16                         Offset;
   EFI_EVENT                      TimerEvent;
@@ -561,14 +661,29 @@ NvmExpressPassThru (
     if (Event == NULL) {
       QueueId = 1;
     } else {
-      QueueId = 2;
-
       //
-      // Submission queue full check.
+      // Pick the asynchronous I/O queues in round-robin order, skipping the
+      // full ones, so that consecutive non-blocking requests are spread over
+      // all asynchronous I/O queue pairs.
       //
-      if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize ==
-          Private->AsyncSqHead)
-      {
+      QueueId = 0;
+      for (Index = 0; Index < Private->AsyncQueueCount; Index++) {
+        QueueId = Private->NextAsyncQueue++;
+        if (Private->NextAsyncQueue >= NVME_ASYNC_QUEUE_BASE + Private->AsyncQueueCount) {
+          Private->NextAsyncQueue = NVME_ASYNC_QUEUE_BASE;
+        }
+
+        //
+        // Submission queue full check.
+        //
+        if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize !=
+            Private->AsyncSqHead[QueueId])
+        {
+          break;
+        }
+      }
+
+      if (Index == Private->AsyncQueueCount) {
         return EFI_NOT_READY;
       }
     }
@@ -680,7 +795,13 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeAllocatePrpListFromPool (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost);
+    if (Prp != NULL) {
+      PrpListNo = 1;
+    } else {
+      Prp = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    }
+
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -760,6 +881,7 @@ NvmExpressPassThru (
 
     AsyncRequest->Signature   = NVME_PASS_THRU_ASYNC_REQ_SIG;
     AsyncRequest->Packet      = Packet;
+    AsyncRequest->QueueId     = QueueId;
     AsyncRequest->CommandId   = Sq->Cid;
     AsyncRequest->CallerEvent = Event;
     AsyncRequest->MapData     = MapData;
@@ -907,17 +1029,15 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
+  if (Prp != NULL) {
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo, MapPrpList);
+  } else if (MapPrpList != NULL) {
     PciIo->Unmap (
              PciIo,
              MapPrpList
              );
   }
 
-  if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
-  }
-
   if (TimerEvent != NULL) {
     gBS->CloseEvent (TimerEvent);
   }
@@ -549,7 +549,7 @@ NvmeCreateDeviceInstance (
   Private->CqHdbl[0].Cqh = 0;
   Private->CqHdbl[1].Cqh = 0;
   Private->CqHdbl[2].Cqh = 0;
-  Private->AsyncSqHead   = 0;
+  ZeroMem (Private->AsyncSqHead, sizeof (Private->AsyncSqHead));
 
   Private->ControllerData = (NVME_ADMIN_CONTROLLER_DATA *)AllocateZeroPool (sizeof (NVME_ADMIN_CONTROLLER_DATA));
 
@@ -62,6 +62,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/PerformanceTrace.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -113,6 +114,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 #define DEPEX_STACK_SIZE_INCREMENT  0x1000
 
+///
+/// Log a DXE core event to the performance trace rings of DxeCorePerformanceLib.
+/// Identifier is PERF_TRACE_START_ID or PERF_TRACE_END_ID.
+///
+#define CORE_PERF_TRACE(Identifier, Handle, Guid, Name, Address)                              \
+  do {                                                                                        \
+    if ((PcdGet32 (PcdPerformanceTraceRingSize) != 0) &&                                      \
+        LogPerformanceMeasurementEnabled (PERF_GENERAL_TYPE))                                 \
+    {                                                                                         \
+      LogPerformanceMeasurement (Handle, Guid, Name, (UINT64)(UINTN)(Address), Identifier); \
+    }                                                                                         \
+  } while (FALSE)
+
 typedef struct {
   EFI_GUID     *ProtocolGuid;
   VOID         **Protocol;
@@ -153,8 +153,9 @@ CoreDispatchEventNotifies (
   IN EFI_TPL  Priority
   )
 {
-  IEVENT      *Event;
-  LIST_ENTRY  *Head;
+  IEVENT            *Event;
+  LIST_ENTRY        *Head;
+  EFI_EVENT_NOTIFY  NotifyFunction;
 
   CoreAcquireEventLock ();
   ASSERT (gEventQueueLock.OwnerTpl == Priority);
@@ -183,7 +184,14 @@ CoreDispatchEventNotifies (
     // Notify this event
     //
     ASSERT (Event->NotifyFunction != NULL);
-    Event->NotifyFunction (Event, Event->NotifyContext);
+    NotifyFunction = Event->NotifyFunction;
+    CORE_PERF_TRACE (PERF_TRACE_START_ID, Event, &Event->EventGroup, "EventNotify", NotifyFunction);
+    NotifyFunction (Event, Event->NotifyContext);
+
+    //
+    // The notification function may have closed the event.
+    //
+    CORE_PERF_TRACE (PERF_TRACE_END_ID, Event, NULL, "EventNotify", NotifyFunction);
 
     //
     // Check for next pending event
@@ -437,6 +445,16 @@ CoreCreateEventInternal (
     NotifyContext  = NULL;
   }
 
+  //
+  // Make sure the timer heap has room for the new timer
+  //
+  if ((Type & EVT_TIMER) != 0) {
+    Status = CoreReserveEventTimer ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   //
   // Allocate and initialize a new event structure.
   //
@@ -447,6 +465,10 @@ CoreCreateEventInternal (
   }
 
   if (IEvent == NULL) {
+    if ((Type & EVT_TIMER) != 0) {
+      CoreReleaseEventTimer ();
+    }
+
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -719,6 +741,7 @@ CoreCloseEvent (
   //
   if ((Event->Type & EVT_TIMER) != 0) {
     CoreSetTimer (Event, TimerCancel, 0);
+    CoreReleaseEventTimer ();
   }
 
   CoreAcquireEventLock ();
@@ -30,9 +30,17 @@ extern  UINTN  gEventPending;
 /// Timer event information
 ///
 typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+  ///
+  /// Slot of the event in the timer heap, or 0 if the timer is not queued
+  ///
+  UINTN     HeapIndex;
+  ///
+  /// Order of insertion, used to fire timers with the same trigger time in
+  /// the order they were set
+  ///
+  UINT64    Sequence;
+  UINT64    TriggerTime;
+  UINT64    Period;
 } TIMER_EVENT_INFO;
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
@@ -85,4 +93,27 @@ CoreInitializeTimer (
   VOID
   );
 
+/**
+  Reserves a slot in the timer heap for a new timer event, growing the heap
+  if needed. The heap always has room for every timer event, so that timers
+  can be set at any TPL without allocating memory.
+
+  @retval EFI_SUCCESS            A slot was reserved.
+  @retval EFI_OUT_OF_RESOURCES   The heap could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveEventTimer (
+  VOID
+  );
+
+/**
+  Releases the timer heap slot reserved for a timer event that is closed.
+
+**/
+VOID
+CoreReleaseEventTimer (
+  VOID
+  );
+
 #endif
@@ -13,9 +13,26 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+EFI_LOCK   mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT  mEfiCheckTimerEvent = NULL;
+
+//
+// The queued timers are kept in a binary min-heap ordered by trigger time
+// and insertion order. The heap is 1-based: slot 0 is unused so that
+// TIMER_EVENT_INFO.HeapIndex can be 0 for a timer that is not queued.
+// The heap is grown when timer events are created, so it always has a
+// slot for every timer event and SetTimer never allocates memory.
+// CoreTimerTick peeks at the head of the heap from the timer interrupt
+// without holding mEfiTimerLock, so a slot is always filled before the count
+// covers it, and the count is always lowered before a slot is cleared.
+//
+#define TIMER_HEAP_INITIAL_SIZE  32
+
+IEVENT          **mEfiTimerHeap     = NULL;
+volatile UINTN  mEfiTimerHeapCount  = 0;
+UINTN           mEfiTimerHeapSize   = 0;
+UINTN           mEfiTimerEventCount = 0;
+UINT64          mEfiTimerSequence   = 0;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
@@ -24,6 +41,104 @@ UINT64    mEfiSystemTime     = 0;
 // Timer functions
 //
 
+/**
+  Checks whether a timer event must fire before another one.
+
+  @param  Event1                 The first timer event
+  @param  Event2                 The second timer event
+
+  @retval TRUE                   Event1 fires before Event2
+  @retval FALSE                  Event2 fires before Event1
+
+**/
+STATIC
+BOOLEAN
+CoreTimerIsBefore (
+  IN IEVENT  *Event1,
+  IN IEVENT  *Event2
+  )
+{
+  if (Event1->Timer.TriggerTime != Event2->Timer.TriggerTime) {
+    return (BOOLEAN)(Event1->Timer.TriggerTime < Event2->Timer.TriggerTime);
+  }
+
+  return (BOOLEAN)(Event1->Timer.Sequence < Event2->Timer.Sequence);
+}
+
+/**
+  Stores a timer event in a slot of the timer heap.
+
+  @param  Index                  The slot of the heap
+  @param  Event                  The timer event
+
+**/
+STATIC
+VOID
+CoreTimerHeapSet (
+  IN UINTN   Index,
+  IN IEVENT  *Event
+  )
+{
+  mEfiTimerHeap[Index]   = Event;
+  Event->Timer.HeapIndex = Index;
+}
+
+/**
+  Moves the timer event in a slot of the timer heap up to its place.
+
+  @param  Index                  The slot of the heap
+
+**/
+STATIC
+VOID
+CoreTimerHeapSiftUp (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+
+  Event = mEfiTimerHeap[Index];
+  while ((Index > 1) && CoreTimerIsBefore (Event, mEfiTimerHeap[Index / 2])) {
+    CoreTimerHeapSet (Index, mEfiTimerHeap[Index / 2]);
+    Index = Index / 2;
+  }
+
+  CoreTimerHeapSet (Index, Event);
+}
+
+/**
+  Moves the timer event in a slot of the timer heap down to its place.
+
+  @param  Index                  The slot of the heap
+
+**/
+STATIC
+VOID
+CoreTimerHeapSiftDown (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+  UINTN   Child;
+
+  Event = mEfiTimerHeap[Index];
+  while (Index * 2 <= mEfiTimerHeapCount) {
+    Child = Index * 2;
+    if ((Child < mEfiTimerHeapCount) && CoreTimerIsBefore (mEfiTimerHeap[Child + 1], mEfiTimerHeap[Child])) {
+      Child++;
+    }
+
+    if (!CoreTimerIsBefore (mEfiTimerHeap[Child], Event)) {
+      break;
+    }
+
+    CoreTimerHeapSet (Index, mEfiTimerHeap[Child]);
+    Index = Child;
+  }
+
+  CoreTimerHeapSet (Index, Event);
+}
+
 /**
   Inserts the timer event.
 
@@ -36,29 +151,133 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
-
   ASSERT_LOCKED (&mEfiTimerLock);
+  ASSERT (Event->Timer.HeapIndex == 0);
+  ASSERT (mEfiTimerHeapCount < mEfiTimerHeapSize);
 
   //
-  // Get the timer's trigger time
+  // Timers with the same trigger time fire in the order they were inserted
   //
-  TriggerTime = Event->Timer.TriggerTime;
+  Event->Timer.Sequence = mEfiTimerSequence++;
+
+  CoreTimerHeapSet (mEfiTimerHeapCount + 1, Event);
+  MemoryFence ();
+  mEfiTimerHeapCount++;
+  CoreTimerHeapSiftUp (mEfiTimerHeapCount);
+}
+
+/**
+  Removes the timer event from the timer heap.
+
+  @param  Event                  Points to the internal structure of a queued
+                                 timer event
+
+**/
+STATIC
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  UINTN   Index;
+  IEVENT  *Last;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  Index                  = Event->Timer.HeapIndex;
+  Event->Timer.HeapIndex = 0;
+  ASSERT ((Index != 0) && (Index <= mEfiTimerHeapCount));
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Move the last timer of the heap to the free slot
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  Last = mEfiTimerHeap[mEfiTimerHeapCount];
+  mEfiTimerHeapCount--;
+  MemoryFence ();
+  mEfiTimerHeap[mEfiTimerHeapCount + 1] = NULL;
+  if (Index <= mEfiTimerHeapCount) {
+    CoreTimerHeapSet (Index, Last);
+    CoreTimerHeapSiftUp (Index);
+    CoreTimerHeapSiftDown (Last->Timer.HeapIndex);
+  }
+}
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
+/**
+  Reserves a slot in the timer heap for a new timer event, growing the heap
+  if needed. The heap always has room for every timer event, so that timers
+  can be set at any TPL without allocating memory.
+
+  @retval EFI_SUCCESS            A slot was reserved.
+  @retval EFI_OUT_OF_RESOURCES   The heap could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveEventTimer (
+  VOID
+  )
+{
+  IEVENT  **NewHeap;
+  IEVENT  **OldHeap;
+  UINTN   NewSize;
+
+  while (TRUE) {
+    CoreAcquireLock (&mEfiTimerLock);
+    if (mEfiTimerEventCount < mEfiTimerHeapSize) {
+      mEfiTimerEventCount++;
+      CoreReleaseLock (&mEfiTimerLock);
+      return EFI_SUCCESS;
+    }
+
+    NewSize = MAX (mEfiTimerHeapSize * 2, TIMER_HEAP_INITIAL_SIZE);
+    CoreReleaseLock (&mEfiTimerLock);
+
+    //
+    // Memory can't be allocated with the timer lock held
+    //
+    NewHeap = AllocateZeroPool ((NewSize + 1) * sizeof (IEVENT *));
+    if (NewHeap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CoreAcquireLock (&mEfiTimerLock);
+    if (NewSize > mEfiTimerHeapSize) {
+      if (mEfiTimerHeap != NULL) {
+        CopyMem (NewHeap, mEfiTimerHeap, (mEfiTimerHeapCount + 1) * sizeof (IEVENT *));
+      }
+
+      MemoryFence ();
+
+      OldHeap           = mEfiTimerHeap;
+      mEfiTimerHeap     = NewHeap;
+      mEfiTimerHeapSize = NewSize;
+    } else {
+      //
+      // The heap was grown by a notification function in the meantime
+      //
+      OldHeap = NewHeap;
+    }
+
+    CoreReleaseLock (&mEfiTimerLock);
+
+    if (OldHeap != NULL) {
+      FreePool (OldHeap);
     }
   }
+}
 
-  InsertTailList (Link, &Event->Timer.Link);
+/**
+  Releases the timer heap slot reserved for a timer event that is closed.
+
+**/
+VOID
+CoreReleaseEventTimer (
+  VOID
+  )
+{
+  CoreAcquireLock (&mEfiTimerLock);
+  ASSERT (mEfiTimerEventCount > mEfiTimerHeapCount);
+  mEfiTimerEventCount--;
+  CoreReleaseLock (&mEfiTimerLock);
 }
 
 /**
@@ -82,7 +301,7 @@ CoreCurrentSystemTime (
 }
 
 /**
-  Checks the sorted timer list against the current system time.
+  Checks the timer heap against the current system time.
   Signals any expired event timer.
 
   @param  CheckEvent             Not used
@@ -105,8 +324,9 @@ CoreCheckTimers (
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (mEfiTimerHeapCount != 0) {
+    Event = mEfiTimerHeap[1];
+    ASSERT (Event->Signature == EVENT_SIGNATURE);
 
     //
     // If this timer is not expired, then we're done
@@ -118,9 +338,7 @@ CoreCheckTimers (
     //
     // Remove this timer from the timer queue
     //
-
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
 
     //
     // Signal it
@@ -202,13 +420,13 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the head of the heap is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  if (mEfiTimerHeapCount != 0) {
+    Event = mEfiTimerHeap[1];
 
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
+    if ((Event != NULL) && (Event->Timer.TriggerTime <= mEfiSystemTime)) {
       CoreSignalEvent (mEfiCheckTimerEvent);
     }
   }
@@ -260,9 +478,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (Event->Timer.HeapIndex != 0) {
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -10,12 +10,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// Number of buckets in the protocol GUID hash table, must be a power of 2
+//
+#define PROTOCOL_HASH_TABLE_SIZE  128
+
+//
+// mProtocolDatabase     - A list of all protocols in the system, in creation order
+// mProtocolHashTable    - The protocols in mProtocolDatabase, hashed by GUID
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
 LIST_ENTRY          mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY          mProtocolHashTable[PROTOCOL_HASH_TABLE_SIZE];
 LIST_ENTRY          gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK            gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64              gHandleDatabaseKey    = 0;
@@ -90,6 +97,12 @@ CoreInitializeHandleServices (
   VOID
   )
 {
+  UINTN  Index;
+
+  for (Index = 0; Index < PROTOCOL_HASH_TABLE_SIZE; Index++) {
+    InitializeListHead (&mProtocolHashTable[Index]);
+  }
+
   gOrderedHandleList = OrderedCollectionInit (PointerCompare, PointerCompare);
 
   if (gOrderedHandleList == NULL) {
@@ -130,6 +143,32 @@ CoreValidateHandle (
   return EFI_INVALID_PARAMETER;
 }
 
+/**
+  Computes the mProtocolHashTable bucket of a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The index of the hash bucket.
+
+**/
+STATIC
+UINTN
+ProtocolHashIndex (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)Protocol) ^
+         ReadUnaligned32 ((CONST UINT32 *)Protocol + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Protocol + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (PROTOCOL_HASH_TABLE_SIZE - 1);
+}
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -146,6 +185,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY      *Bucket;
   LIST_ENTRY      *Link;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
@@ -153,21 +193,28 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the GUID for the matching entry
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = &mProtocolHashTable[ProtocolHashIndex (Protocol)];
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
-      // This is the protocol entry
+      // This is the protocol entry. Move it to the front of its bucket, so
+      // that frequently used protocols are found first.
       //
 
       ProtEntry = Item;
+      if (Link != Bucket->ForwardLink) {
+        RemoveEntryList (Link);
+        InsertHeadList (Bucket, Link);
+      }
+
       break;
     }
   }
@@ -189,9 +236,10 @@ CoreFindProtocolEntry (
       InitializeListHead (&ProtEntry->Notify);
 
       //
-      // Add it to protocol database
+      // Add it to protocol database and to its hash bucket
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertHeadList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -471,6 +519,8 @@ CoreInstallProtocolInterfaceNotify (
     }
   }
 
+  CORE_PERF_TRACE (PERF_TRACE_START_ID, *UserHandle, Protocol, "InstallProtocol", Interface);
+
   //
   // Lock the protocol database
   //
@@ -600,6 +650,7 @@ Done:
     DEBUG ((DEBUG_ERROR, "InstallProtocolInterface: %g %p failed with %r\n", Protocol, Interface, Status));
   }
 
+  CORE_PERF_TRACE (PERF_TRACE_END_ID, Handle, Protocol, "InstallProtocol", Interface);
   return Status;
 }
 
@@ -1109,6 +1160,8 @@ CoreOpenProtocol (
 
   Prot = NULL;
 
+  CORE_PERF_TRACE (PERF_TRACE_START_ID, UserHandle, Protocol, "OpenProtocol", ImageHandle);
+
   //
   // Lock the protocol database
   //
@@ -1314,6 +1367,7 @@ Done:
   // Done. Release the database lock and return
   //
   CoreReleaseProtocolLock ();
+  CORE_PERF_TRACE (PERF_TRACE_END_ID, UserHandle, Protocol, "OpenProtocol", ImageHandle);
   return Status;
 }
 
@@ -38,6 +38,8 @@ typedef struct {
   UINTN         Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY    AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket of ProtocolID
+  LIST_ENTRY    HashLink;
   /// ID of the protocol
   EFI_GUID      ProtocolID;
   /// All protocol interfaces
@@ -578,10 +578,12 @@ CoreLocateProtocol (
   OUT VOID      **Interface
   )
 {
-  EFI_STATUS       Status;
-  LOCATE_POSITION  Position;
-  PROTOCOL_NOTIFY  *ProtNotify;
-  IHANDLE          *Handle;
+  EFI_STATUS          Status;
+  LOCATE_POSITION     Position;
+  PROTOCOL_NOTIFY     *ProtNotify;
+  PROTOCOL_ENTRY      *ProtEntry;
+  PROTOCOL_INTERFACE  *Prot;
+  IHANDLE             *Handle;
 
   if ((Interface == NULL) || (Protocol == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -605,28 +607,28 @@ CoreLocateProtocol (
     return EFI_NOT_FOUND;
   }
 
-  mEfiLocateHandleRequest += 1;
-
   if (Registration == NULL) {
     //
-    // Look up the protocol entry and set the head pointer
+    // Look up the protocol entry. The first interface on its list is the
+    // one to return, so no handle enumeration is needed.
     //
-    Position.ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
-    if (Position.ProtEntry == NULL) {
+    ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+    if ((ProtEntry == NULL) || IsListEmpty (&ProtEntry->Protocols)) {
       Status = EFI_NOT_FOUND;
       goto Done;
     }
 
-    Position.Position = &Position.ProtEntry->Protocols;
-
-    Handle = CoreGetNextLocateByProtocol (&Position, Interface);
-  } else {
-    Handle = CoreGetNextLocateByRegisterNotify (&Position, Interface);
+    Prot       = CR (ProtEntry->Protocols.ForwardLink, PROTOCOL_INTERFACE, ByProtocol, PROTOCOL_INTERFACE_SIGNATURE);
+    *Interface = Prot->Interface;
+    goto Done;
   }
 
+  mEfiLocateHandleRequest += 1;
+
+  Handle = CoreGetNextLocateByRegisterNotify (&Position, Interface);
   if (Handle == NULL) {
     Status = EFI_NOT_FOUND;
-  } else if (Registration != NULL) {
+  } else {
     //
     // If this is a search by register notify and a handle was
     // returned, update the register notification position
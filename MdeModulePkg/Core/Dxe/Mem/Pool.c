@@ -59,6 +59,49 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Object sizes served by the slab front-end when PcdPoolSlabAllocatorEnable
+// is set. Each object only carries a POOL_HEAD (no POOL_TAIL), and each slab
+// is a single page holding objects of one size, tracked by a free bitmap.
+//
+STATIC CONST UINT16  mPoolSlabSizeTable[] = {
+  32, 48, 64, 96, 128, 192, 256, 384, 512
+};
+
+#define MAX_POOL_SLAB_LIST  (ARRAY_SIZE (mPoolSlabSizeTable))
+#define MAX_POOL_SLAB_SIZE  (mPoolSlabSizeTable[MAX_POOL_SLAB_LIST - 1])
+
+//
+// Number of slab pages allocated at once when a slab list runs dry, and the
+// number of completely free slabs kept cached per list before pages are
+// returned to the page allocator.
+//
+#define POOL_SLAB_REFILL_PAGES  4
+#define POOL_SLAB_MAX_EMPTY     2
+
+#define POOL_SLAB_MAP_ENTRIES  2
+#define POOL_SLAB_MAX_SLOTS    (POOL_SLAB_MAP_ENTRIES * 64)
+
+#define POOLSLAB_HEAD_SIGNATURE  SIGNATURE_32('p','h','d','2')
+
+#define POOL_SLAB_SIGNATURE  SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32        Signature;
+  UINT16        Index;
+  UINT16        SlotCount;
+  UINT16        FreeCount;
+  UINT16        Reserved;
+  LIST_ENTRY    Link;
+  //
+  // A set bit means the corresponding slot is free.
+  //
+  UINT64        FreeMap[POOL_SLAB_MAP_ENTRIES];
+} POOL_SLAB;
+
+#define POOL_SLAB_DATA_OFFSET  ALIGN_VALUE (sizeof (POOL_SLAB), 64)
+
+#define SLAB_INDEX_TO_SIZE(a)  (mPoolSlabSizeTable [a])
+
 //
 // Globals
 //
@@ -69,6 +112,8 @@ typedef struct {
   UINTN              Used;
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
+  LIST_ENTRY         SlabList[MAX_POOL_SLAB_LIST];
+  UINTN              EmptySlabCount[MAX_POOL_SLAB_LIST];
   LIST_ENTRY         Link;
 } POOL;
 
@@ -126,6 +171,11 @@ CoreInitializePool (
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+
+    for (Index = 0; Index < MAX_POOL_SLAB_LIST; Index++) {
+      InitializeListHead (&mPoolHead[Type].SlabList[Index]);
+      mPoolHead[Type].EmptySlabCount[Index] = 0;
+    }
   }
 }
 
@@ -175,6 +225,11 @@ LookupPoolHead (
       InitializeListHead (&Pool->FreeList[Index]);
     }
 
+    for (Index = 0; Index < MAX_POOL_SLAB_LIST; Index++) {
+      InitializeListHead (&Pool->SlabList[Index]);
+      Pool->EmptySlabCount[Index] = 0;
+    }
+
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
     return Pool;
@@ -336,6 +391,191 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Get slab list index from the specified object size.
+
+  @param  Size          The object size, including the pool head.
+
+  @return               The index of the slab size table, or MAX_POOL_SLAB_LIST
+                        if the size is too large to be served from a slab.
+
+**/
+STATIC
+UINTN
+GetPoolSlabIndexFromSize (
+  UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MAX_POOL_SLAB_LIST; Index++) {
+    if (mPoolSlabSizeTable[Index] >= Size) {
+      return Index;
+    }
+  }
+
+  return MAX_POOL_SLAB_LIST;
+}
+
+/**
+  Check whether an allocation of the specified type may be served from slabs.
+
+  Runtime memory types keep using the regular pool bins, so that partially
+  used slabs do not end up in the runtime memory map handed to the OS.
+
+  @param  PoolType               Type of pool to allocate
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+  @param  PageAsPool             Flag to indicate pool is allocated as pages
+
+  @retval TRUE   The slab front-end may serve the allocation.
+  @retval FALSE  The allocation must go through the regular pool bins.
+
+**/
+STATIC
+BOOLEAN
+IsPoolSlabCandidate (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN BOOLEAN          NeedGuard,
+  IN BOOLEAN          PageAsPool
+  )
+{
+  if (!PcdGetBool (PcdPoolSlabAllocatorEnable) || NeedGuard || PageAsPool) {
+    return FALSE;
+  }
+
+  if (((UINT32)PoolType >= EfiMaxMemoryType) ||
+      (PoolType == EfiReservedMemoryType) ||
+      (PoolType == EfiACPIMemoryNVS) ||
+      (PoolType == EfiRuntimeServicesCode) ||
+      (PoolType == EfiRuntimeServicesData))
+  {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(DEFAULT_PAGE_ALLOCATION_GRANULARITY == EFI_PAGE_SIZE);
+}
+
+/**
+  Internal function.  Allocates a batch of pages and turns each of them into
+  an empty slab for the specified slab list.
+
+  @param  Pool                   The pool head of the memory type to refill
+  @param  Index                  The slab list index to refill
+
+  @retval TRUE   At least one slab was added to the slab list.
+  @retval FALSE  No pages could be allocated.
+
+**/
+STATIC
+BOOLEAN
+CoreRefillPoolSlabI (
+  IN POOL   *Pool,
+  IN UINTN  Index
+  )
+{
+  CHAR8      *NewPage;
+  POOL_SLAB  *Slab;
+  UINTN      NoPages;
+  UINTN      Page;
+  UINTN      Slot;
+
+  //
+  // Try to get several slabs in one go, falling back to a single page when
+  // memory is tight.
+  //
+  NoPages = POOL_SLAB_REFILL_PAGES;
+  NewPage = CoreAllocatePoolPagesI (Pool->MemoryType, NoPages, EFI_PAGE_SIZE, FALSE);
+  if (NewPage == NULL) {
+    NoPages = 1;
+    NewPage = CoreAllocatePoolPagesI (Pool->MemoryType, NoPages, EFI_PAGE_SIZE, FALSE);
+    if (NewPage == NULL) {
+      return FALSE;
+    }
+  }
+
+  for (Page = 0; Page < NoPages; Page++) {
+    Slab            = (POOL_SLAB *)(NewPage + EFI_PAGES_TO_SIZE (Page));
+    Slab->Signature = POOL_SLAB_SIGNATURE;
+    Slab->Index     = (UINT16)Index;
+    Slab->SlotCount = (UINT16)((EFI_PAGE_SIZE - POOL_SLAB_DATA_OFFSET) / SLAB_INDEX_TO_SIZE (Index));
+    Slab->FreeCount = Slab->SlotCount;
+    Slab->Reserved  = 0;
+    ASSERT (Slab->SlotCount <= POOL_SLAB_MAX_SLOTS);
+
+    ZeroMem (Slab->FreeMap, sizeof (Slab->FreeMap));
+    for (Slot = 0; Slot < Slab->SlotCount; Slot++) {
+      Slab->FreeMap[Slot / 64] |= LShiftU64 (1, Slot % 64);
+    }
+
+    InsertTailList (&Pool->SlabList[Index], &Slab->Link);
+  }
+
+  Pool->EmptySlabCount[Index] += NoPages;
+  return TRUE;
+}
+
+/**
+  Internal function.  Allocates an object from the slab front-end.
+  Caller must have the memory lock held
+
+  @param  Pool                   The pool head of the memory type to allocate
+  @param  Size                   The object size, including the pool head
+
+  @return The pool head of the allocated object, or NULL
+
+**/
+STATIC
+POOL_HEAD *
+CoreAllocatePoolSlabI (
+  IN POOL   *Pool,
+  IN UINTN  Size
+  )
+{
+  POOL_SLAB  *Slab;
+  UINTN      Index;
+  UINTN      Entry;
+  UINTN      Slot;
+
+  Index = GetPoolSlabIndexFromSize (Size);
+  ASSERT (Index < MAX_POOL_SLAB_LIST);
+
+  if (IsListEmpty (&Pool->SlabList[Index])) {
+    if (!CoreRefillPoolSlabI (Pool, Index)) {
+      return NULL;
+    }
+  }
+
+  //
+  // Slabs that still have free slots are kept on the list, partially used
+  // ones first, so take a slot from the first one.
+  //
+  Slab = CR (Pool->SlabList[Index].ForwardLink, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+  ASSERT (Slab->FreeCount > 0);
+
+  for (Entry = 0; Slab->FreeMap[Entry] == 0; Entry++) {
+    ASSERT (Entry < POOL_SLAB_MAP_ENTRIES - 1);
+  }
+
+  Slot                  = (UINTN)LowBitSet64 (Slab->FreeMap[Entry]);
+  Slab->FreeMap[Entry] &= ~LShiftU64 (1, Slot);
+  Slot                 += Entry * 64;
+
+  if (Slab->FreeCount == Slab->SlotCount) {
+    ASSERT (Pool->EmptySlabCount[Index] > 0);
+    Pool->EmptySlabCount[Index]--;
+  }
+
+  Slab->FreeCount--;
+  if (Slab->FreeCount == 0) {
+    //
+    // Full slabs are not tracked, they get back onto the list on free.
+    //
+    RemoveEntryList (&Slab->Link);
+  }
+
+  return (POOL_HEAD *)((CHAR8 *)Slab + POOL_SLAB_DATA_OFFSET + Slot * SLAB_INDEX_TO_SIZE (Index));
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -367,6 +607,7 @@ CoreAllocatePoolI (
   UINTN      Granularity;
   BOOLEAN    HasPoolTail;
   BOOLEAN    PageAsPool;
+  BOOLEAN    FromSlab;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -413,7 +654,24 @@ CoreAllocatePoolI (
     return NULL;
   }
 
-  Head = NULL;
+  Head     = NULL;
+  FromSlab = FALSE;
+
+  //
+  // Serve small requests from the slab front-end. Slab objects carry no
+  // pool tail.
+  //
+  if (IsPoolSlabCandidate (PoolType, NeedGuard, PageAsPool) &&
+      (Size - sizeof (POOL_TAIL) <= MAX_POOL_SLAB_SIZE))
+  {
+    Head = CoreAllocatePoolSlabI (Pool, Size - sizeof (POOL_TAIL));
+    if (Head != NULL) {
+      FromSlab    = TRUE;
+      HasPoolTail = FALSE;
+      Size        = SLAB_INDEX_TO_SIZE (GetPoolSlabIndexFromSize (Size - sizeof (POOL_TAIL)));
+      goto Done;
+    }
+  }
 
   //
   // If allocation is over max size, just allocate pages for the request
@@ -516,7 +774,12 @@ Done:
     //
     // If we have a pool buffer, fill in the header & tail info
     //
-    Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    if (FromSlab) {
+      Head->Signature = POOLSLAB_HEAD_SIGNATURE;
+    } else {
+      Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    }
+
     Head->Size      = Size;
     Head->Type      = (EFI_MEMORY_TYPE)PoolType;
     Buffer          = Head->Data;
@@ -676,6 +939,96 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Returns an object to its slab.
+  Caller must have the memory lock held
+
+  @param  Head                   The pool head of the object to free
+  @param  PoolType               Pointer to pool type
+
+  @retval EFI_INVALID_PARAMETER  Head does not point to an allocated slab object.
+  @retval EFI_SUCCESS            The object was successfully freed.
+
+**/
+STATIC
+EFI_STATUS
+CoreFreePoolSlabI (
+  IN  POOL_HEAD        *Head,
+  OUT EFI_MEMORY_TYPE  *PoolType OPTIONAL
+  )
+{
+  POOL       *Pool;
+  POOL_SLAB  *Slab;
+  UINTN      Offset;
+  UINTN      Slot;
+  UINT64     Mask;
+
+  ASSERT_LOCKED (&mPoolMemoryLock);
+
+  Slab = (POOL_SLAB *)((UINTN)Head & ~(UINTN)EFI_PAGE_MASK);
+  if ((Slab->Signature != POOL_SLAB_SIGNATURE) ||
+      (Slab->Index >= MAX_POOL_SLAB_LIST) ||
+      (Head->Size != SLAB_INDEX_TO_SIZE (Slab->Index)) ||
+      ((UINT32)Head->Type >= EfiMaxMemoryType))
+  {
+    ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+    ASSERT (Slab->Index < MAX_POOL_SLAB_LIST);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Offset = (UINTN)Head - (UINTN)Slab - POOL_SLAB_DATA_OFFSET;
+  Slot   = Offset / Head->Size;
+  Mask   = LShiftU64 (1, Slot % 64);
+  if (((Offset % Head->Size) != 0) || (Slot >= Slab->SlotCount) ||
+      ((Slab->FreeMap[Slot / 64] & Mask) != 0))
+  {
+    ASSERT ((Offset % Head->Size) == 0);
+    ASSERT ((Slab->FreeMap[Slot / 64] & Mask) == 0);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Pool        = &mPoolHead[Head->Type];
+  Pool->Used -= Head->Size;
+  DEBUG ((DEBUG_POOL, "FreePool: %p (len %lx) %,ld\n", Head->Data, (UINT64)(Head->Size - SIZE_OF_POOL_HEAD), (UINT64)Pool->Used));
+
+  if (PoolType != NULL) {
+    *PoolType = Head->Type;
+  }
+
+  //
+  // Wipe the head so that a double free does not match the slab signature,
+  // then mark the slot free again.
+  //
+  DEBUG_CLEAR_MEMORY (Head, Head->Size);
+  Head->Signature = 0;
+
+  Slab->FreeMap[Slot / 64] |= Mask;
+  Slab->FreeCount++;
+
+  if (Slab->FreeCount == 1) {
+    InsertHeadList (&Pool->SlabList[Slab->Index], &Slab->Link);
+  }
+
+  if (Slab->FreeCount == Slab->SlotCount) {
+    RemoveEntryList (&Slab->Link);
+    if (Pool->EmptySlabCount[Slab->Index] >= POOL_SLAB_MAX_EMPTY) {
+      //
+      // Enough empty slabs are cached already, give this page back
+      //
+      Slab->Signature = 0;
+      CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS)(UINTN)Slab, 1);
+    } else {
+      //
+      // Keep empty slabs behind the partially used ones
+      //
+      InsertTailList (&Pool->SlabList[Slab->Index], &Slab->Link);
+      Pool->EmptySlabCount[Slab->Index]++;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -715,6 +1068,10 @@ CoreFreePoolI (
   Head = BASE_CR (Buffer, POOL_HEAD, Data);
   ASSERT (Head != NULL);
 
+  if (Head->Signature == POOLSLAB_HEAD_SIGNATURE) {
+    return CoreFreePoolSlabI (Head, PoolType);
+  }
+
   if ((Head->Signature != POOL_HEAD_SIGNATURE) &&
       (Head->Signature != POOLPAGE_HEAD_SIGNATURE))
   {
@@ -27,6 +27,12 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
+  The same FV file is usually opened several times (for its depex, its PE32
+  and its UI sections), so the streams produced by decompressing compression
+  and GUIDed sections are kept in a bounded cache keyed by the contents of
+  the encapsulation section. GUIDed sections that carry authentication
+  information are always extracted again.
+
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -92,6 +98,23 @@ typedef struct {
   VOID                        *Registration;
 } RPN_EVENT_CONTEXT;
 
+#define SECTION_CACHE_ENTRY_SIGNATURE  SIGNATURE_32('S','X','C','E')
+#define SECTION_CACHE_ENTRY_FROM_LINK(Node) \
+  CR (Node, SECTION_CACHE_ENTRY, Link, SECTION_CACHE_ENTRY_SIGNATURE)
+
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    Link;
+  //
+  // The encapsulation section, and the section stream it produced
+  //
+  UINT32        SectionCrc;
+  UINTN         SectionSize;
+  VOID          *Section;
+  UINTN         StreamSize;
+  VOID          *Stream;
+} SECTION_CACHE_ENTRY;
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -196,6 +219,161 @@ EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol =
   CustomGuidedSectionExtract
 };
 
+//
+// Cache of decompressed section streams, most recently used first
+//
+LIST_ENTRY  mSectionCache     = INITIALIZE_LIST_HEAD_VARIABLE (mSectionCache);
+UINTN       mSectionCacheSize = 0;
+
+/**
+  Looks up the section stream produced by an encapsulation section in the
+  section cache.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the section.
+  @param  Stream                 On input, NULL to allocate the returned stream
+                                 from pool, or a buffer of StreamSize bytes to
+                                 copy the stream to. On output, the stream.
+  @param  StreamSize             On input, the size of the Stream buffer if
+                                 Stream is not NULL. On output, the size of the
+                                 stream.
+
+  @retval TRUE                   The stream was found in the cache.
+  @retval FALSE                  The section must be decompressed.
+
+**/
+STATIC
+BOOLEAN
+SectionCacheGet (
+  IN     VOID   *Section,
+  IN     UINTN  SectionSize,
+  IN OUT VOID   **Stream,
+  IN OUT UINTN  *StreamSize
+  )
+{
+  LIST_ENTRY           *Link;
+  SECTION_CACHE_ENTRY  *Entry;
+  UINT32               SectionCrc;
+  EFI_TPL              OldTpl;
+  BOOLEAN              Found;
+
+  if (PcdGet32 (PcdDxeSectionCacheSize) == 0) {
+    return FALSE;
+  }
+
+  SectionCrc = CalculateCrc32 (Section, SectionSize);
+  Found      = FALSE;
+
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  for (Link = mSectionCache.ForwardLink; Link != &mSectionCache; Link = Link->ForwardLink) {
+    Entry = SECTION_CACHE_ENTRY_FROM_LINK (Link);
+    if ((Entry->SectionCrc != SectionCrc) || (Entry->SectionSize != SectionSize) ||
+        (CompareMem (Entry->Section, Section, SectionSize) != 0))
+    {
+      continue;
+    }
+
+    if (*Stream == NULL) {
+      *Stream = AllocateCopyPool (Entry->StreamSize, Entry->Stream);
+      Found   = (BOOLEAN)(*Stream != NULL);
+    } else if (*StreamSize == Entry->StreamSize) {
+      CopyMem (*Stream, Entry->Stream, Entry->StreamSize);
+      Found = TRUE;
+    }
+
+    if (Found) {
+      *StreamSize = Entry->StreamSize;
+      RemoveEntryList (&Entry->Link);
+      InsertHeadList (&mSectionCache, &Entry->Link);
+    }
+
+    break;
+  }
+
+  CoreRestoreTpl (OldTpl);
+
+  if (Found) {
+    PERF_EVENT ("SectionCacheHit");
+  } else {
+    PERF_EVENT ("SectionCacheMiss");
+  }
+
+  return Found;
+}
+
+/**
+  Adds the section stream produced by an encapsulation section to the
+  section cache, evicting the least recently used streams to make room.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the section.
+  @param  Stream                 The section stream.
+  @param  StreamSize             The size of the section stream.
+
+**/
+STATIC
+VOID
+SectionCachePut (
+  IN VOID   *Section,
+  IN UINTN  SectionSize,
+  IN VOID   *Stream,
+  IN UINTN  StreamSize
+  )
+{
+  SECTION_CACHE_ENTRY  *Entry;
+  SECTION_CACHE_ENTRY  *Victim;
+  UINTN                Limit;
+  EFI_TPL              OldTpl;
+
+  Limit = PcdGet32 (PcdDxeSectionCacheSize);
+  if ((Limit == 0) || (SectionSize > Limit) || (StreamSize > Limit - SectionSize)) {
+    return;
+  }
+
+  Entry = AllocateZeroPool (sizeof (SECTION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    return;
+  }
+
+  Entry->Signature   = SECTION_CACHE_ENTRY_SIGNATURE;
+  Entry->SectionCrc  = CalculateCrc32 (Section, SectionSize);
+  Entry->SectionSize = SectionSize;
+  Entry->Section     = AllocateCopyPool (SectionSize, Section);
+  Entry->StreamSize  = StreamSize;
+  Entry->Stream      = AllocateCopyPool (StreamSize, Stream);
+  if ((Entry->Section == NULL) || (Entry->Stream == NULL)) {
+    if (Entry->Section != NULL) {
+      CoreFreePool (Entry->Section);
+    }
+
+    if (Entry->Stream != NULL) {
+      CoreFreePool (Entry->Stream);
+    }
+
+    CoreFreePool (Entry);
+    return;
+  }
+
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  while (mSectionCacheSize + SectionSize + StreamSize > Limit) {
+    ASSERT (!IsListEmpty (&mSectionCache));
+    Victim = SECTION_CACHE_ENTRY_FROM_LINK (mSectionCache.BackLink);
+    RemoveEntryList (&Victim->Link);
+    mSectionCacheSize -= Victim->SectionSize + Victim->StreamSize;
+    CoreRestoreTpl (OldTpl);
+
+    CoreFreePool (Victim->Section);
+    CoreFreePool (Victim->Stream);
+    CoreFreePool (Victim);
+
+    OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  }
+
+  InsertHeadList (&mSectionCache, &Entry->Link);
+  mSectionCacheSize += SectionSize + StreamSize;
+  CoreRestoreTpl (OldTpl);
+}
+
 /**
   Entry point of the section extraction code. Initializes an instance of the
   section extraction interface and installs it on a new handle.
@@ -758,54 +936,60 @@ CreateChildNode (
           CopyMem (NewStreamBuffer, CompressionSource, NewStreamBufferSize);
         } else if (CompressionType == EFI_STANDARD_COMPRESSION) {
           //
-          // Only support the EFI_SATNDARD_COMPRESSION algorithm.
-          //
-
-          //
-          // Decompress the stream
+          // Only support the EFI_SATNDARD_COMPRESSION algorithm. Sections that
+          // were decompressed before are copied from the section cache.
           //
-          Status = CoreLocateProtocol (&gEfiDecompressProtocolGuid, NULL, (VOID **)&Decompress);
-          ASSERT_EFI_ERROR (Status);
-          ASSERT (Decompress != NULL);
-
-          Status = Decompress->GetInfo (
-                                 Decompress,
-                                 CompressionSource,
-                                 CompressionSourceSize,
-                                 (UINT32 *)&NewStreamBufferSize,
-                                 &ScratchSize
-                                 );
-          if (EFI_ERROR (Status) || (NewStreamBufferSize != UncompressedLength)) {
-            CoreFreePool (Node);
-            CoreFreePool (NewStreamBuffer);
-            if (!EFI_ERROR (Status)) {
-              Status = EFI_BAD_BUFFER_SIZE;
+          if (!SectionCacheGet (SectionHeader, Node->Size, &NewStreamBuffer, &NewStreamBufferSize)) {
+            //
+            // Decompress the stream
+            //
+            Status = CoreLocateProtocol (&gEfiDecompressProtocolGuid, NULL, (VOID **)&Decompress);
+            ASSERT_EFI_ERROR (Status);
+            ASSERT (Decompress != NULL);
+
+            Status = Decompress->GetInfo (
+                                   Decompress,
+                                   CompressionSource,
+                                   CompressionSourceSize,
+                                   (UINT32 *)&NewStreamBufferSize,
+                                   &ScratchSize
+                                   );
+            if (EFI_ERROR (Status) || (NewStreamBufferSize != UncompressedLength)) {
+              CoreFreePool (Node);
+              CoreFreePool (NewStreamBuffer);
+              if (!EFI_ERROR (Status)) {
+                Status = EFI_BAD_BUFFER_SIZE;
+              }
+
+              return Status;
             }
 
-            return Status;
-          }
+            ScratchBuffer = AllocatePool (ScratchSize);
+            if (ScratchBuffer == NULL) {
+              CoreFreePool (Node);
+              CoreFreePool (NewStreamBuffer);
+              return EFI_OUT_OF_RESOURCES;
+            }
 
-          ScratchBuffer = AllocatePool (ScratchSize);
-          if (ScratchBuffer == NULL) {
-            CoreFreePool (Node);
-            CoreFreePool (NewStreamBuffer);
-            return EFI_OUT_OF_RESOURCES;
-          }
+            PERF_INMODULE_BEGIN ("SectionDecompress");
+            Status = Decompress->Decompress (
+                                   Decompress,
+                                   CompressionSource,
+                                   CompressionSourceSize,
+                                   NewStreamBuffer,
+                                   (UINT32)NewStreamBufferSize,
+                                   ScratchBuffer,
+                                   ScratchSize
+                                   );
+            PERF_INMODULE_END ("SectionDecompress");
+            CoreFreePool (ScratchBuffer);
+            if (EFI_ERROR (Status)) {
+              CoreFreePool (Node);
+              CoreFreePool (NewStreamBuffer);
+              return Status;
+            }
 
-          Status = Decompress->Decompress (
-                                 Decompress,
-                                 CompressionSource,
-                                 CompressionSourceSize,
-                                 NewStreamBuffer,
-                                 (UINT32)NewStreamBufferSize,
-                                 ScratchBuffer,
-                                 ScratchSize
-                                 );
-          CoreFreePool (ScratchBuffer);
-          if (EFI_ERROR (Status)) {
-            CoreFreePool (Node);
-            CoreFreePool (NewStreamBuffer);
-            return Status;
+            SectionCachePut (SectionHeader, Node->Size, NewStreamBuffer, NewStreamBufferSize);
           }
         }
       } else {
@@ -840,19 +1024,35 @@ CreateChildNode (
 
       if (VerifyGuidedSectionGuid (Node->EncapsulationGuid, &GuidedExtraction)) {
         //
-        // NewStreamBuffer is always allocated by ExtractSection... No caller
-        // allocation here.
+        // Sections that carry authentication information are verified by
+        // ExtractSection() every time, so only the others are cached.
         //
-        Status = GuidedExtraction->ExtractSection (
-                                     GuidedExtraction,
-                                     GuidedHeader,
-                                     &NewStreamBuffer,
-                                     &NewStreamBufferSize,
-                                     &AuthenticationStatus
-                                     );
-        if (EFI_ERROR (Status)) {
-          CoreFreePool (*ChildNode);
-          return EFI_PROTOCOL_ERROR;
+        NewStreamBuffer      = NULL;
+        AuthenticationStatus = 0;
+        if (((GuidedSectionAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) != 0) ||
+            !SectionCacheGet (SectionHeader, Node->Size, &NewStreamBuffer, &NewStreamBufferSize))
+        {
+          //
+          // NewStreamBuffer is always allocated by ExtractSection... No caller
+          // allocation here.
+          //
+          PERF_INMODULE_BEGIN ("SectionExtract");
+          Status = GuidedExtraction->ExtractSection (
+                                       GuidedExtraction,
+                                       GuidedHeader,
+                                       &NewStreamBuffer,
+                                       &NewStreamBufferSize,
+                                       &AuthenticationStatus
+                                       );
+          PERF_INMODULE_END ("SectionExtract");
+          if (EFI_ERROR (Status)) {
+            CoreFreePool (*ChildNode);
+            return EFI_PROTOCOL_ERROR;
+          }
+
+          if ((GuidedSectionAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) == 0) {
+            SectionCachePut (SectionHeader, Node->Size, NewStreamBuffer, NewStreamBufferSize);
+          }
         }
 
         //
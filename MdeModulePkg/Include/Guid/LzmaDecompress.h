@@ -23,7 +23,35 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into fixed size
+/// chunks that were compressed independently using LZMA. The chunks can be
+/// decompressed in any order, so decoders may spread them over several
+/// processors.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0xFC2881BE, 0x2486, 0x4741, { 0x96, 0x02, 0x9E, 0x4B, 0xC2, 0xF9, 0x29, 0xF2 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'C', 'K')
+
+///
+/// Header of the data carried by a LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID section.
+/// It is followed by ChunkCount UINT32 offsets, each one giving the start of a
+/// chunk relative to the beginning of this header. Every chunk is a regular
+/// LZMA stream (5 bytes of properties, 8 bytes of decoded size, encoded data)
+/// that decodes to ChunkSize bytes, except for the last one which holds the
+/// remainder of UncompressedSize.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    ChunkSize;
+  UINT32    ChunkCount;
+  UINT32    UncompressedSize;
+} LZMA_CHUNKED_HEADER;
+
 extern GUID  gLzmaCustomDecompressGuid;
 extern GUID  gLzmaF86CustomDecompressGuid;
+extern GUID  gLzmaChunkedCustomDecompressGuid;
 
 #endif
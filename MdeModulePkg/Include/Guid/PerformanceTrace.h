@@ -0,0 +1,98 @@
+/** @file
+  Performance trace ring buffers published by DxeCorePerformanceLib.
+
+  When PcdPerformanceTraceRingSize is not zero, DxeCorePerformanceLib keeps
+  every performance measurement as a timestamped begin, end or instant event
+  in one ring buffer per processor, in addition to the FPDT records. The DXE
+  core also logs its protocol installs, OpenProtocol() calls and event
+  notifications to the rings only. Older events are overwritten once a ring
+  is full, so the rings always hold the most recent part of the boot.
+
+  The rings are published through the EFI system table with
+  gEdkiiPerformanceTraceGuid, so that a shell application can export them
+  after boot.
+
+Copyright (c) 2026, TianoCore contributors.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _PERFORMANCE_TRACE_H_
+#define _PERFORMANCE_TRACE_H_
+
+#define EDKII_PERFORMANCE_TRACE_GUID \
+  { 0x86878458, 0x37a5, 0x453c, { 0xb4, 0xfb, 0x6c, 0x24, 0x1e, 0x3e, 0x5d, 0xcf } }
+
+//
+// Identifiers of the DXE core events that are only logged to the trace rings.
+// CallerIdentifier is the handle the event applies to, Guid the protocol or
+// event group and Address the agent handle or notification function.
+//
+#define PERF_TRACE_START_ID  0x60
+#define PERF_TRACE_END_ID    0x61
+
+#define PERFORMANCE_TRACE_SIGNATURE  SIGNATURE_32 ('P', 'T', 'R', 'C')
+#define PERFORMANCE_TRACE_REVISION   1
+
+//
+// Values of PERFORMANCE_TRACE_ENTRY.Phase, matching the Chrome trace format.
+//
+#define PERFORMANCE_TRACE_PHASE_BEGIN    'B'
+#define PERFORMANCE_TRACE_PHASE_END      'E'
+#define PERFORMANCE_TRACE_PHASE_INSTANT  'i'
+
+#define PERFORMANCE_TRACE_NAME_LENGTH  24
+
+typedef struct {
+  //
+  // Ring position of this entry plus one. It is written last, so an entry
+  // whose Sequence does not match its position is incomplete or overwritten.
+  //
+  UINT32      Sequence;
+  UINT16      ProgressId;
+  UINT8       Phase;
+  UINT8       Reserved;
+  //
+  // Raw performance counter value.
+  //
+  UINT64      Timestamp;
+  UINT64      Handle;
+  UINT64      Address;
+  EFI_GUID    Guid;
+  CHAR8       Name[PERFORMANCE_TRACE_NAME_LENGTH];
+} PERFORMANCE_TRACE_ENTRY;
+
+typedef struct {
+  //
+  // Number of entries ever reserved in this ring. Entry N is stored at
+  // Entries[N & (EntryCount - 1)].
+  //
+  volatile UINT32            Head;
+  UINT32                     Reserved;
+  PERFORMANCE_TRACE_ENTRY    Entries[1];
+} PERFORMANCE_TRACE_RING;
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    Revision;
+  //
+  // Number of entries in each ring, a power of two.
+  //
+  UINT32    EntryCount;
+  UINT32    CpuCount;
+  //
+  // Performance counter properties, see GetPerformanceCounterProperties().
+  //
+  UINT64    Frequency;
+  UINT64    TimerStartValue;
+  UINT64    TimerEndValue;
+  //
+  // Address of the PERFORMANCE_TRACE_RING of each processor, indexed by the
+  // processor number of the MP services protocol.
+  //
+  UINT64    Ring[1];
+} PERFORMANCE_TRACE_TABLE;
+
+extern EFI_GUID  gEdkiiPerformanceTraceGuid;
+
+#endif
@@ -1502,6 +1502,11 @@ DxeCorePerformanceLibConstructor (
   //
   InternalGetPeiPerformance (GetHobList ());
 
+  //
+  // Create the performance trace rings if enabled.
+  //
+  PerformanceTraceInitialize ();
+
   //
   // Install the protocol interfaces for DXE performance library instance.
   //
@@ -1592,6 +1597,18 @@ CreatePerformanceMeasurement (
 
   Status = EFI_SUCCESS;
 
+  if (PcdGet32 (PcdPerformanceTraceRingSize) != 0) {
+    //
+    // DXE core trace events only go to the trace rings. The FPDT records are
+    // not MP safe, so measurements logged on APs only go to the rings too.
+    //
+    if (!PerformanceTraceRecord (CallerIdentifier, Guid, String, TimeStamp, Address, (UINT16)Identifier, Attribute) ||
+        (((Identifier == PERF_TRACE_START_ID) || (Identifier == PERF_TRACE_END_ID)) && (Attribute == PerfEntry)))
+    {
+      return EFI_SUCCESS;
+    }
+  }
+
   if (mLockInsertRecord) {
     return EFI_INVALID_PARAMETER;
   }
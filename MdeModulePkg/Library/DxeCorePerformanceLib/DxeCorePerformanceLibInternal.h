@@ -21,12 +21,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/EventGroup.h>
 #include <Guid/FirmwarePerformance.h>
 #include <Guid/PiSmmCommunicationRegionTable.h>
+#include <Guid/PerformanceTrace.h>
 
 #include <Protocol/DriverBinding.h>
 #include <Protocol/LoadedImage.h>
 #include <Protocol/ComponentName2.h>
 #include <Protocol/DevicePathToText.h>
 #include <Protocol/SmmCommunication.h>
+#include <Protocol/MpService.h>
 
 #include <Library/PerformanceLib.h>
 #include <Library/DebugLib.h>
@@ -43,6 +45,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/DxeServicesLib.h>
 #include <Library/PeCoffGetEntryPointLib.h>
+#include <Library/SynchronizationLib.h>
 
 /**
   Create performance record with event description and a timestamp.
@@ -74,4 +77,39 @@ CreatePerformanceMeasurement (
   IN       PERF_MEASUREMENT_ATTRIBUTE  Attribute
   );
 
+/**
+  Create the trace ring of the BSP and publish it through the system table.
+
+  Does nothing if PcdPerformanceTraceRingSize is zero.
+**/
+VOID
+PerformanceTraceInitialize (
+  VOID
+  );
+
+/**
+  Append a performance measurement to the trace ring of the calling processor.
+
+  @param  CallerIdentifier  Image handle or pointer to caller ID GUID.
+  @param  Guid              Pointer to a GUID.
+  @param  String            Pointer to a string describing the measurement.
+  @param  Ticker            64-bit time stamp, 0 for the current time, 1 for unknown.
+  @param  Address           Pointer to a location in memory relevant to the measurement.
+  @param  PerfId            Performance identifier describing the type of measurement.
+  @param  Attribute         The attribute of the measurement.
+
+  @retval TRUE    The caller runs on the BSP.
+  @retval FALSE   The caller runs on an AP.
+**/
+BOOLEAN
+PerformanceTraceRecord (
+  IN CONST VOID                  *CallerIdentifier OPTIONAL,
+  IN CONST VOID                  *Guid             OPTIONAL,
+  IN CONST CHAR8                 *String           OPTIONAL,
+  IN UINT64                      Ticker,
+  IN UINT64                      Address,
+  IN UINT16                      PerfId,
+  IN PERF_MEASUREMENT_ATTRIBUTE  Attribute
+  );
+
 #endif
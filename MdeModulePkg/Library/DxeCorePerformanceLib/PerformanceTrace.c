@@ -0,0 +1,325 @@
+/** @file
+  Per-processor performance trace rings for DxeCorePerformanceLib.
+
+  Every performance measurement is appended to the ring of the processor that
+  logs it. Entries are reserved with an interlocked increment of the ring head
+  and published by writing their sequence number last, so logging never takes
+  a lock and an event notification that interrupts a logger on the same
+  processor simply reserves the next entry.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCorePerformanceLibInternal.h"
+
+PERFORMANCE_TRACE_TABLE   *mTraceTable      = NULL;
+EFI_MP_SERVICES_PROTOCOL  *mTraceMpServices = NULL;
+UINTN                     mTraceBspNumber   = 0;
+VOID                      *mTraceMpServicesRegistration;
+
+/**
+  Allocate one trace ring.
+
+  @param  EntryCount    The number of entries in the ring.
+
+  @return The address of the ring, or 0 if the allocation failed.
+**/
+STATIC
+UINT64
+PerformanceTraceAllocateRing (
+  IN UINT32  EntryCount
+  )
+{
+  return (UINT64)(UINTN)AllocateZeroPool (
+                          sizeof (PERFORMANCE_TRACE_RING) +
+                          (EntryCount - 1) * sizeof (PERFORMANCE_TRACE_ENTRY)
+                          );
+}
+
+/**
+  Allocate a trace table with room for the rings of CpuCount processors.
+
+  @param  CpuCount      The number of processors.
+
+  @return The table with its header filled in, or NULL if out of resources.
+**/
+STATIC
+PERFORMANCE_TRACE_TABLE *
+PerformanceTraceAllocateTable (
+  IN UINTN  CpuCount
+  )
+{
+  PERFORMANCE_TRACE_TABLE  *Table;
+
+  Table = AllocateZeroPool (sizeof (PERFORMANCE_TRACE_TABLE) + (CpuCount - 1) * sizeof (UINT64));
+  if (Table == NULL) {
+    return NULL;
+  }
+
+  Table->Signature  = PERFORMANCE_TRACE_SIGNATURE;
+  Table->Revision   = PERFORMANCE_TRACE_REVISION;
+  Table->EntryCount = GetPowerOfTwo32 (PcdGet32 (PcdPerformanceTraceRingSize));
+  Table->CpuCount   = (UINT32)CpuCount;
+  Table->Frequency  = GetPerformanceCounterProperties (
+                        &Table->TimerStartValue,
+                        &Table->TimerEndValue
+                        );
+  return Table;
+}
+
+/**
+  Give every processor its own trace ring once the MP services protocol is
+  installed.
+
+  Until then only the BSP runs DXE code, and its events are in the ring
+  created by PerformanceTraceInitialize().
+
+  @param  Event    The event of notify protocol.
+  @param  Context  Notify event context.
+
+**/
+STATIC
+VOID
+EFIAPI
+PerformanceTraceMpServicesNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  PERFORMANCE_TRACE_TABLE   *Table;
+  PERFORMANCE_TRACE_TABLE   *OldTable;
+  UINTN                     CpuCount;
+  UINTN                     EnabledCount;
+  UINTN                     BspNumber;
+  UINTN                     Index;
+  EFI_TPL                   OldTpl;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &CpuCount, &EnabledCount);
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->WhoAmI (MpServices, &BspNumber);
+  }
+
+  if (EFI_ERROR (Status) || (CpuCount <= 1) || (BspNumber >= CpuCount)) {
+    return;
+  }
+
+  Table = PerformanceTraceAllocateTable (CpuCount);
+  if (Table == NULL) {
+    return;
+  }
+
+  OldTable = mTraceTable;
+  for (Index = 0; Index < CpuCount; Index++) {
+    if (Index == BspNumber) {
+      Table->Ring[Index] = OldTable->Ring[0];
+    } else {
+      Table->Ring[Index] = PerformanceTraceAllocateRing (Table->EntryCount);
+    }
+  }
+
+  //
+  // No AP runs DXE code before the MP services protocol is installed, but a
+  // logger on the BSP may be interrupted by this notification or may log from
+  // a higher TPL. Publish the new table and MP services as one step at
+  // TPL_HIGH_LEVEL, and keep the old table, since an interrupted logger may
+  // still be using it.
+  //
+  OldTpl          = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  mTraceBspNumber = BspNumber;
+  mTraceTable     = Table;
+  MemoryFence ();
+  mTraceMpServices = MpServices;
+  gBS->RestoreTPL (OldTpl);
+
+  Status = gBS->InstallConfigurationTable (&gEdkiiPerformanceTraceGuid, Table);
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Create the trace ring of the BSP and publish it through the system table.
+
+  Does nothing if PcdPerformanceTraceRingSize is zero.
+**/
+VOID
+PerformanceTraceInitialize (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  PERFORMANCE_TRACE_TABLE  *Table;
+
+  if (PcdGet32 (PcdPerformanceTraceRingSize) == 0) {
+    return;
+  }
+
+  Table = PerformanceTraceAllocateTable (1);
+  if (Table == NULL) {
+    return;
+  }
+
+  Table->Ring[0] = PerformanceTraceAllocateRing (Table->EntryCount);
+  if (Table->Ring[0] == 0) {
+    FreePool (Table);
+    return;
+  }
+
+  mTraceTable = Table;
+
+  Status = gBS->InstallConfigurationTable (&gEdkiiPerformanceTraceGuid, Table);
+  ASSERT_EFI_ERROR (Status);
+
+  EfiCreateProtocolNotifyEvent (
+    &gEfiMpServiceProtocolGuid,
+    TPL_CALLBACK,
+    PerformanceTraceMpServicesNotify,
+    NULL,
+    &mTraceMpServicesRegistration
+    );
+}
+
+/**
+  Map a performance measurement to a Chrome trace event phase.
+
+  @param  PerfId      The performance identifier.
+  @param  Attribute   The attribute of the measurement.
+
+  @return PERFORMANCE_TRACE_PHASE_BEGIN, PERFORMANCE_TRACE_PHASE_END or
+          PERFORMANCE_TRACE_PHASE_INSTANT.
+**/
+STATIC
+UINT8
+PerformanceTraceGetPhase (
+  IN UINT16                      PerfId,
+  IN PERF_MEASUREMENT_ATTRIBUTE  Attribute
+  )
+{
+  if (Attribute == PerfStartEntry) {
+    return PERFORMANCE_TRACE_PHASE_BEGIN;
+  }
+
+  if (Attribute == PerfEndEntry) {
+    return PERFORMANCE_TRACE_PHASE_END;
+  }
+
+  switch (PerfId) {
+    case MODULE_START_ID:
+    case MODULE_LOADIMAGE_START_ID:
+    case MODULE_DB_START_ID:
+    case MODULE_DB_SUPPORT_START_ID:
+    case MODULE_DB_STOP_START_ID:
+    case PERF_EVENTSIGNAL_START_ID:
+    case PERF_CALLBACK_START_ID:
+    case PERF_FUNCTION_START_ID:
+    case PERF_INMODULE_START_ID:
+    case PERF_CROSSMODULE_START_ID:
+    case PERF_TRACE_START_ID:
+      return PERFORMANCE_TRACE_PHASE_BEGIN;
+
+    case MODULE_END_ID:
+    case MODULE_LOADIMAGE_END_ID:
+    case MODULE_DB_END_ID:
+    case MODULE_DB_SUPPORT_END_ID:
+    case MODULE_DB_STOP_END_ID:
+    case PERF_EVENTSIGNAL_END_ID:
+    case PERF_CALLBACK_END_ID:
+    case PERF_FUNCTION_END_ID:
+    case PERF_INMODULE_END_ID:
+    case PERF_CROSSMODULE_END_ID:
+    case PERF_TRACE_END_ID:
+      return PERFORMANCE_TRACE_PHASE_END;
+
+    default:
+      return PERFORMANCE_TRACE_PHASE_INSTANT;
+  }
+}
+
+/**
+  Append a performance measurement to the trace ring of the calling processor.
+
+  @param  CallerIdentifier  Image handle or pointer to caller ID GUID.
+  @param  Guid              Pointer to a GUID.
+  @param  String            Pointer to a string describing the measurement.
+  @param  Ticker            64-bit time stamp, 0 for the current time, 1 for unknown.
+  @param  Address           Pointer to a location in memory relevant to the measurement.
+  @param  PerfId            Performance identifier describing the type of measurement.
+  @param  Attribute         The attribute of the measurement.
+
+  @retval TRUE    The caller runs on the BSP.
+  @retval FALSE   The caller runs on an AP.
+**/
+BOOLEAN
+PerformanceTraceRecord (
+  IN CONST VOID                  *CallerIdentifier OPTIONAL,
+  IN CONST VOID                  *Guid             OPTIONAL,
+  IN CONST CHAR8                 *String           OPTIONAL,
+  IN UINT64                      Ticker,
+  IN UINT64                      Address,
+  IN UINT16                      PerfId,
+  IN PERF_MEASUREMENT_ATTRIBUTE  Attribute
+  )
+{
+  PERFORMANCE_TRACE_TABLE  *Table;
+  PERFORMANCE_TRACE_RING   *Ring;
+  PERFORMANCE_TRACE_ENTRY  *Entry;
+  UINTN                    CpuNumber;
+  UINT32                   Index;
+
+  Table = mTraceTable;
+  if (Table == NULL) {
+    return TRUE;
+  }
+
+  CpuNumber = 0;
+  if (mTraceMpServices != NULL) {
+    if (EFI_ERROR (mTraceMpServices->WhoAmI (mTraceMpServices, &CpuNumber)) ||
+        (CpuNumber >= Table->CpuCount))
+    {
+      return TRUE;
+    }
+  }
+
+  Ring = (PERFORMANCE_TRACE_RING *)(UINTN)Table->Ring[CpuNumber];
+  if (Ring != NULL) {
+    if (Ticker == 0) {
+      Ticker = GetPerformanceCounter ();
+    } else if (Ticker == 1) {
+      Ticker = 0;
+    }
+
+    Index = InterlockedIncrement (&Ring->Head) - 1;
+    Entry = &Ring->Entries[Index & (Table->EntryCount - 1)];
+
+    Entry->Sequence   = 0;
+    Entry->ProgressId = PerfId;
+    Entry->Phase      = PerformanceTraceGetPhase (PerfId, Attribute);
+    Entry->Timestamp  = Ticker;
+    Entry->Handle     = (UINT64)(UINTN)CallerIdentifier;
+    Entry->Address    = Address;
+    if (Guid != NULL) {
+      CopyGuid (&Entry->Guid, Guid);
+    } else {
+      ZeroMem (&Entry->Guid, sizeof (Entry->Guid));
+    }
+
+    ZeroMem (Entry->Name, sizeof (Entry->Name));
+    if (String != NULL) {
+      CopyMem (Entry->Name, String, AsciiStrnLenS (String, sizeof (Entry->Name) - 1));
+    }
+
+    MemoryFence ();
+    Entry->Sequence = Index + 1;
+  }
+
+  return (BOOLEAN)((mTraceMpServices == NULL) || (CpuNumber == mTraceBspNumber));
+}
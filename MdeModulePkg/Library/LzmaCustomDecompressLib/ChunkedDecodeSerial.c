@@ -0,0 +1,40 @@
+/** @file
+  Chunked LZMA decode hooks for firmware phases without multi-processor
+  services. Chunks are always decoded one after the other on the calling
+  processor.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+/**
+  Return the maximum number of chunks that this library instance may decode
+  at the same time. One scratch buffer is requested for each of them.
+
+  @return The number of chunks that can be in flight at once.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  )
+{
+  return 1;
+}
+
+/**
+  Decompress all chunks of a chunked LZMA section in parallel.
+
+  @param[in, out]  Context  The decode context of the section.
+
+  @retval RETURN_UNSUPPORTED  Parallel decode is not available in this phase.
+**/
+RETURN_STATUS
+LzmaChunkedDecodeParallel (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
@@ -0,0 +1,317 @@
+/** @file
+  Chunked LZMA Decompress GUIDed Section Extraction Library.
+
+  A chunked LZMA section carries an LZMA_CHUNKED_HEADER, a table of chunk
+  offsets and a series of standalone LZMA streams. Since the chunks do not
+  share any decoder state, they can be decompressed in any order and on any
+  processor.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+//
+// Every chunk starts with 5 bytes of LZMA properties followed by the 8 byte
+// decoded size.
+//
+#define LZMA_CHUNK_HEADER_SIZE  13
+
+/**
+  Locate the chunked LZMA data of a GUIDed section and validate its header.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] Header        The chunked LZMA header of the section.
+  @param[out] DataSize      The size, in bytes, of the data starting at Header.
+  @param[out] Attributes    The attributes of the GUIDed section. Optional.
+
+  @retval RETURN_SUCCESS            The header is valid.
+  @retval RETURN_INVALID_PARAMETER  The section is not a chunked LZMA section,
+                                    or its header is corrupted.
+**/
+STATIC
+RETURN_STATUS
+LzmaChunkedGetHeader (
+  IN  CONST VOID                 *InputSection,
+  OUT CONST LZMA_CHUNKED_HEADER  **Header,
+  OUT UINT32                     *DataSize,
+  OUT UINT16                     *Attributes OPTIONAL
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *ChunkedHeader;
+  CONST UINT32               *Offsets;
+  UINT32                     Size;
+  UINT32                     TableEnd;
+  UINT32                     Index;
+
+  if (IS_SECTION2 (InputSection)) {
+    if (!CompareGuid (
+           &gLzmaChunkedCustomDecompressGuid,
+           &(((EFI_GUID_DEFINED_SECTION2 *)InputSection)->SectionDefinitionGuid)
+           ))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    ChunkedHeader = (CONST LZMA_CHUNKED_HEADER *)((UINT8 *)InputSection + ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->DataOffset);
+    Size          = SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->DataOffset;
+    if (Attributes != NULL) {
+      *Attributes = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->Attributes;
+    }
+  } else {
+    if (!CompareGuid (
+           &gLzmaChunkedCustomDecompressGuid,
+           &(((EFI_GUID_DEFINED_SECTION *)InputSection)->SectionDefinitionGuid)
+           ))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    ChunkedHeader = (CONST LZMA_CHUNKED_HEADER *)((UINT8 *)InputSection + ((EFI_GUID_DEFINED_SECTION *)InputSection)->DataOffset);
+    Size          = SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *)InputSection)->DataOffset;
+    if (Attributes != NULL) {
+      *Attributes = ((EFI_GUID_DEFINED_SECTION *)InputSection)->Attributes;
+    }
+  }
+
+  if ((Size < sizeof (LZMA_CHUNKED_HEADER)) ||
+      (ChunkedHeader->Signature != LZMA_CHUNKED_SIGNATURE) ||
+      (ChunkedHeader->ChunkSize == 0) ||
+      (ChunkedHeader->ChunkCount == 0))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The chunk count must match the decoded size, and the offset table must
+  // fit in the section.
+  //
+  if (ChunkedHeader->ChunkCount != (UINT32)DivU64x32 (
+                                             (UINT64)ChunkedHeader->UncompressedSize + ChunkedHeader->ChunkSize - 1,
+                                             ChunkedHeader->ChunkSize
+                                             ))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (ChunkedHeader->ChunkCount > (Size - sizeof (LZMA_CHUNKED_HEADER)) / sizeof (UINT32)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Chunks are stored in order, back to back, after the offset table. Check
+  // this once here so that the decoders can trust the table.
+  //
+  TableEnd = sizeof (LZMA_CHUNKED_HEADER) + ChunkedHeader->ChunkCount * sizeof (UINT32);
+  Offsets  = (CONST UINT32 *)(ChunkedHeader + 1);
+  for (Index = 0; Index < ChunkedHeader->ChunkCount; Index++) {
+    if ((Offsets[Index] < TableEnd) ||
+        (Offsets[Index] > Size - LZMA_CHUNK_HEADER_SIZE))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    TableEnd = Offsets[Index] + LZMA_CHUNK_HEADER_SIZE;
+  }
+
+  *Header   = ChunkedHeader;
+  *DataSize = Size;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress a single chunk of a chunked LZMA section.
+
+  This function only touches the destination range and the scratch buffer
+  owned by the chunk, so it may run on several processors at once.
+
+  @param[in]  Context     The decode context of the section.
+  @param[in]  ChunkIndex  The index of the chunk to decompress.
+  @param[in]  Scratch     A scratch buffer of Context->ScratchSize bytes that is
+                          not used by any other processor.
+
+  @retval RETURN_SUCCESS            The chunk was decompressed.
+  @retval RETURN_INVALID_PARAMETER  The chunk is corrupted.
+**/
+RETURN_STATUS
+LzmaChunkedDecodeChunk (
+  IN CONST LZMA_CHUNKED_CONTEXT  *Context,
+  IN UINT32                      ChunkIndex,
+  IN VOID                        *Scratch
+  )
+{
+  CONST UINT32   *Offsets;
+  UINT32         ChunkStart;
+  UINT32         ChunkEnd;
+  UINT32         ExpectedSize;
+  UINT32         DecodedSize;
+  UINT32         ScratchSize;
+  RETURN_STATUS  Status;
+
+  Offsets    = (CONST UINT32 *)(Context->Header + 1);
+  ChunkStart = Offsets[ChunkIndex];
+  if (ChunkIndex + 1 < Context->Header->ChunkCount) {
+    ChunkEnd     = Offsets[ChunkIndex + 1];
+    ExpectedSize = Context->Header->ChunkSize;
+  } else {
+    ChunkEnd     = Context->SourceSize;
+    ExpectedSize = Context->Header->UncompressedSize - ChunkIndex * Context->Header->ChunkSize;
+  }
+
+  //
+  // Each chunk must decode to exactly its share of the output, otherwise it
+  // would write over its neighbours.
+  //
+  Status = LzmaUefiDecompressGetInfo (
+             (UINT8 *)Context->Header + ChunkStart,
+             ChunkEnd - ChunkStart,
+             &DecodedSize,
+             &ScratchSize
+             );
+  if (RETURN_ERROR (Status) || (DecodedSize != ExpectedSize) || (ScratchSize > Context->ScratchSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return LzmaUefiDecompress (
+           (UINT8 *)Context->Header + ChunkStart,
+           ChunkEnd - ChunkStart,
+           Context->Destination + (UINTN)ChunkIndex * Context->Header->ChunkSize,
+           Scratch
+           );
+}
+
+/**
+  Examines a chunked LZMA GUIDed section and returns the size of the decoded
+  buffer and the size of the scratch buffer required to decode it.
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  UINT32                     DataSize;
+  UINT32                     DecodedSize;
+  UINT32                     ScratchSize;
+  RETURN_STATUS              Status;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  Status = LzmaChunkedGetHeader (InputSection, &Header, &DataSize, SectionAttribute);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // All chunks use the same decoder, so the first one tells the scratch size
+  // needed by each decoder running at the same time.
+  //
+  Status = LzmaUefiDecompressGetInfo (
+             (UINT8 *)Header + ((CONST UINT32 *)(Header + 1))[0],
+             LZMA_CHUNK_HEADER_SIZE,
+             &DecodedSize,
+             &ScratchSize
+             );
+  if (RETURN_ERROR (Status)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *OutputBufferSize  = Header->UncompressedSize;
+  *ScratchBufferSize = ScratchSize * MIN (Header->ChunkCount, LzmaChunkedGetMaxDecoders ());
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress a chunked LZMA GUIDed section into a caller allocated output buffer.
+
+  The chunks are handed to LzmaChunkedDecodeParallel() first, and decoded one
+  after the other on the calling processor if no other processor can help.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer of the size returned by
+                            LzmaChunkedGuidedSectionGetInfo().
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  LZMA_CHUNKED_CONTEXT  Context;
+  UINT32                DecodedSize;
+  UINT32                Index;
+  RETURN_STATUS         Status;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  ZeroMem (&Context, sizeof (Context));
+  Status = LzmaChunkedGetHeader (InputSection, &Context.Header, &Context.SourceSize, NULL);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaUefiDecompressGetInfo (
+             (UINT8 *)Context.Header + ((CONST UINT32 *)(Context.Header + 1))[0],
+             LZMA_CHUNK_HEADER_SIZE,
+             &DecodedSize,
+             &Context.ScratchSize
+             );
+  if (RETURN_ERROR (Status)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Authentication is set to Zero, which may be ignored.
+  //
+  *AuthenticationStatus = 0;
+
+  Context.Destination  = *OutputBuffer;
+  Context.Scratch      = ScratchBuffer;
+  Context.ScratchCount = MIN (Context.Header->ChunkCount, LzmaChunkedGetMaxDecoders ());
+  Context.Status       = RETURN_SUCCESS;
+
+  if (Context.ScratchCount > 1) {
+    Status = LzmaChunkedDecodeParallel (&Context);
+    if (Status != RETURN_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
+  for (Index = 0; Index < Context.Header->ChunkCount; Index++) {
+    Status = LzmaChunkedDecodeChunk (&Context, Index, ScratchBuffer);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
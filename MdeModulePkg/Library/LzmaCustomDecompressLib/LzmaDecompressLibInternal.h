@@ -91,4 +91,112 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+///
+/// State shared by the processors decoding the chunks of a
+/// LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID section.
+///
+typedef struct {
+  CONST LZMA_CHUNKED_HEADER    *Header;
+  UINT32                       SourceSize;
+  UINT8                        *Destination;
+  UINT8                        *Scratch;
+  UINT32                       ScratchSize;
+  UINT32                       ScratchCount;
+  volatile UINT32              NextChunk;
+  volatile UINT32              NextScratch;
+  volatile RETURN_STATUS       Status;
+} LZMA_CHUNKED_CONTEXT;
+
+/**
+  Decompress a single chunk of a chunked LZMA section.
+
+  This function only touches the destination range and the scratch buffer
+  owned by the chunk, so it may run on several processors at once.
+
+  @param[in]  Context     The decode context of the section.
+  @param[in]  ChunkIndex  The index of the chunk to decompress.
+  @param[in]  Scratch     A scratch buffer of Context->ScratchSize bytes that is
+                          not used by any other processor.
+
+  @retval RETURN_SUCCESS            The chunk was decompressed.
+  @retval RETURN_INVALID_PARAMETER  The chunk is corrupted.
+**/
+RETURN_STATUS
+LzmaChunkedDecodeChunk (
+  IN CONST LZMA_CHUNKED_CONTEXT  *Context,
+  IN UINT32                      ChunkIndex,
+  IN VOID                        *Scratch
+  );
+
+/**
+  Return the maximum number of chunks that this library instance may decode
+  at the same time. One scratch buffer is requested for each of them.
+
+  @return The number of chunks that can be in flight at once.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  );
+
+/**
+  Decompress all chunks of a chunked LZMA section in parallel.
+
+  @param[in, out]  Context  The decode context of the section.
+
+  @retval RETURN_SUCCESS            All chunks were decompressed.
+  @retval RETURN_UNSUPPORTED        No other processor is available; the
+                                    caller must decode the chunks itself.
+  @retval RETURN_INVALID_PARAMETER  A chunk is corrupted.
+**/
+RETURN_STATUS
+LzmaChunkedDecodeParallel (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  );
+
+/**
+  Examines a chunked LZMA GUIDed section and returns the size of the decoded
+  buffer and the size of the scratch buffer required to decode it.
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  );
+
+/**
+  Decompress a chunked LZMA GUIDed section into a caller allocated output buffer.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer of the size returned by
+                            LzmaChunkedGuidedSectionGetInfo().
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  );
+
 #endif
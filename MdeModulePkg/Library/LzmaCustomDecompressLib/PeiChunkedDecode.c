@@ -0,0 +1,147 @@
+/** @file
+  Chunked LZMA decode hooks for PEI. The chunks are spread over the APs with
+  the PEI MP Services PPI when it has been installed.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Ppi/MpServices.h>
+
+//
+// Upper bound of the chunks decoded at the same time. Each of them needs its
+// own scratch buffer, which the caller allocates from permanent memory.
+//
+#define LZMA_CHUNKED_MAX_DECODERS  16
+
+/**
+  Return the maximum number of chunks that this library instance may decode
+  at the same time. One scratch buffer is requested for each of them.
+
+  @return The number of chunks that can be in flight at once.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  )
+{
+  return LZMA_CHUNKED_MAX_DECODERS;
+}
+
+/**
+  Claim and decode chunks until none is left or a chunk failed to decode.
+
+  This is the procedure run on every AP. It picks a scratch buffer that is
+  owned by this processor for the whole run, then takes chunks from the
+  shared counter. Processors beyond the number of scratch buffers return
+  without doing anything.
+
+  @param[in, out]  Buffer  The LZMA_CHUNKED_CONTEXT of the section.
+**/
+STATIC
+VOID
+EFIAPI
+LzmaChunkedDecodeWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNKED_CONTEXT  *Context;
+  UINT32                ScratchIndex;
+  UINT32                ChunkIndex;
+  RETURN_STATUS         Status;
+
+  Context      = (LZMA_CHUNKED_CONTEXT *)Buffer;
+  ScratchIndex = InterlockedIncrement (&Context->NextScratch) - 1;
+  if (ScratchIndex >= Context->ScratchCount) {
+    return;
+  }
+
+  while (!RETURN_ERROR (Context->Status)) {
+    ChunkIndex = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (ChunkIndex >= Context->Header->ChunkCount) {
+      break;
+    }
+
+    Status = LzmaChunkedDecodeChunk (
+               Context,
+               ChunkIndex,
+               Context->Scratch + (UINTN)ScratchIndex * Context->ScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      Context->Status = Status;
+    }
+  }
+}
+
+/**
+  Decompress all chunks of a chunked LZMA section in parallel.
+
+  The PEI StartupAllAPs() service blocks the BSP until all APs are done, so
+  the BSP only decodes the chunks the APs did not claim, which are all of
+  them when the APs could not be started.
+
+  @param[in, out]  Context  The decode context of the section.
+
+  @retval RETURN_SUCCESS            All chunks were decompressed.
+  @retval RETURN_UNSUPPORTED        The PEI MP Services PPI is not available,
+                                    or there is no enabled AP.
+  @retval RETURN_INVALID_PARAMETER  A chunk is corrupted.
+**/
+RETURN_STATUS
+LzmaChunkedDecodeParallel (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  )
+{
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  CONST EFI_PEI_SERVICES   **PeiServices;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+  EFI_STATUS               Status;
+
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiMpServicesPpiGuid,
+             0,
+             NULL,
+             (VOID **)&MpServices
+             );
+  if (EFI_ERROR (Status)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  PeiServices = GetPeiServicesTablePointer ();
+  Status      = MpServices->GetNumberOfProcessors (
+                              PeiServices,
+                              MpServices,
+                              &NumberOfProcessors,
+                              &NumberOfEnabledProcessors
+                              );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Status = MpServices->StartupAllAPs (
+                         PeiServices,
+                         MpServices,
+                         LzmaChunkedDecodeWorker,
+                         FALSE,
+                         0,
+                         Context
+                         );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: StartupAllAPs - %r, decoding on the BSP\n", __func__, Status));
+  }
+
+  //
+  // The APs have all returned, so the first scratch buffer is free again.
+  //
+  Context->NextScratch  = 0;
+  Context->ScratchCount = 1;
+  LzmaChunkedDecodeWorker (Context);
+
+  return Context->Status;
+}
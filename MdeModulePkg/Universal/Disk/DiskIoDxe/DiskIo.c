@@ -186,6 +186,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  DiskIoCacheInit (Instance);
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -217,6 +219,7 @@ ErrorExit:
     }
 
     if (Instance != NULL) {
+      DiskIoCacheFree (Instance);
       FreePool (Instance);
     }
 
@@ -325,6 +328,7 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    DiskIoCacheFree (Instance);
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -353,6 +357,31 @@ DiskIoDriverBindingStop (
   return Status;
 }
 
+/**
+  Return the number of bytes the BlockIo request of the sub task transfers.
+
+  The request covers all the blocks touched by the sub task, which are several
+  blocks only for a sub task that is staged through a working buffer.
+
+  @param Subtask      Subtask.
+  @param BlockSize    The block size of the media.
+
+  @return The transfer size in bytes.
+**/
+STATIC
+UINTN
+DiskIoSubtaskTransferLength (
+  IN DISK_IO_SUBTASK  *Subtask,
+  IN UINT32           BlockSize
+  )
+{
+  if (Subtask->Length == 0) {
+    return 0;
+  }
+
+  return (Subtask->Offset + Subtask->Length + BlockSize - 1) / BlockSize * BlockSize;
+}
+
 /**
   Destroy the sub task.
 
@@ -382,9 +411,7 @@ DiskIoDestroySubtask (
     if (Subtask->WorkingBuffer != NULL) {
       FreeAlignedPages (
         Subtask->WorkingBuffer,
-        Subtask->Length < Instance->BlockIo->Media->BlockSize
-        ? EFI_SIZE_TO_PAGES (Instance->BlockIo->Media->BlockSize)
-        : EFI_SIZE_TO_PAGES (Subtask->Length)
+        EFI_SIZE_TO_PAGES (DiskIoSubtaskTransferLength (Subtask, Instance->BlockIo->Media->BlockSize))
         );
     }
 
@@ -555,6 +582,7 @@ DiskIoCreateSubtaskList (
   UINT8            *BufferPtr;
   UINTN            Length;
   UINTN            DataBufferSize;
+  UINTN            TransferSize;
   DISK_IO_SUBTASK  *Subtask;
   VOID             *WorkingBuffer;
   LIST_ENTRY       *Link;
@@ -583,6 +611,29 @@ DiskIoCreateSubtaskList (
     return TRUE;
   }
 
+  //
+  // A non-blocking read that is not block aligned would be split into separate
+  // BlockIo2 requests for the partial first block, the aligned middle and the
+  // partial last block. Read all the blocks into one working buffer instead so
+  // that a single BlockIo2 request is issued.
+  //
+  TransferSize = (UnderRun + BufferSize + BlockSize - 1) / BlockSize * BlockSize;
+  if (!Write && !Blocking && (TransferSize > BlockSize) &&
+      ((UnderRun != 0) || (TransferSize != BufferSize)))
+  {
+    WorkingBuffer = AllocateAlignedPages (EFI_SIZE_TO_PAGES (TransferSize), IoAlign);
+    if (WorkingBuffer != NULL) {
+      Subtask = DiskIoCreateSubtask (FALSE, Lba, UnderRun, BufferSize, WorkingBuffer, BufferPtr, FALSE);
+      if (Subtask == NULL) {
+        FreeAlignedPages (WorkingBuffer, EFI_SIZE_TO_PAGES (TransferSize));
+        goto Done;
+      }
+
+      InsertTailList (Subtasks, &Subtask->Link);
+      return TRUE;
+    }
+  }
+
   if (UnderRun != 0) {
     Length = MIN (BlockSize - UnderRun, BufferSize);
     if (Blocking) {
@@ -866,6 +917,10 @@ DiskIo2ReadWriteDisk (
     while (!DiskIo2RemoveCompletedTask (Instance)) {
     }
 
+    if (!Write && DiskIoCacheRead (Instance, MediaId, Offset, BufferSize, Buffer, &Status)) {
+      return Status;
+    }
+
     SubtasksPtr = &Subtasks;
   } else {
     DiskIo2RemoveCompletedTask (Instance);
@@ -907,7 +962,7 @@ DiskIo2ReadWriteDisk (
     Subtask->Task   = Task;
     SubtaskBlocking = Subtask->Blocking;
 
-    ASSERT ((Subtask->Length % Media->BlockSize == 0) || (Subtask->Length < Media->BlockSize));
+    ASSERT ((Subtask->WorkingBuffer != NULL) || ((Subtask->Offset == 0) && (Subtask->Length % Media->BlockSize == 0)));
 
     if (Subtask->Write) {
       //
@@ -925,7 +980,7 @@ DiskIo2ReadWriteDisk (
                             BlockIo,
                             MediaId,
                             Subtask->Lba,
-                            (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
+                            DiskIoSubtaskTransferLength (Subtask, Media->BlockSize),
                             (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
                             );
       } else {
@@ -934,7 +989,7 @@ DiskIo2ReadWriteDisk (
                              MediaId,
                              Subtask->Lba,
                              &Subtask->BlockIo2Token,
-                             (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
+                             DiskIoSubtaskTransferLength (Subtask, Media->BlockSize),
                              (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
                              );
       }
@@ -947,7 +1002,7 @@ DiskIo2ReadWriteDisk (
                             BlockIo,
                             MediaId,
                             Subtask->Lba,
-                            (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
+                            DiskIoSubtaskTransferLength (Subtask, Media->BlockSize),
                             (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
                             );
         if (!EFI_ERROR (Status) && (Subtask->WorkingBuffer != NULL)) {
@@ -959,7 +1014,7 @@ DiskIo2ReadWriteDisk (
                              MediaId,
                              Subtask->Lba,
                              &Subtask->BlockIo2Token,
-                             (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
+                             DiskIoSubtaskTransferLength (Subtask, Media->BlockSize),
                              (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
                              );
       }
@@ -978,6 +1033,14 @@ DiskIo2ReadWriteDisk (
     }
   }
 
+  if (Write) {
+    //
+    // Non-blocking writes have not reached the media yet, and a failed write
+    // leaves the range in an unknown state, so drop the cached copies then.
+    //
+    DiskIoCacheUpdate (Instance, Offset, BufferSize, (Blocking && !EFI_ERROR (Status)) ? Buffer : NULL);
+  }
+
   SubtaskLockTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
   //
@@ -24,6 +24,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// Size in bytes of a block cache line. It is rounded down to a multiple of the
+// media block size, and is at least one block.
+//
+#define DISK_IO_CACHE_LINE_SIZE  SIZE_4KB
+
+#define DISK_IO_CACHE_LINE_SIGNATURE  SIGNATURE_32 ('d', 'i', 'c', 'l')
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    Link;                   /// < link in the LRU list, most recently used first
+  UINT64        LineNumber;             /// < byte offset of the line divided by the line size
+  UINTN         Length;                 /// < number of valid bytes, 0 if the line is free
+  UINT8         *Data;
+} DISK_IO_CACHE_LINE;
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                    Signature;
@@ -37,6 +52,19 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  //
+  // Block cache for blocking requests. CacheLineNum is 0 if the cache is disabled.
+  //
+  UINT32                    CacheLineNum;
+  UINT32                    CacheLineSize;
+  UINT32                    CacheMediaId;
+  DISK_IO_CACHE_LINE        *CacheLines;
+  UINT8                     *CacheBuffer;
+  LIST_ENTRY                CacheLruList;
+  UINT64                    CacheNextLine;      /// < line a sequential reader would miss next
+  UINT32                    CacheReadAhead;     /// < current read-ahead window in lines
+  UINT32                    CacheMaxReadAhead;
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -70,7 +98,7 @@ typedef struct {
   BOOLEAN                Write;
   UINT64                 Lba;
   UINT32                 Offset;
-  UINTN                  Length;
+  UINTN                  Length;                  /// < Offset + Length may span several blocks only when WorkingBuffer is not NULL
   UINT8                  *WorkingBuffer;          /// < NULL indicates using "Buffer" directly
   UINT8                  *Buffer;
   BOOLEAN                Blocking;
@@ -335,6 +363,79 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+//
+// Block cache functions
+//
+
+/**
+  Set up the block cache of a Disk IO instance.
+
+  The cache is only used for media that are neither removable nor logical
+  partitions, so partitions share the cache of the disk they belong to.
+  Failure to allocate the cache is not fatal; the instance then runs uncached.
+
+  @param  Instance  Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheInit (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Release the block cache of a Disk IO instance.
+
+  @param  Instance  Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Try to satisfy a blocking read through the block cache.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId     ID of the medium to be read.
+  @param  Offset      The starting byte offset to read from.
+  @param  BufferSize  The number of bytes to read.
+  @param  Buffer      A pointer to the destination buffer for the data.
+  @param  Status      Returns the status of the read if TRUE is returned.
+
+  @retval TRUE   The read was handled by the cache.
+  @retval FALSE  The read is not cacheable and must be issued to the device.
+
+**/
+BOOLEAN
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer,
+  OUT EFI_STATUS            *Status
+  );
+
+/**
+  Keep the block cache coherent with a write to the device.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset      The starting byte offset of the write.
+  @param  BufferSize  The number of bytes written.
+  @param  Buffer      The data that was written to the device, or NULL if the
+                      content of the range is unknown and the cached copies
+                      must be dropped.
+
+**/
+VOID
+DiskIoCacheUpdate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer OPTIONAL
+  );
+
 //
 // EFI Component Name Functions
 //
@@ -0,0 +1,409 @@
+/** @file
+  Block cache of the DiskIo driver.
+
+  Blocking reads are served from a small LRU cache of block aligned lines, so
+  that partition probing and file system metadata accesses that hit the same
+  sectors again and again do not go to the device each time. Misses that
+  continue a sequential stream read ahead with a window that doubles on every
+  sequential miss. Writes go straight to the device and update the cached
+  copies, so the cache never holds data that the device does not have.
+
+  The cache is only kept for the whole media of non-removable devices. The
+  partitions on top of such a disk access it through its Disk IO protocol,
+  so they all share one cache.
+
+Copyright (c) 2026, TianoCore contributors.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Set up the block cache of a Disk IO instance.
+
+  The cache is only used for media that are neither removable nor logical
+  partitions, so partitions share the cache of the disk they belong to.
+  Failure to allocate the cache is not fatal; the instance then runs uncached.
+
+  @param  Instance  Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheInit (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              LineNum;
+  UINT32              LineBlocks;
+  UINT32              Index;
+  DISK_IO_CACHE_LINE  *Line;
+
+  Instance->CacheLineNum = 0;
+  InitializeListHead (&Instance->CacheLruList);
+
+  Media   = Instance->BlockIo->Media;
+  LineNum = PcdGet32 (PcdDiskIoCacheLineNum);
+  if ((LineNum == 0) || Media->RemovableMedia || Media->LogicalPartition) {
+    return;
+  }
+
+  //
+  // Misses are read through SharedWorkingBuffer, so a line must fit into it.
+  //
+  LineBlocks = MAX (DISK_IO_CACHE_LINE_SIZE / Media->BlockSize, 1);
+  LineBlocks = MIN (LineBlocks, PcdGet32 (PcdDiskIoDataBufferBlockNum));
+  if (LineBlocks == 0) {
+    return;
+  }
+
+  Instance->CacheLines  = AllocateZeroPool (LineNum * sizeof (DISK_IO_CACHE_LINE));
+  Instance->CacheBuffer = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN)LineNum * LineBlocks * Media->BlockSize));
+  if ((Instance->CacheLines == NULL) || (Instance->CacheBuffer == NULL)) {
+    DEBUG ((DEBUG_WARN, "DiskIo: No enough memory for the block cache, running uncached\n"));
+    if (Instance->CacheLines != NULL) {
+      FreePool (Instance->CacheLines);
+      Instance->CacheLines = NULL;
+    }
+
+    if (Instance->CacheBuffer != NULL) {
+      FreePages (Instance->CacheBuffer, EFI_SIZE_TO_PAGES ((UINTN)LineNum * LineBlocks * Media->BlockSize));
+      Instance->CacheBuffer = NULL;
+    }
+
+    return;
+  }
+
+  Instance->CacheLineNum      = LineNum;
+  Instance->CacheLineSize     = LineBlocks * Media->BlockSize;
+  Instance->CacheMediaId      = Media->MediaId;
+  Instance->CacheNextLine     = MAX_UINT64;
+  Instance->CacheReadAhead    = 1;
+  Instance->CacheMaxReadAhead = MAX (MIN (PcdGet32 (PcdDiskIoDataBufferBlockNum) / LineBlocks, LineNum / 2), 1);
+
+  for (Index = 0; Index < LineNum; Index++) {
+    Line            = &Instance->CacheLines[Index];
+    Line->Signature = DISK_IO_CACHE_LINE_SIGNATURE;
+    Line->Data      = Instance->CacheBuffer + (UINTN)Index * Instance->CacheLineSize;
+    InsertTailList (&Instance->CacheLruList, &Line->Link);
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "DiskIo: Block cache of %d lines of %d bytes, read-ahead up to %d lines\n",
+    Instance->CacheLineNum,
+    Instance->CacheLineSize,
+    Instance->CacheMaxReadAhead
+    ));
+}
+
+/**
+  Release the block cache of a Disk IO instance.
+
+  @param  Instance  Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  if (Instance->CacheLineNum == 0) {
+    return;
+  }
+
+  FreePages (Instance->CacheBuffer, EFI_SIZE_TO_PAGES ((UINTN)Instance->CacheLineNum * Instance->CacheLineSize));
+  FreePool (Instance->CacheLines);
+  Instance->CacheBuffer  = NULL;
+  Instance->CacheLines   = NULL;
+  Instance->CacheLineNum = 0;
+}
+
+/**
+  Drop all the cached lines.
+
+  @param  Instance  Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+STATIC
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Instance->CacheLineNum; Index++) {
+    Instance->CacheLines[Index].Length = 0;
+  }
+
+  Instance->CacheNextLine  = MAX_UINT64;
+  Instance->CacheReadAhead = 1;
+}
+
+/**
+  Find a cached line.
+
+  Free lines are always kept behind the valid ones in the LRU list, so the
+  search stops at the first free line.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  LineNumber  The line to look for.
+
+  @return The cached line, or NULL if the line is not cached.
+
+**/
+STATIC
+DISK_IO_CACHE_LINE *
+DiskIoCacheLookup (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                LineNumber
+  )
+{
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *Line;
+
+  for (Link = GetFirstNode (&Instance->CacheLruList)
+       ; !IsNull (&Instance->CacheLruList, Link)
+       ; Link = GetNextNode (&Instance->CacheLruList, Link)
+       )
+  {
+    Line = CR (Link, DISK_IO_CACHE_LINE, Link, DISK_IO_CACHE_LINE_SIGNATURE);
+    if (Line->Length == 0) {
+      break;
+    }
+
+    if (Line->LineNumber == LineNumber) {
+      return Line;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Read a missing line from the device, together with the lines that follow it
+  when the misses look sequential.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId     ID of the medium to be read.
+  @param  LineNumber  The missing line.
+  @param  Line        Returns the cached line.
+
+  @retval EFI_SUCCESS  The line was read into the cache.
+  @retval others       The device failed to read the line.
+
+**/
+STATIC
+EFI_STATUS
+DiskIoCacheFill (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                LineNumber,
+  OUT DISK_IO_CACHE_LINE    **Line
+  )
+{
+  EFI_STATUS          Status;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              LineBlocks;
+  UINT32              Count;
+  UINT64              Lba;
+  UINTN               Length;
+  UINTN               Index;
+  DISK_IO_CACHE_LINE  *Victim;
+
+  Media      = Instance->BlockIo->Media;
+  LineBlocks = Instance->CacheLineSize / Media->BlockSize;
+
+  if (LineNumber == Instance->CacheNextLine) {
+    Instance->CacheReadAhead = MIN (Instance->CacheReadAhead * 2, Instance->CacheMaxReadAhead);
+  } else {
+    Instance->CacheReadAhead = 1;
+  }
+
+  //
+  // Stop the read-ahead at the first line that is cached already.
+  //
+  for (Count = 1; Count < Instance->CacheReadAhead; Count++) {
+    if (DiskIoCacheLookup (Instance, LineNumber + Count) != NULL) {
+      break;
+    }
+  }
+
+  Lba    = MultU64x32 (LineNumber, LineBlocks);
+  Length = (UINTN)MIN (MultU64x32 (Count, LineBlocks), Media->LastBlock + 1 - Lba) * Media->BlockSize;
+
+  Status = Instance->BlockIo->ReadBlocks (
+                                Instance->BlockIo,
+                                MediaId,
+                                Lba,
+                                Length,
+                                Instance->SharedWorkingBuffer
+                                );
+  if (EFI_ERROR (Status)) {
+    Instance->CacheNextLine  = MAX_UINT64;
+    Instance->CacheReadAhead = 1;
+    return Status;
+  }
+
+  //
+  // Recycle the least recently used lines. Insert the lines backwards so that
+  // the requested line ends up as the most recently used one.
+  //
+  Index = (Length + Instance->CacheLineSize - 1) / Instance->CacheLineSize;
+  while (Index-- > 0) {
+    Victim = CR (GetPreviousNode (&Instance->CacheLruList, &Instance->CacheLruList), DISK_IO_CACHE_LINE, Link, DISK_IO_CACHE_LINE_SIGNATURE);
+    RemoveEntryList (&Victim->Link);
+
+    Victim->LineNumber = LineNumber + Index;
+    Victim->Length     = MIN (Instance->CacheLineSize, Length - Index * Instance->CacheLineSize);
+    CopyMem (Victim->Data, Instance->SharedWorkingBuffer + Index * Instance->CacheLineSize, Victim->Length);
+    InsertHeadList (&Instance->CacheLruList, &Victim->Link);
+  }
+
+  Instance->CacheNextLine = LineNumber + Count;
+  *Line                   = Victim;
+  return EFI_SUCCESS;
+}
+
+/**
+  Try to satisfy a blocking read through the block cache.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId     ID of the medium to be read.
+  @param  Offset      The starting byte offset to read from.
+  @param  BufferSize  The number of bytes to read.
+  @param  Buffer      A pointer to the destination buffer for the data.
+  @param  Status      Returns the status of the read if TRUE is returned.
+
+  @retval TRUE   The read was handled by the cache.
+  @retval FALSE  The read is not cacheable and must be issued to the device.
+
+**/
+BOOLEAN
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer,
+  OUT EFI_STATUS            *Status
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT64              MediaSize;
+  UINT64              LineNumber;
+  UINT32              LineOffset;
+  UINTN               Length;
+  DISK_IO_CACHE_LINE  *Line;
+  EFI_TPL             OldTpl;
+
+  if ((Instance->CacheLineNum == 0) || (BufferSize == 0)) {
+    return FALSE;
+  }
+
+  Media = Instance->BlockIo->Media;
+  if (!Media->MediaPresent || (Media->MediaId != Instance->CacheMediaId)) {
+    DiskIoCacheInvalidate (Instance);
+    Instance->CacheMediaId = Media->MediaId;
+  }
+
+  //
+  // Leave reads of another medium and reads past the end of the media to the
+  // device so that it reports the error. Reads larger than the read-ahead
+  // window would only evict useful lines, so they bypass the cache.
+  //
+  MediaSize = MultU64x32 (Media->LastBlock + 1, Media->BlockSize);
+  if (!Media->MediaPresent || (MediaId != Media->MediaId) ||
+      (BufferSize > (UINTN)Instance->CacheMaxReadAhead * Instance->CacheLineSize) ||
+      (Offset > MediaSize) || (BufferSize > MediaSize - Offset))
+  {
+    return FALSE;
+  }
+
+  OldTpl  = gBS->RaiseTPL (TPL_CALLBACK);
+  *Status = EFI_SUCCESS;
+  while (BufferSize > 0) {
+    LineNumber = DivU64x32Remainder (Offset, Instance->CacheLineSize, &LineOffset);
+    Line       = DiskIoCacheLookup (Instance, LineNumber);
+    if (Line == NULL) {
+      *Status = DiskIoCacheFill (Instance, MediaId, LineNumber, &Line);
+      if (EFI_ERROR (*Status)) {
+        break;
+      }
+    } else {
+      RemoveEntryList (&Line->Link);
+      InsertHeadList (&Instance->CacheLruList, &Line->Link);
+    }
+
+    ASSERT (LineOffset < Line->Length);
+    Length = MIN (BufferSize, Line->Length - LineOffset);
+    CopyMem (Buffer, Line->Data + LineOffset, Length);
+
+    Buffer     += Length;
+    Offset     += Length;
+    BufferSize -= Length;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return TRUE;
+}
+
+/**
+  Keep the block cache coherent with a write to the device.
+
+  @param  Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset      The starting byte offset of the write.
+  @param  BufferSize  The number of bytes written.
+  @param  Buffer      The data that was written to the device, or NULL if the
+                      content of the range is unknown and the cached copies
+                      must be dropped.
+
+**/
+VOID
+DiskIoCacheUpdate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer OPTIONAL
+  )
+{
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *Line;
+  UINT64              LineStart;
+  UINT64              Start;
+  UINT64              End;
+  EFI_TPL             OldTpl;
+
+  if ((Instance->CacheLineNum == 0) || (BufferSize == 0)) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  for (Link = GetFirstNode (&Instance->CacheLruList); !IsNull (&Instance->CacheLruList, Link); ) {
+    Line = CR (Link, DISK_IO_CACHE_LINE, Link, DISK_IO_CACHE_LINE_SIGNATURE);
+    Link = GetNextNode (&Instance->CacheLruList, Link);
+    if (Line->Length == 0) {
+      break;
+    }
+
+    LineStart = MultU64x32 (Line->LineNumber, Instance->CacheLineSize);
+    if ((LineStart >= Offset + BufferSize) || (LineStart + Line->Length <= Offset)) {
+      continue;
+    }
+
+    if (Buffer == NULL) {
+      Line->Length = 0;
+      RemoveEntryList (&Line->Link);
+      InsertTailList (&Instance->CacheLruList, &Line->Link);
+      continue;
+    }
+
+    Start = MAX (LineStart, Offset);
+    End   = MIN (LineStart + Line->Length, Offset + BufferSize);
+    CopyMem (Line->Data + (UINTN)(Start - LineStart), Buffer + (UINTN)(Start - Offset), (UINTN)(End - Start));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
@@ -1590,6 +1590,7 @@ AdjustStringPackage (
   {
     StringPackage = CR (Link, HII_STRING_PACKAGE_INSTANCE, StringEntry, HII_STRING_PACKAGE_SIGNATURE);
     if (StringPackage->MaxStringId < MaxStringId) {
+      FreeStringIndex (StringPackage);
       OldBlockSize = StringPackage->StringPkgHdr->Header.Length - StringPackage->StringPkgHdr->HdrSize;
       //
       // Create SKIP2 EFI_HII_SIBT_SKIP2_BLOCKs to reserve the missing string IDs.
@@ -1758,6 +1759,7 @@ RemoveStringPackages (
 
     RemoveEntryList (&Package->StringEntry);
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
+    FreeStringIndex (Package);
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
     //
@@ -2076,6 +2078,7 @@ RemoveFontPackages (
       FreePool (Package->GlyphBlock);
     }
 
+    FreeGlyphIndex (Package->GlyphIndex);
     FreePool (Package->FontPkgHdr);
     //
     // Delete default character cell information
@@ -2589,6 +2592,7 @@ RemoveSimpleFontPackages (
     PackageList->PackageListHdr.PackageLength -= Package->SimpleFontPkgHdr->Header.Length;
     FreePool (Package->SimpleFontPkgHdr);
     FreePool (Package);
+    InvalidateSystemFontGlyphs (Private);
   }
 
   return EFI_SUCCESS;
@@ -3256,6 +3260,8 @@ AddPackages (
           return Status;
         }
 
+        InvalidateSystemFontGlyphs (Private);
+
         Status = InvokeRegisteredFunction (
                    Private,
                    NotifyType,
@@ -127,6 +127,274 @@ GetCell (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Look up a character in a glyph index.
+
+  This is a internal function.
+
+  @param  GlyphIndex              The glyph index.
+  @param  CharValue               Unicode character value.
+
+  @return The index entry of the character, or NULL if it is not indexed.
+
+**/
+STATIC
+HII_GLYPH_INDEX_ENTRY *
+LookupGlyphIndex (
+  IN HII_GLYPH_INDEX  *GlyphIndex,
+  IN CHAR16           CharValue
+  )
+{
+  HII_GLYPH_INDEX_ENTRY  *Page;
+
+  Page = GlyphIndex->Page[CharValue / HII_GLYPH_INDEX_PAGE_SIZE];
+  if ((Page == NULL) || (Page[CharValue % HII_GLYPH_INDEX_PAGE_SIZE].Glyph == NULL)) {
+    return NULL;
+  }
+
+  return &Page[CharValue % HII_GLYPH_INDEX_PAGE_SIZE];
+}
+
+/**
+  Add a character to a glyph index, unless it is indexed already.
+
+  This is a internal function.
+
+  @param  GlyphIndex              The glyph index.
+  @param  CharValue               Unicode character value.
+  @param  Glyph                   The glyph of the character.
+  @param  Cell                    The cell information of the glyph.
+
+  @retval EFI_SUCCESS             The character is indexed.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+STATIC
+EFI_STATUS
+InsertGlyphIndex (
+  IN HII_GLYPH_INDEX     *GlyphIndex,
+  IN CHAR16              CharValue,
+  IN UINT8               *Glyph,
+  IN EFI_HII_GLYPH_INFO  *Cell
+  )
+{
+  HII_GLYPH_INDEX_ENTRY  **Page;
+  HII_GLYPH_INDEX_ENTRY  *Entry;
+
+  Page = &GlyphIndex->Page[CharValue / HII_GLYPH_INDEX_PAGE_SIZE];
+  if (*Page == NULL) {
+    *Page = AllocateZeroPool (HII_GLYPH_INDEX_PAGE_SIZE * sizeof (HII_GLYPH_INDEX_ENTRY));
+    if (*Page == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Entry = &(*Page)[CharValue % HII_GLYPH_INDEX_PAGE_SIZE];
+  if (Entry->Glyph == NULL) {
+    Entry->Glyph = Glyph;
+    CopyMem (&Entry->Cell, Cell, sizeof (EFI_HII_GLYPH_INFO));
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free a glyph index and all of its pages.
+
+  @param  GlyphIndex              The glyph index to free, may be NULL.
+
+**/
+VOID
+FreeGlyphIndex (
+  IN HII_GLYPH_INDEX  *GlyphIndex
+  )
+{
+  UINTN  Index;
+
+  if (GlyphIndex == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < HII_GLYPH_INDEX_PAGE_COUNT; Index++) {
+    if (GlyphIndex->Page[Index] != NULL) {
+      FreePool (GlyphIndex->Page[Index]);
+    }
+  }
+
+  FreePool (GlyphIndex);
+}
+
+/**
+  Index the narrow and wide glyphs of all simple font packages.
+
+  When a character has several glyphs, the index keeps the one a linear search
+  of the database in list order would find first.
+
+  This is a internal function.
+
+  @param  Private                 HII database driver private data.
+
+  @return The glyph index, or NULL if the system is out of resources.
+
+**/
+STATIC
+HII_GLYPH_INDEX *
+BuildSimpleGlyphIndex (
+  IN HII_DATABASE_PRIVATE_DATA  *Private
+  )
+{
+  HII_GLYPH_INDEX                   *GlyphIndex;
+  HII_DATABASE_RECORD               *Node;
+  LIST_ENTRY                        *Link;
+  HII_SIMPLE_FONT_PACKAGE_INSTANCE  *SimpleFont;
+  LIST_ENTRY                        *Link1;
+  UINT16                            Index;
+  EFI_NARROW_GLYPH                  *NarrowPtr;
+  EFI_WIDE_GLYPH                    *WidePtr;
+  EFI_HII_GLYPH_INFO                Cell;
+  EFI_STATUS                        Status;
+
+  GlyphIndex = AllocateZeroPool (sizeof (HII_GLYPH_INDEX));
+  if (GlyphIndex == NULL) {
+    return NULL;
+  }
+
+  ZeroMem (&Cell, sizeof (EFI_HII_GLYPH_INFO));
+  Cell.Height = EFI_GLYPH_HEIGHT;
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
+         Link1 != &Node->PackageList->SimpleFontPkgHdr;
+         Link1 = Link1->ForwardLink
+         )
+    {
+      SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
+
+      NarrowPtr     = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR));
+      Cell.Width    = EFI_GLYPH_WIDTH;
+      Cell.AdvanceX = Cell.Width;
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
+        Status = InsertGlyphIndex (
+                   GlyphIndex,
+                   ReadUnaligned16 (&NarrowPtr[Index].UnicodeWeight),
+                   (UINT8 *)&NarrowPtr[Index],
+                   &Cell
+                   );
+        if (EFI_ERROR (Status)) {
+          FreeGlyphIndex (GlyphIndex);
+          return NULL;
+        }
+      }
+
+      WidePtr       = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
+      Cell.Width    = EFI_GLYPH_WIDTH * 2;
+      Cell.AdvanceX = Cell.Width;
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
+        Status = InsertGlyphIndex (
+                   GlyphIndex,
+                   ReadUnaligned16 (&WidePtr[Index].UnicodeWeight),
+                   (UINT8 *)&WidePtr[Index],
+                   &Cell
+                   );
+        if (EFI_ERROR (Status)) {
+          FreeGlyphIndex (GlyphIndex);
+          return NULL;
+        }
+      }
+    }
+  }
+
+  GlyphIndex->Complete = TRUE;
+  return GlyphIndex;
+}
+
+/**
+  Discard the system font glyph index and the rendered glyph cache.
+
+  This must be called whenever a simple font package is added or removed,
+  since either may change the glyph the system font uses for a character.
+
+  @param  Private                 HII database driver private data.
+
+**/
+VOID
+InvalidateSystemFontGlyphs (
+  IN HII_DATABASE_PRIVATE_DATA  *Private
+  )
+{
+  FreeGlyphIndex (Private->SimpleGlyphIndex);
+  Private->SimpleGlyphIndex = NULL;
+
+  if (Private->GlyphBltCache != NULL) {
+    FreePool (Private->GlyphBltCache);
+    Private->GlyphBltCache = NULL;
+  }
+}
+
+/**
+  Output the bitmap of a narrow or wide glyph of a simple font package.
+
+  This is a internal function.
+
+  @param  Glyph                   Points to the EFI_NARROW_GLYPH or EFI_WIDE_GLYPH.
+  @param  Wide                    TRUE if Glyph is an EFI_WIDE_GLYPH.
+  @param  GlyphBuffer             Buffer to store the retrieved bitmap data.
+  @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
+  @param  Attributes              If not NULL, output the glyph attributes if any.
+
+  @retval EFI_SUCCESS             Glyph bitmap outputted.
+  @retval EFI_OUT_OF_RESOURCES    Unable to allocate the output buffer GlyphBuffer.
+
+**/
+STATIC
+EFI_STATUS
+OutputSimpleGlyph (
+  IN  UINT8               *Glyph,
+  IN  BOOLEAN             Wide,
+  OUT UINT8               **GlyphBuffer,
+  OUT EFI_HII_GLYPH_INFO  *Cell,
+  OUT UINT8               *Attributes OPTIONAL
+  )
+{
+  EFI_NARROW_GLYPH  Narrow;
+  EFI_WIDE_GLYPH    WideGlyph;
+
+  if (!Wide) {
+    CopyMem (&Narrow, Glyph, sizeof (EFI_NARROW_GLYPH));
+    *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Cell->Width    = EFI_GLYPH_WIDTH;
+    Cell->Height   = EFI_GLYPH_HEIGHT;
+    Cell->AdvanceX = Cell->Width;
+    CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
+    if (Attributes != NULL) {
+      *Attributes = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
+    }
+  } else {
+    CopyMem (&WideGlyph, Glyph, sizeof (EFI_WIDE_GLYPH));
+    *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Cell->Width    = EFI_GLYPH_WIDTH * 2;
+    Cell->Height   = EFI_GLYPH_HEIGHT;
+    Cell->AdvanceX = Cell->Width;
+    CopyMem (*GlyphBuffer, WideGlyph.GlyphCol1, EFI_GLYPH_HEIGHT);
+    CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, WideGlyph.GlyphCol2, EFI_GLYPH_HEIGHT);
+    if (Attributes != NULL) {
+      *Attributes = (UINT8)(WideGlyph.Attributes | EFI_GLYPH_WIDE);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Convert the glyph for a single character into a bitmap.
 
@@ -162,12 +430,11 @@ GetGlyphBuffer (
   HII_SIMPLE_FONT_PACKAGE_INSTANCE  *SimpleFont;
   LIST_ENTRY                        *Link1;
   UINT16                            Index;
-  EFI_NARROW_GLYPH                  Narrow;
-  EFI_WIDE_GLYPH                    Wide;
   HII_GLOBAL_FONT_INFO              *GlobalFont;
   UINTN                             HeaderSize;
   EFI_NARROW_GLYPH                  *NarrowPtr;
   EFI_WIDE_GLYPH                    *WidePtr;
+  HII_GLYPH_INDEX_ENTRY             *Entry;
 
   if ((GlyphBuffer == NULL) || (Cell == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -196,6 +463,30 @@ GetGlyphBuffer (
 
     return FindGlyphBlock (GlobalFont->FontPackage, Char, GlyphBuffer, Cell, NULL);
   } else {
+    //
+    // Look the character up in the system font glyph index, which is rebuilt
+    // after simple font packages are added or removed. Only fall back to the
+    // linear search if the index cannot be built.
+    //
+    if (Private->SimpleGlyphIndex == NULL) {
+      Private->SimpleGlyphIndex = BuildSimpleGlyphIndex (Private);
+    }
+
+    if (Private->SimpleGlyphIndex != NULL) {
+      Entry = LookupGlyphIndex (Private->SimpleGlyphIndex, Char);
+      if (Entry == NULL) {
+        return EFI_NOT_FOUND;
+      }
+
+      return OutputSimpleGlyph (
+               Entry->Glyph,
+               (BOOLEAN)(Entry->Cell.Width != EFI_GLYPH_WIDTH),
+               GlyphBuffer,
+               Cell,
+               Attributes
+               );
+    }
+
     HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
 
     for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
@@ -211,22 +502,8 @@ GetGlyphBuffer (
         //
         NarrowPtr = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + HeaderSize);
         for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
-          CopyMem (&Narrow, NarrowPtr + Index, sizeof (EFI_NARROW_GLYPH));
-          if (Narrow.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-
-            Cell->Width    = EFI_GLYPH_WIDTH;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
-            }
-
-            return EFI_SUCCESS;
+          if (ReadUnaligned16 (&NarrowPtr[Index].UnicodeWeight) == Char) {
+            return OutputSimpleGlyph ((UINT8 *)(NarrowPtr + Index), FALSE, GlyphBuffer, Cell, Attributes);
           }
         }
 
@@ -235,23 +512,8 @@ GetGlyphBuffer (
         //
         WidePtr = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
         for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
-          CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
-          if (Wide.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-
-            Cell->Width    = EFI_GLYPH_WIDTH * 2;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
-            CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Wide.Attributes | EFI_GLYPH_WIDE);
-            }
-
-            return EFI_SUCCESS;
+          if (ReadUnaligned16 (&WidePtr[Index].UnicodeWeight) == Char) {
+            return OutputSimpleGlyph ((UINT8 *)(WidePtr + Index), TRUE, GlyphBuffer, Cell, Attributes);
           }
         }
       }
@@ -577,6 +839,186 @@ GlyphToImage (
   }
 }
 
+/**
+  Draw one 8 x 19 column of a system font glyph from the rendered glyph cache,
+  rendering it into the cache first if it is not there yet.
+
+  This is a internal function.
+
+  @param  GlyphCache     The rendered glyph cache.
+  @param  Char           The character the glyph belongs to.
+  @param  Column         0 for a narrow glyph or the left half of a wide one,
+                         1 for the right half of a wide glyph.
+  @param  GlyphBuffer    Buffer points to bitmap data of the column.
+  @param  Foreground     The color of the "on" pixels in the glyph in the
+                         bitmap.
+  @param  Background     The color of the "off" pixels in the glyph in the
+                         bitmap.
+  @param  ImageWidth     Width of the whole image in pixels.
+  @param  Origin         On input, points to the origin of the to be
+                         displayed character, on output, points to the
+                         next glyph's origin.
+
+**/
+STATIC
+VOID
+CachedNarrowGlyphToBlt (
+  IN     HII_GLYPH_BLT_CACHE_ENTRY      *GlyphCache,
+  IN     CHAR16                         Char,
+  IN     UINT8                          Column,
+  IN     UINT8                          *GlyphBuffer,
+  IN     EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Foreground,
+  IN     EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Background,
+  IN     UINT16                         ImageWidth,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  **Origin
+  )
+{
+  HII_GLYPH_BLT_CACHE_ENTRY      *Entry;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Buffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *CellOrigin;
+  UINTN                          Hash;
+  UINT8                          Ypos;
+
+  Hash = ((UINTN)Char << 1) + Column +
+         (Foreground.Blue + Foreground.Green + Foreground.Red) * 31 +
+         (Background.Blue + Background.Green + Background.Red) * 131;
+  Entry = &GlyphCache[Hash % HII_GLYPH_BLT_CACHE_SIZE];
+
+  if (  !Entry->Valid
+     || (Entry->Char != Char)
+     || (Entry->Column != Column)
+     || (CompareMem (&Entry->Foreground, &Foreground, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)) != 0)
+     || (CompareMem (&Entry->Background, &Background, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)) != 0))
+  {
+    CellOrigin = Entry->Blt + EFI_GLYPH_HEIGHT * EFI_GLYPH_WIDTH;
+    NarrowGlyphToBlt (
+      GlyphBuffer,
+      Foreground,
+      Background,
+      EFI_GLYPH_WIDTH,
+      EFI_GLYPH_WIDTH,
+      EFI_GLYPH_HEIGHT,
+      FALSE,
+      &CellOrigin
+      );
+    Entry->Char   = Char;
+    Entry->Column = Column;
+    Entry->Valid  = TRUE;
+    CopyMem (&Entry->Foreground, &Foreground, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    CopyMem (&Entry->Background, &Background, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+  }
+
+  //
+  // Move position to the left-top corner of char.
+  //
+  Buffer = *Origin - EFI_GLYPH_HEIGHT * ImageWidth;
+  for (Ypos = 0; Ypos < EFI_GLYPH_HEIGHT; Ypos++) {
+    CopyMem (
+      Buffer + Ypos * ImageWidth,
+      Entry->Blt + Ypos * EFI_GLYPH_WIDTH,
+      EFI_GLYPH_WIDTH * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+      );
+  }
+
+  *Origin = *Origin + EFI_GLYPH_WIDTH;
+}
+
+/**
+  Convert bitmap data of the glyph to blt structure, through the rendered
+  glyph cache if possible.
+
+  Opaque narrow and wide glyphs of the system font that are not clipped are
+  copied from the cache. Everything else is drawn by GlyphToImage().
+
+  This is a internal function.
+
+  @param  Private                 HII database driver private data.
+  @param  FontInfo                The font of the glyph, NULL for the system font.
+  @param  Char                    The character the glyph belongs to.
+  @param  GlyphBuffer             Buffer points to bitmap data of glyph.
+  @param  Foreground              The color of the "on" pixels in the glyph in the
+                                  bitmap.
+  @param  Background              The color of the "off" pixels in the glyph in the
+                                  bitmap.
+  @param  ImageWidth              Width of the whole image in pixels.
+  @param  BaseLine                BaseLine in the line.
+  @param  RowWidth                The width of the text on the line, in pixels.
+  @param  RowHeight               The height of the line, in pixels.
+  @param  Transparent             If TRUE, the Background color is ignored and all
+                                  "off" pixels in the character's drawn will use the
+                                  pixel value from BltBuffer.
+  @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
+  @param  Attributes              The attribute of incoming glyph in GlyphBuffer.
+  @param  Origin                  On input, points to the origin of the to be
+                                  displayed character, on output, points to the
+                                  next glyph's origin.
+
+**/
+STATIC
+VOID
+CachedGlyphToImage (
+  IN     HII_DATABASE_PRIVATE_DATA      *Private,
+  IN     EFI_FONT_INFO                  *FontInfo,
+  IN     CHAR16                         Char,
+  IN     UINT8                          *GlyphBuffer,
+  IN     EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Foreground,
+  IN     EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Background,
+  IN     UINT16                         ImageWidth,
+  IN     UINT16                         BaseLine,
+  IN     UINTN                          RowWidth,
+  IN     UINTN                          RowHeight,
+  IN     BOOLEAN                        Transparent,
+  IN     CONST EFI_HII_GLYPH_INFO       *Cell,
+  IN     UINT8                          Attributes,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  **Origin
+  )
+{
+  if (  (FontInfo == NULL)
+     && (GlyphBuffer != NULL)
+     && !Transparent
+     && (RowWidth >= Cell->Width)
+     && (RowHeight >= EFI_GLYPH_HEIGHT)
+     && ((Attributes & (EFI_GLYPH_NON_SPACING | PROPORTIONAL_GLYPH)) == 0)
+     && ((Attributes & (EFI_GLYPH_WIDE | NARROW_GLYPH)) != 0))
+  {
+    if (Private->GlyphBltCache == NULL) {
+      Private->GlyphBltCache = AllocateZeroPool (HII_GLYPH_BLT_CACHE_SIZE * sizeof (HII_GLYPH_BLT_CACHE_ENTRY));
+    }
+
+    if (Private->GlyphBltCache != NULL) {
+      CachedNarrowGlyphToBlt (Private->GlyphBltCache, Char, 0, GlyphBuffer, Foreground, Background, ImageWidth, Origin);
+      if ((Attributes & EFI_GLYPH_WIDE) == EFI_GLYPH_WIDE) {
+        CachedNarrowGlyphToBlt (
+          Private->GlyphBltCache,
+          Char,
+          1,
+          GlyphBuffer + EFI_GLYPH_HEIGHT,
+          Foreground,
+          Background,
+          ImageWidth,
+          Origin
+          );
+      }
+
+      return;
+    }
+  }
+
+  GlyphToImage (
+    GlyphBuffer,
+    Foreground,
+    Background,
+    ImageWidth,
+    BaseLine,
+    RowWidth,
+    RowHeight,
+    Transparent,
+    Cell,
+    Attributes,
+    Origin
+    );
+}
+
 /**
   Write the output parameters of FindGlyphBlock().
 
@@ -633,6 +1075,175 @@ WriteOutputParam (
   return EFI_SUCCESS;
 }
 
+/**
+  Index the glyph blocks of a font package by character value.
+
+  The index is marked incomplete if a glyph block cannot be indexed, e.g. a
+  duplicate of a later character or a default glyph without default cell
+  information. Characters past such a block are looked up by FindGlyphBlock()
+  the slow way, so the result is the same either way.
+
+  This is a internal function.
+
+  @param  FontPackage             Hii font package instance.
+
+  @return The glyph index, or NULL if the system is out of resources.
+
+**/
+STATIC
+HII_GLYPH_INDEX *
+BuildGlyphBlockIndex (
+  IN HII_FONT_PACKAGE_INSTANCE  *FontPackage
+  )
+{
+  EFI_STATUS                 Status;
+  HII_GLYPH_INDEX            *GlyphIndex;
+  HII_GLYPH_INDEX_ENTRY      *Entry;
+  UINT8                      *BlockPtr;
+  UINT16                     CharCurrent;
+  UINT16                     CharValue;
+  UINT16                     Length16;
+  UINT32                     Length32;
+  EFI_HII_GIBT_GLYPHS_BLOCK  Glyphs;
+  UINTN                      BufferLen;
+  UINT16                     Index;
+  EFI_HII_GLYPH_INFO         LocalCell;
+
+  GlyphIndex = AllocateZeroPool (sizeof (HII_GLYPH_INDEX));
+  if (GlyphIndex == NULL) {
+    return NULL;
+  }
+
+  GlyphIndex->Complete = TRUE;
+  Status               = EFI_SUCCESS;
+  BlockPtr             = FontPackage->GlyphBlock;
+  CharCurrent          = 1;
+
+  while ((*BlockPtr != EFI_HII_GIBT_END) && !EFI_ERROR (Status)) {
+    switch (*BlockPtr) {
+      case EFI_HII_GIBT_DEFAULTS:
+        BlockPtr += sizeof (EFI_HII_GIBT_DEFAULTS_BLOCK);
+        break;
+
+      case EFI_HII_GIBT_DUPLICATE:
+        CopyMem (&CharValue, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), sizeof (CHAR16));
+        Entry = LookupGlyphIndex (GlyphIndex, CharValue);
+        if (Entry != NULL) {
+          Status = InsertGlyphIndex (GlyphIndex, CharCurrent, Entry->Glyph, &Entry->Cell);
+        } else {
+          GlyphIndex->Complete = FALSE;
+        }
+
+        CharCurrent++;
+        BlockPtr += sizeof (EFI_HII_GIBT_DUPLICATE_BLOCK);
+        break;
+
+      case EFI_HII_GIBT_EXT1:
+        BlockPtr += *(UINT8 *)((UINTN)BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK) + sizeof (UINT8));
+        break;
+      case EFI_HII_GIBT_EXT2:
+        CopyMem (
+          &Length16,
+          (UINT8 *)((UINTN)BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK) + sizeof (UINT8)),
+          sizeof (UINT16)
+          );
+        BlockPtr += Length16;
+        break;
+      case EFI_HII_GIBT_EXT4:
+        CopyMem (
+          &Length32,
+          (UINT8 *)((UINTN)BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK) + sizeof (UINT8)),
+          sizeof (UINT32)
+          );
+        BlockPtr += Length32;
+        break;
+
+      case EFI_HII_GIBT_GLYPH:
+        CopyMem (
+          &LocalCell,
+          BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK),
+          sizeof (EFI_HII_GLYPH_INFO)
+          );
+        BufferLen = BITMAP_LEN_1_BIT (LocalCell.Width, LocalCell.Height);
+        Status    = InsertGlyphIndex (
+                      GlyphIndex,
+                      CharCurrent,
+                      (UINT8 *)((UINTN)BlockPtr + sizeof (EFI_HII_GIBT_GLYPH_BLOCK) - sizeof (UINT8)),
+                      &LocalCell
+                      );
+        CharCurrent++;
+        BlockPtr += sizeof (EFI_HII_GIBT_GLYPH_BLOCK) - sizeof (UINT8) + BufferLen;
+        break;
+
+      case EFI_HII_GIBT_GLYPHS:
+        BlockPtr += sizeof (EFI_HII_GLYPH_BLOCK);
+        CopyMem (&Glyphs.Cell, BlockPtr, sizeof (EFI_HII_GLYPH_INFO));
+        BlockPtr += sizeof (EFI_HII_GLYPH_INFO);
+        CopyMem (&Glyphs.Count, BlockPtr, sizeof (UINT16));
+        BlockPtr += sizeof (UINT16);
+
+        BufferLen = BITMAP_LEN_1_BIT (Glyphs.Cell.Width, Glyphs.Cell.Height);
+        for (Index = 0; (Index < Glyphs.Count) && !EFI_ERROR (Status); Index++) {
+          Status    = InsertGlyphIndex (GlyphIndex, (CHAR16)(CharCurrent + Index), BlockPtr, &Glyphs.Cell);
+          BlockPtr += BufferLen;
+        }
+
+        CharCurrent = (UINT16)(CharCurrent + Glyphs.Count);
+        break;
+
+      case EFI_HII_GIBT_GLYPH_DEFAULT:
+        if (EFI_ERROR (GetCell (CharCurrent, &FontPackage->GlyphInfoList, &LocalCell))) {
+          GlyphIndex->Complete = FALSE;
+          return GlyphIndex;
+        }
+
+        BufferLen = BITMAP_LEN_1_BIT (LocalCell.Width, LocalCell.Height);
+        Status    = InsertGlyphIndex (GlyphIndex, CharCurrent, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), &LocalCell);
+        CharCurrent++;
+        BlockPtr += sizeof (EFI_HII_GLYPH_BLOCK) + BufferLen;
+        break;
+
+      case EFI_HII_GIBT_GLYPHS_DEFAULT:
+        CopyMem (&Length16, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), sizeof (UINT16));
+        if (EFI_ERROR (GetCell (CharCurrent, &FontPackage->GlyphInfoList, &LocalCell))) {
+          GlyphIndex->Complete = FALSE;
+          return GlyphIndex;
+        }
+
+        BufferLen = BITMAP_LEN_1_BIT (LocalCell.Width, LocalCell.Height);
+        BlockPtr += sizeof (EFI_HII_GIBT_GLYPHS_DEFAULT_BLOCK) - sizeof (UINT8);
+        for (Index = 0; (Index < Length16) && !EFI_ERROR (Status); Index++) {
+          Status    = InsertGlyphIndex (GlyphIndex, (CHAR16)(CharCurrent + Index), BlockPtr, &LocalCell);
+          BlockPtr += BufferLen;
+        }
+
+        CharCurrent = (UINT16)(CharCurrent + Length16);
+        break;
+
+      case EFI_HII_GIBT_SKIP1:
+        CharCurrent = (UINT16)(CharCurrent + (UINT16)(*(BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK))));
+        BlockPtr   += sizeof (EFI_HII_GIBT_SKIP1_BLOCK);
+        break;
+      case EFI_HII_GIBT_SKIP2:
+        CopyMem (&Length16, BlockPtr + sizeof (EFI_HII_GLYPH_BLOCK), sizeof (UINT16));
+        CharCurrent = (UINT16)(CharCurrent + Length16);
+        BlockPtr   += sizeof (EFI_HII_GIBT_SKIP2_BLOCK);
+        break;
+      default:
+        ASSERT (FALSE);
+        GlyphIndex->Complete = FALSE;
+        return GlyphIndex;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    FreeGlyphIndex (GlyphIndex);
+    return NULL;
+  }
+
+  return GlyphIndex;
+}
+
 /**
   Parse all glyph blocks to find a glyph block specified by CharValue.
   If CharValue = (CHAR16) (-1), collect all default character cell information
@@ -675,12 +1286,41 @@ FindGlyphBlock (
   EFI_HII_GLYPH_INFO         LocalCell;
   INT16                      MinOffsetY;
   UINT16                     BaseLine;
+  HII_GLYPH_INDEX_ENTRY      *Entry;
 
   ASSERT (FontPackage != NULL);
   ASSERT (FontPackage->Signature == HII_FONT_PACKAGE_SIGNATURE);
   BaseLine   = 0;
   MinOffsetY = 0;
 
+  if (CharValue != (CHAR16)(-1)) {
+    //
+    // Index the glyph blocks on the first lookup, so that later ones don't
+    // have to parse all blocks up to the character.
+    //
+    if (FontPackage->GlyphIndex == NULL) {
+      FontPackage->GlyphIndex = BuildGlyphBlockIndex (FontPackage);
+    }
+
+    if (FontPackage->GlyphIndex != NULL) {
+      Entry = LookupGlyphIndex (FontPackage->GlyphIndex, CharValue);
+      if (Entry != NULL) {
+        return WriteOutputParam (
+                 Entry->Glyph,
+                 BITMAP_LEN_1_BIT (Entry->Cell.Width, Entry->Cell.Height),
+                 &Entry->Cell,
+                 GlyphBuffer,
+                 Cell,
+                 GlyphBufferLen
+                 );
+      }
+
+      if (FontPackage->GlyphIndex->Complete) {
+        return EFI_NOT_FOUND;
+      }
+    }
+  }
+
   if (CharValue == (CHAR16)(-1)) {
     //
     // Collect the cell information specified in font package fixed header.
@@ -2149,7 +2789,10 @@ HiiStringToImage (
           //
           // Only BLT these character which have corresponding glyph in font database.
           //
-          GlyphToImage (
+          CachedGlyphToImage (
+            Private,
+            FontInfo,
+            StringPtr[Index1],
             GlyphBuf[Index1],
             Foreground,
             Background,
@@ -2213,7 +2856,10 @@ HiiStringToImage (
           //
           // Only BLT these character which have corresponding glyph in font database.
           //
-          GlyphToImage (
+          CachedGlyphToImage (
+            Private,
+            FontInfo,
+            StringPtr[Index1],
             GlyphBuf[Index1],
             Foreground,
             Background,
@@ -150,6 +150,17 @@ typedef struct {
 // String Package definitions
 //
 #define HII_STRING_PACKAGE_SIGNATURE  SIGNATURE_32 ('h','i','s','p')
+
+//
+// Location of a string found by FindStringBlock(). TextOffset is 0 for
+// strings that no search has passed yet.
+//
+typedef struct _HII_STRING_INDEX_ENTRY {
+  UINT32           BlockOffset;                        // offset of the string block in StringBlock
+  UINT32           TextOffset;                         // offset of the string text in the block
+  EFI_STRING_ID    StartStringId;                      // first string id of the block
+} HII_STRING_INDEX_ENTRY;
+
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
   UINTN                         Signature;
   EFI_HII_STRING_PACKAGE_HDR    *StringPkgHdr;
@@ -158,6 +169,8 @@ typedef struct _HII_STRING_PACKAGE_INSTANCE {
   LIST_ENTRY                    FontInfoList;          // local font info list
   UINT8                         FontId;
   EFI_STRING_ID                 MaxStringId;           // record StringId
+  HII_STRING_INDEX_ENTRY        *StringIndex;          // indexed by StringId, NULL until first lookup
+  UINTN                         StringIndexCount;
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -181,6 +194,42 @@ typedef struct _HII_SIMPLE_FONT_PACKAGE_INSTANCE {
   LIST_ENTRY                         SimpleFontEntry;
 } HII_SIMPLE_FONT_PACKAGE_INSTANCE;
 
+//
+// Glyph index definitions. A glyph index maps a character value to its glyph,
+// in pages of HII_GLYPH_INDEX_PAGE_SIZE characters allocated on demand.
+//
+#define HII_GLYPH_INDEX_PAGE_SIZE   256
+#define HII_GLYPH_INDEX_PAGE_COUNT  (0x10000 / HII_GLYPH_INDEX_PAGE_SIZE)
+
+typedef struct _HII_GLYPH_INDEX_ENTRY {
+  UINT8                 *Glyph;    // EFI_NARROW_GLYPH, EFI_WIDE_GLYPH or glyph bitmap
+  EFI_HII_GLYPH_INFO    Cell;
+} HII_GLYPH_INDEX_ENTRY;
+
+typedef struct _HII_GLYPH_INDEX {
+  //
+  // FALSE if not every glyph could be indexed, in which case a character
+  // that is missing from the index still has to be searched for.
+  //
+  BOOLEAN                  Complete;
+  HII_GLYPH_INDEX_ENTRY    *Page[HII_GLYPH_INDEX_PAGE_COUNT];
+} HII_GLYPH_INDEX;
+
+//
+// Rendered glyph cache definitions. Each entry holds one 8 x 19 column of a
+// system font glyph drawn with the given colors.
+//
+#define HII_GLYPH_BLT_CACHE_SIZE  512
+
+typedef struct _HII_GLYPH_BLT_CACHE_ENTRY {
+  CHAR16                           Char;
+  UINT8                            Column;
+  BOOLEAN                          Valid;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    Foreground;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    Background;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    Blt[EFI_GLYPH_WIDTH * EFI_GLYPH_HEIGHT];
+} HII_GLYPH_BLT_CACHE_ENTRY;
+
 //
 // Font Package definitions
 //
@@ -193,6 +242,7 @@ typedef struct _HII_FONT_PACKAGE_INSTANCE {
   UINT8                       *GlyphBlock;
   LIST_ENTRY                  FontEntry;
   LIST_ENTRY                  GlyphInfoList;
+  HII_GLYPH_INDEX             *GlyphIndex;  // built on first lookup
 } HII_FONT_PACKAGE_INSTANCE;
 
 #define HII_GLYPH_INFO_SIGNATURE  SIGNATURE_32 ('h','g','i','s')
@@ -319,6 +369,8 @@ typedef struct _HII_DATABASE_PRIVATE_DATA {
   UINTN                                  Attribute;    // default system color
   EFI_GUID                               CurrentLayoutGuid;
   EFI_HII_KEYBOARD_LAYOUT                *CurrentLayout;
+  HII_GLYPH_INDEX                        *SimpleGlyphIndex; // system font glyph index
+  HII_GLYPH_BLT_CACHE_ENTRY              *GlyphBltCache;    // rendered system font glyphs
 } HII_DATABASE_PRIVATE_DATA;
 
 #define HII_FONT_DATABASE_PRIVATE_DATA_FROM_THIS(a) \
@@ -535,6 +587,19 @@ FindStringBlock (
   OUT EFI_STRING_ID                *StartStringId OPTIONAL
   );
 
+/**
+  Discard the string index of a string package.
+
+  This must be called before the string blocks of the package are changed.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  );
+
 /**
   Parse all glyph blocks to find a glyph block specified by CharValue.
   If CharValue = (CHAR16) (-1), collect all default character cell information
@@ -565,6 +630,31 @@ FindGlyphBlock (
   OUT UINTN                      *GlyphBufferLen OPTIONAL
   );
 
+/**
+  Free a glyph index and all of its pages.
+
+  @param  GlyphIndex              The glyph index to free, may be NULL.
+
+**/
+VOID
+FreeGlyphIndex (
+  IN HII_GLYPH_INDEX  *GlyphIndex
+  );
+
+/**
+  Discard the system font glyph index and the rendered glyph cache.
+
+  This must be called whenever a simple font package is added or removed,
+  since either may change the glyph the system font uses for a character.
+
+  @param  Private                 HII database driver private data.
+
+**/
+VOID
+InvalidateSystemFontGlyphs (
+  IN HII_DATABASE_PRIVATE_DATA  *Private
+  );
+
 /**
   This function exports Form packages to a buffer.
   This is a internal function.
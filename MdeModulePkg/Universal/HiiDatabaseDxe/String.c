@@ -225,6 +225,61 @@ GetStringFontInfo (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Discard the string index of a string package.
+
+  This must be called before the string blocks of the package are changed.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex      = NULL;
+    StringPackage->StringIndexCount = 0;
+  }
+}
+
+/**
+  Remember where a string is, so that FindStringBlock() does not have to parse
+  the string blocks again to find it.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+  @param  StringId                The string's id.
+  @param  BlockHdr                The string block that contains the string.
+  @param  TextOffset              Offset, relative to BlockHdr, of the string text.
+  @param  StartStringId           The first string id of the block.
+
+**/
+STATIC
+VOID
+RecordStringIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN EFI_STRING_ID                StringId,
+  IN UINT8                        *BlockHdr,
+  IN UINTN                        TextOffset,
+  IN EFI_STRING_ID                StartStringId
+  )
+{
+  HII_STRING_INDEX_ENTRY  *Entry;
+
+  if ((StringPackage->StringIndex == NULL) || (StringId >= StringPackage->StringIndexCount)) {
+    return;
+  }
+
+  Entry                = &StringPackage->StringIndex[StringId];
+  Entry->BlockOffset   = (UINT32)(BlockHdr - StringPackage->StringBlock);
+  Entry->TextOffset    = (UINT32)TextOffset;
+  Entry->StartStringId = StartStringId;
+}
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -283,6 +338,9 @@ FindStringBlock (
   UINT32                   Length32;
   UINTN                    StringSize;
   CHAR16                   Zero;
+  EFI_STRING_ID            BlockStringId;
+  EFI_STRING_ID            DuplicateId;
+  HII_STRING_INDEX_ENTRY   *Entry;
 
   ASSERT (StringPackage != NULL);
   ASSERT (StringPackage->Signature == HII_STRING_PACKAGE_SIGNATURE);
@@ -295,6 +353,31 @@ FindStringBlock (
     if (StringId > StringPackage->MaxStringId) {
       return EFI_NOT_FOUND;
     }
+
+    //
+    // Every string that a search passes is recorded in the string index, so
+    // each string block is parsed once until the package is changed.
+    //
+    if (StringPackage->StringIndex == NULL) {
+      StringPackage->StringIndex = AllocateZeroPool ((StringPackage->MaxStringId + 1) * sizeof (HII_STRING_INDEX_ENTRY));
+      if (StringPackage->StringIndex != NULL) {
+        StringPackage->StringIndexCount = StringPackage->MaxStringId + 1;
+      }
+    }
+
+    if ((StringPackage->StringIndex != NULL) && (StringId < StringPackage->StringIndexCount)) {
+      Entry = &StringPackage->StringIndex[StringId];
+      if (Entry->TextOffset != 0) {
+        *BlockType        = StringPackage->StringBlock[Entry->BlockOffset];
+        *StringBlockAddr  = StringPackage->StringBlock + Entry->BlockOffset;
+        *StringTextOffset = Entry->TextOffset;
+        if (StartStringId != NULL) {
+          *StartStringId = Entry->StartStringId;
+        }
+
+        return EFI_SUCCESS;
+      }
+    }
   } else {
     ASSERT (Private != NULL && Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
     if ((StringId == 0) && (LastStringId != NULL)) {
@@ -312,11 +395,13 @@ FindStringBlock (
   BlockSize = 0;
   Offset    = 0;
   while (*BlockHdr != EFI_HII_SIBT_END) {
+    BlockStringId = CurrentStringId;
     switch (*BlockHdr) {
       case EFI_HII_SIBT_STRING_SCSU:
         Offset        = sizeof (EFI_HII_STRING_BLOCK);
         StringTextPtr = BlockHdr + Offset;
         BlockSize    += Offset + AsciiStrSize ((CHAR8 *)StringTextPtr);
+        RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, Offset, BlockStringId);
         CurrentStringId++;
         break;
 
@@ -324,6 +409,7 @@ FindStringBlock (
         Offset        = sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
         StringTextPtr = BlockHdr + Offset;
         BlockSize    += Offset + AsciiStrSize ((CHAR8 *)StringTextPtr);
+        RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, Offset, BlockStringId);
         CurrentStringId++;
         break;
 
@@ -334,6 +420,7 @@ FindStringBlock (
 
         for (Index = 0; Index < StringCount; Index++) {
           BlockSize += AsciiStrSize ((CHAR8 *)StringTextPtr);
+          RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, StringTextPtr - BlockHdr, BlockStringId);
           if (CurrentStringId == StringId) {
             ASSERT (BlockType != NULL && StringBlockAddr != NULL && StringTextOffset != NULL);
             *BlockType        = *BlockHdr;
@@ -359,6 +446,7 @@ FindStringBlock (
 
         for (Index = 0; Index < StringCount; Index++) {
           BlockSize += AsciiStrSize ((CHAR8 *)StringTextPtr);
+          RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, StringTextPtr - BlockHdr, BlockStringId);
           if (CurrentStringId == StringId) {
             ASSERT (BlockType != NULL && StringBlockAddr != NULL && StringTextOffset != NULL);
             *BlockType        = *BlockHdr;
@@ -382,6 +470,7 @@ FindStringBlock (
         //
         GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
         BlockSize += Offset + StringSize;
+        RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, Offset, BlockStringId);
         CurrentStringId++;
         break;
 
@@ -394,6 +483,7 @@ FindStringBlock (
         //
         GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
         BlockSize += Offset + StringSize;
+        RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, Offset, BlockStringId);
         CurrentStringId++;
         break;
 
@@ -405,6 +495,7 @@ FindStringBlock (
         for (Index = 0; Index < StringCount; Index++) {
           GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
           BlockSize += StringSize;
+          RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, StringTextPtr - BlockHdr, BlockStringId);
           if (CurrentStringId == StringId) {
             ASSERT (BlockType != NULL && StringBlockAddr != NULL && StringTextOffset != NULL);
             *BlockType        = *BlockHdr;
@@ -431,6 +522,7 @@ FindStringBlock (
         for (Index = 0; Index < StringCount; Index++) {
           GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
           BlockSize += StringSize;
+          RecordStringIndex (StringPackage, CurrentStringId, BlockHdr, StringTextPtr - BlockHdr, BlockStringId);
           if (CurrentStringId == StringId) {
             ASSERT (BlockType != NULL && StringBlockAddr != NULL && StringTextOffset != NULL);
             *BlockType        = *BlockHdr;
@@ -458,9 +550,42 @@ FindStringBlock (
             sizeof (EFI_STRING_ID)
             );
           ASSERT (StringId != CurrentStringId);
+          if ((StringPackage->StringIndex != NULL) &&
+              (StringId < StringPackage->StringIndexCount) &&
+              (StringPackage->StringIndex[StringId].TextOffset != 0))
+          {
+            Entry = &StringPackage->StringIndex[StringId];
+            CopyMem (&StringPackage->StringIndex[CurrentStringId], Entry, sizeof (HII_STRING_INDEX_ENTRY));
+            *BlockType        = StringPackage->StringBlock[Entry->BlockOffset];
+            *StringBlockAddr  = StringPackage->StringBlock + Entry->BlockOffset;
+            *StringTextOffset = Entry->TextOffset;
+            if (StartStringId != NULL) {
+              *StartStringId = Entry->StartStringId;
+            }
+
+            return EFI_SUCCESS;
+          }
+
           CurrentStringId = 1;
           BlockSize       = 0;
         } else {
+          //
+          // A duplicate of a string that is indexed already is found where
+          // that string is.
+          //
+          CopyMem (&DuplicateId, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (EFI_STRING_ID));
+          if ((StringPackage->StringIndex != NULL) &&
+              (DuplicateId < StringPackage->StringIndexCount) &&
+              (CurrentStringId < StringPackage->StringIndexCount) &&
+              (StringPackage->StringIndex[DuplicateId].TextOffset != 0))
+          {
+            CopyMem (
+              &StringPackage->StringIndex[CurrentStringId],
+              &StringPackage->StringIndex[DuplicateId],
+              sizeof (HII_STRING_INDEX_ENTRY)
+              );
+          }
+
           BlockSize += sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
           CurrentStringId++;
         }
@@ -925,6 +1050,10 @@ SetStringWorker (
              NULL,
              &StartStringId
              );
+  //
+  // The string blocks are about to change, so the string index goes stale.
+  //
+  FreeStringIndex (StringPackage);
   if (EFI_ERROR (Status) && ((BlockType == EFI_HII_SIBT_SKIP1) || (BlockType == EFI_HII_SIBT_SKIP2))) {
     Status = InsertLackStringBlock (
                StringPackage,
@@ -1236,6 +1365,7 @@ HiiNewString (
        )
   {
     StringPackage = CR (Link, HII_STRING_PACKAGE_INSTANCE, StringEntry, HII_STRING_PACKAGE_SIGNATURE);
+    FreeStringIndex (StringPackage);
     //
     // Create a string block and corresponding font block if exists, then append them
     // to the end of the string package.
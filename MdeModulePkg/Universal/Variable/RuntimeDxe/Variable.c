@@ -792,6 +792,14 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables of the reclaimed store have moved, so its index is rebuilt
+  // on the next lookup.
+  //
+  VariableStoreIndexReset (
+    &mVariableModuleGlobal->VariableGlobal.StoreIndex[IsVolatile ? VariableStoreTypeVolatile : VariableStoreTypeNv]
+    );
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -885,10 +893,12 @@ FindVariable (
     PtrTrack->EndPtr   = GetEndPointer (VariableStoreHeader[Type]);
     PtrTrack->Volatile = (BOOLEAN)(Type == VariableStoreTypeVolatile);
 
-    Status =  FindVariableEx (
+    Status =  FindVariableByIndex (
                 VariableName,
                 VendorGuid,
                 IgnoreRtCheck,
+                &Global->StoreIndex[Type],
+                VariableStoreHeader[Type],
                 PtrTrack,
                 mVariableModuleGlobal->VariableGlobal.AuthFormat
                 );
@@ -90,11 +90,48 @@ typedef struct {
   BOOLEAN            Volatile;
 } VARIABLE_POINTER_TRACK;
 
+///
+/// Sentinel for an empty bucket or the end of a chain in VARIABLE_STORE_INDEX.
+///
+#define VARIABLE_STORE_INDEX_NONE  MAX_UINT32
+
+///
+/// Initial number of variables a VARIABLE_STORE_INDEX is sized for.
+///
+#define VARIABLE_STORE_INDEX_INITIAL_CAPACITY  128
+
+///
+/// Written to the Reserved1 field of a runtime cache store header once that
+/// cache has been indexed. A flush from the MM variable driver that rewrites
+/// the cache from offset 0 (initial sync or reclaim) replaces the header and
+/// so drops the mark.
+///
+#define VARIABLE_STORE_INDEX_MARK  SIGNATURE_32 ('V', 'I', 'D', 'X')
+
+///
+/// Name and GUID hash index over the variables of one variable store.
+///
+/// Variables are indexed lazily, in store order, from the start of the store
+/// up to IndexedSize. Chains keep that order so a lookup sees the variables
+/// in the same sequence as a linear walk. Table holds, in one allocation,
+/// Head[BucketCount], Tail[BucketCount], Next[Capacity] and Offset[Capacity];
+/// Offset is relative to the start pointer of the store.
+///
+typedef struct {
+  VARIABLE_STORE_HEADER    *Store;
+  UINT32                   IndexedSize;
+  UINT32                   BucketCount;
+  UINT32                   Capacity;
+  UINT32                   Count;
+  UINT32                   *Table;
+} VARIABLE_STORE_INDEX;
+
 typedef struct {
   EFI_PHYSICAL_ADDRESS              HobVariableBase;
   EFI_PHYSICAL_ADDRESS              VolatileVariableBase;
   EFI_PHYSICAL_ADDRESS              NonVolatileVariableBase;
   VARIABLE_RUNTIME_CACHE_CONTEXT    VariableRuntimeCacheContext;
+  VARIABLE_STORE_INDEX              StoreIndex[VariableStoreTypeMax];
   EFI_LOCK                          VariableServicesLock;
   UINT32                            ReentrantState;
   BOOLEAN                           AuthFormat;
@@ -518,6 +518,317 @@ FindVariableEx (
   return (PtrTrack->CurrPtr  == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
 }
 
+/**
+  Hash a variable name and vendor GUID for the variable store index.
+
+  The name is hashed up to and including its NULL terminator, but never past
+  NameSize bytes, so a name stored in a variable store hashes the same as the
+  name string it is looked up with.
+
+  @param[in] VariableName       Pointer to the variable name.
+  @param[in] NameSize           Maximum size in bytes of the name to hash.
+  @param[in] VendorGuid         Pointer to the vendor GUID.
+
+  @return The 32-bit FNV-1a hash of the vendor GUID and the variable name.
+
+**/
+STATIC
+UINT32
+VariableStoreIndexHash (
+  IN CONST CHAR16    *VariableName,
+  IN UINTN           NameSize,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  CONST UINT8  *GuidBytes;
+  UINT32       Hash;
+  UINTN        Index;
+
+  Hash      = 0x811C9DC5;
+  GuidBytes = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ GuidBytes[Index]) * 0x01000193;
+  }
+
+  for (Index = 0; Index < NameSize / sizeof (CHAR16); Index++) {
+    Hash = (Hash ^ (UINT8)VariableName[Index]) * 0x01000193;
+    Hash = (Hash ^ (UINT8)(VariableName[Index] >> 8)) * 0x01000193;
+    if (VariableName[Index] == L'\0') {
+      break;
+    }
+  }
+
+  return Hash;
+}
+
+/**
+  Allocate the table of a variable store index for the given store, and leave
+  the index empty.
+
+  The table is only (re)allocated at boot time; at OS runtime the caller falls
+  back to a linear search of the store.
+
+  @param[in, out] Index         Pointer to the variable store index.
+  @param[in]      Store         Pointer to the variable store to be indexed.
+  @param[in]      Capacity      Number of variables the index can hold, a power of two.
+
+  @retval EFI_SUCCESS           The index table was allocated.
+  @retval EFI_UNSUPPORTED       At OS runtime, or no memory for the index table.
+
+**/
+STATIC
+EFI_STATUS
+VariableStoreIndexAllocate (
+  IN OUT VARIABLE_STORE_INDEX   *Index,
+  IN     VARIABLE_STORE_HEADER  *Store,
+  IN     UINT32                 Capacity
+  )
+{
+  UINT32  *Table;
+  UINT32  BucketCount;
+
+  if (AtRuntime ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  BucketCount = Capacity / 2;
+  Table       = AllocateRuntimePool ((2 * BucketCount + 2 * Capacity) * sizeof (UINT32));
+  if (Table == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Index->Table != NULL) {
+    FreePool (Index->Table);
+  }
+
+  Index->Store       = Store;
+  Index->BucketCount = BucketCount;
+  Index->Capacity    = Capacity;
+  Index->Table       = Table;
+  VariableStoreIndexReset (Index);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Empty a variable store index, so it is rebuilt from the start of its store on
+  the next lookup. This must be called whenever the store is rewritten rather
+  than appended to or having variable states updated in place, e.g. by Reclaim().
+
+  @param[in, out] Index         Pointer to the variable store index.
+
+**/
+VOID
+VariableStoreIndexReset (
+  IN OUT VARIABLE_STORE_INDEX  *Index
+  )
+{
+  Index->IndexedSize = 0;
+  Index->Count       = 0;
+  if (Index->Table != NULL) {
+    SetMem32 (Index->Table, Index->BucketCount * sizeof (UINT32), VARIABLE_STORE_INDEX_NONE);
+  }
+}
+
+/**
+  Add the variables written to a store since the last update to its index.
+
+  Only variables that are, or may still become, VAR_ADDED are indexed. A header
+  in the VAR_HEADER_VALID_ONLY state stops the update, as its name and state may
+  still be in the middle of being written, unless a later variable shows that
+  the write was abandoned.
+
+  @param[in, out] Index         Pointer to the variable store index.
+  @param[in]      PtrTrack      Start and end pointers of the indexed store.
+  @param[in]      AuthFormat    TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+VariableStoreIndexUpdate (
+  IN OUT VARIABLE_STORE_INDEX    *Index,
+  IN     VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *NextVariable;
+  UINT32           *Head;
+  UINT32           *Tail;
+  UINT32           *Next;
+  UINT32           *Offset;
+  UINT32           Bucket;
+  UINT32           Entry;
+  UINTN            NameSize;
+
+  Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Index->IndexedSize);
+  while (IsValidVariableHeader (Variable, PtrTrack->EndPtr)) {
+    NextVariable = GetNextVariablePtr (Variable, AuthFormat);
+
+    if (Variable->State == VAR_HEADER_VALID_ONLY) {
+      if (!IsValidVariableHeader (NextVariable, PtrTrack->EndPtr)) {
+        break;
+      }
+    } else if ((Variable->State == VAR_ADDED) ||
+               (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)))
+    {
+      NameSize = NameSizeOfVariable (Variable, AuthFormat);
+      if ((UINTN)GetVariableNamePtr (Variable, AuthFormat) + NameSize > (UINTN)PtrTrack->EndPtr) {
+        break;
+      }
+
+      if (Index->Count == Index->Capacity) {
+        //
+        // Grow the index and rebuild it from the start of the store.
+        //
+        if (EFI_ERROR (VariableStoreIndexAllocate (Index, Index->Store, Index->Capacity * 2))) {
+          break;
+        }
+
+        Variable = PtrTrack->StartPtr;
+        continue;
+      }
+
+      Head   = Index->Table;
+      Tail   = Head + Index->BucketCount;
+      Next   = Tail + Index->BucketCount;
+      Offset = Next + Index->Capacity;
+
+      Bucket = VariableStoreIndexHash (
+                 GetVariableNamePtr (Variable, AuthFormat),
+                 NameSize,
+                 GetVendorGuidPtr (Variable, AuthFormat)
+                 ) & (Index->BucketCount - 1);
+      Entry         = Index->Count++;
+      Offset[Entry] = (UINT32)((UINTN)Variable - (UINTN)PtrTrack->StartPtr);
+      Next[Entry]   = VARIABLE_STORE_INDEX_NONE;
+      if (Head[Bucket] == VARIABLE_STORE_INDEX_NONE) {
+        Head[Bucket] = Entry;
+      } else {
+        Next[Tail[Bucket]] = Entry;
+      }
+
+      Tail[Bucket] = Entry;
+    }
+
+    Variable = NextVariable;
+  }
+
+  Index->IndexedSize = (UINT32)((UINTN)Variable - (UINTN)PtrTrack->StartPtr);
+}
+
+/**
+  Find the variable in the specified variable store, using the name and GUID
+  hash index of the store.
+
+  This returns the same result as FindVariableEx(). The index is brought up to
+  date with the store first, and falls back to FindVariableEx() when it cannot
+  be allocated or when VariableName is an empty string.
+
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  Index               Pointer to the index of the variable store.
+  @param[in]       Store               Pointer to the variable store header.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableByIndex (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_STORE_INDEX    *Index,
+  IN     VARIABLE_STORE_HEADER   *Store,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  EFI_STATUS              Status;
+  VARIABLE_POINTER_TRACK  TailPtrTrack;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *InDeletedVariable;
+  UINT32                  *Head;
+  UINT32                  *Next;
+  UINT32                  *Offset;
+  UINT32                  Entry;
+
+  if (VariableName[0] == 0) {
+    return FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+  }
+
+  if ((Index->Store != Store) &&
+      EFI_ERROR (VariableStoreIndexAllocate (Index, Store, VARIABLE_STORE_INDEX_INITIAL_CAPACITY)))
+  {
+    return FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+  }
+
+  VariableStoreIndexUpdate (Index, PtrTrack, AuthFormat);
+
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  InDeletedVariable                = NULL;
+
+  Head   = Index->Table;
+  Next   = Head + 2 * Index->BucketCount;
+  Offset = Next + Index->Capacity;
+
+  Entry = Head[VariableStoreIndexHash (VariableName, MAX_UINTN, VendorGuid) & (Index->BucketCount - 1)];
+  for ( ; Entry != VARIABLE_STORE_INDEX_NONE; Entry = Next[Entry]) {
+    Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Offset[Entry]);
+    if ((Variable->State != VAR_ADDED) &&
+        (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)))
+    {
+      continue;
+    }
+
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+
+    if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSizeOfVariable (Variable, AuthFormat)) != 0))
+    {
+      continue;
+    }
+
+    if (Variable->State == VAR_ADDED) {
+      PtrTrack->CurrPtr                = Variable;
+      PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+      return EFI_SUCCESS;
+    }
+
+    InDeletedVariable = Variable;
+  }
+
+  //
+  // Anything past the indexed part of the store (a variable still being
+  // written, or more variables than the index could grow to hold) is searched
+  // linearly, as it follows every indexed variable in the store.
+  //
+  TailPtrTrack.StartPtr = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Index->IndexedSize);
+  TailPtrTrack.EndPtr   = PtrTrack->EndPtr;
+  Status                = FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, &TailPtrTrack, AuthFormat);
+  if (!EFI_ERROR (Status)) {
+    PtrTrack->CurrPtr = TailPtrTrack.CurrPtr;
+    if ((TailPtrTrack.CurrPtr->State == VAR_ADDED) && (TailPtrTrack.InDeletedTransitionPtr == NULL)) {
+      PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    } else {
+      PtrTrack->InDeletedTransitionPtr = TailPtrTrack.InDeletedTransitionPtr;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
 /**
   This code finds the next available variable.
 
@@ -280,6 +280,51 @@ FindVariableEx (
   IN     BOOLEAN                 AuthFormat
   );
 
+/**
+  Empty a variable store index, so it is rebuilt from the start of its store on
+  the next lookup. This must be called whenever the store is rewritten rather
+  than appended to or having variable states updated in place, e.g. by Reclaim().
+
+  @param[in, out] Index         Pointer to the variable store index.
+
+**/
+VOID
+VariableStoreIndexReset (
+  IN OUT VARIABLE_STORE_INDEX  *Index
+  );
+
+/**
+  Find the variable in the specified variable store, using the name and GUID
+  hash index of the store.
+
+  This returns the same result as FindVariableEx(). The index is brought up to
+  date with the store first, and falls back to FindVariableEx() when it cannot
+  be allocated or when VariableName is an empty string.
+
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  Index               Pointer to the index of the variable store.
+  @param[in]       Store               Pointer to the variable store header.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableByIndex (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_STORE_INDEX    *Index,
+  IN     VARIABLE_STORE_HEADER   *Store,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
 /**
   This code finds the next available variable.
 
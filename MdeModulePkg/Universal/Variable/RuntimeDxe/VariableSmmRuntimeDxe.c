@@ -59,6 +59,7 @@ EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
 VARIABLE_RUNTIME_CACHE_INFO     mVariableRtCacheInfo;
 BOOLEAN                         mIsRuntimeCacheEnabled = FALSE;
+VARIABLE_STORE_INDEX            mVariableRtCacheIndex[VariableStoreTypeMax];
 
 /**
   The logic to initialize the VariablePolicy engine is in its own file.
@@ -586,7 +587,25 @@ FindVariableInRuntimeCache (
       RtPtrTrack.EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
       RtPtrTrack.Volatile = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
 
-      Status = FindVariableEx (VariableName, VendorGuid, FALSE, &RtPtrTrack, mVariableAuthFormat);
+      //
+      // The MM variable driver rewrites a cache from offset 0, replacing the
+      // store header, when it syncs it in full after a reclaim. The index of
+      // the cache is only valid while the mark left in the header is there.
+      //
+      if (VariableStoreList[StoreType]->Reserved1 != VARIABLE_STORE_INDEX_MARK) {
+        VariableStoreIndexReset (&mVariableRtCacheIndex[StoreType]);
+        VariableStoreList[StoreType]->Reserved1 = VARIABLE_STORE_INDEX_MARK;
+      }
+
+      Status = FindVariableByIndex (
+                 VariableName,
+                 VendorGuid,
+                 FALSE,
+                 &mVariableRtCacheIndex[StoreType],
+                 VariableStoreList[StoreType],
+                 &RtPtrTrack,
+                 mVariableAuthFormat
+                 );
       if (!EFI_ERROR (Status)) {
         break;
       }
@@ -1342,12 +1361,18 @@ VariableAddressChangeEvent (
   IN VOID       *Context
   )
 {
+  UINTN  Index;
+
   EfiConvertPointer (0x0, (VOID **)&mVariableBuffer);
   EfiConvertPointer (0x0, (VOID **)&mMmCommunication2);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.CacheInfoFlagBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeVolatileCacheBuffer);
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheIndex[Index].Store);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheIndex[Index].Table);
+  }
 }
 
 /**
@@ -0,0 +1,64 @@
+;------------------------------------------------------------------------------
+;
+; InternalArmCrc32() for AArch64
+;
+; Copyright (c) 2026, TianoCore contributors.<BR>
+;
+; SPDX-License-Identifier: BSD-2-Clause-Patent
+;
+;------------------------------------------------------------------------------
+
+  EXPORT InternalArmCrc32
+  AREA BaseLib_LowLevel, CODE, READONLY
+
+;/**
+;  Updates a running CRC32 value with the Armv8 CRC32 instructions.
+;
+;  Bytes are consumed one at a time up to the first 8-byte boundary, so that
+;  the main loop does not rely on unaligned accesses, which fault while the
+;  MMU is off.
+;
+;  @param[in]  Crc     The running CRC32 value, before the final inversion.
+;  @param[in]  Buffer  A pointer to the data.
+;  @param[in]  Length  The number of bytes in Buffer.
+;
+;  @return The updated running CRC32 value.
+;
+;**/
+;UINT32
+;EFIAPI
+;InternalArmCrc32 (
+;  IN UINT32       Crc,
+;  IN CONST UINT8  *Buffer,
+;  IN UINTN        Length
+;  );
+;
+InternalArmCrc32
+Crc32Head
+  cbz     x2, Crc32Done
+  tst     x1, #7
+  b.eq    Crc32Body
+  ldrb    w3, [x1], #1
+  crc32b  w0, w0, w3
+  sub     x2, x2, #1
+  b       Crc32Head
+
+Crc32Body
+  cmp     x2, #8
+  b.lo    Crc32Tail
+  ldr     x3, [x1], #8
+  crc32x  w0, w0, x3
+  sub     x2, x2, #8
+  b       Crc32Body
+
+Crc32Tail
+  cbz     x2, Crc32Done
+  ldrb    w3, [x1], #1
+  crc32b  w0, w0, w3
+  sub     x2, x2, #1
+  b       Crc32Tail
+
+Crc32Done
+  ret
+
+  END
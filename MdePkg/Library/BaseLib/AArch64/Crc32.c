@@ -0,0 +1,41 @@
+/** @file
+  CRC32 computation using the Armv8 CRC32 instructions on AArch64.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+/**
+  Updates a running CRC32 value with the content of a buffer, using CPU
+  instructions that speed up the computation when the running CPU supports
+  them, and InternalCalculateCrc32() otherwise.
+
+  FEAT_CRC32 is mandatory from Armv8.1 on, but optional in Armv8.0, so it is
+  checked in ID_AA64ISAR0_EL1.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+InternalCalculateCrc32Arch (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINT64  Isar0;
+
+  Isar0 = ArmReadIdAA64Isar0Reg ();
+  if (((Isar0 >> ARM_ID_AA64ISAR0_EL1_CRC32_SHIFT) & ARM_ID_AA64ISAR0_EL1_CRC32_HAVE_CRC32_MASK) != 0) {
+    return InternalArmCrc32 (Crc, Buffer, Length);
+  }
+
+  return InternalCalculateCrc32 (Crc, Buffer, Length);
+}
@@ -553,6 +553,43 @@ InternalAsciiHexCharToUintn (
   IN      CHAR8  Char
   );
 
+/**
+  Updates a running CRC32 value with the content of a buffer, using the
+  portable slicing-by-8 implementation.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+InternalCalculateCrc32 (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Updates a running CRC32 value with the content of a buffer, using CPU
+  instructions that speed up the computation when the running CPU supports
+  them, and InternalCalculateCrc32() otherwise.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+InternalCalculateCrc32Arch (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
 //
 // Ia32 and x64 specific functions
 //
@@ -850,8 +887,57 @@ InternalX86RdRand64  (
   OUT     UINT64  *Rand
   );
 
+#if defined (MDE_CPU_X64)
+
+/**
+  Updates a running CRC32 value with PCLMULQDQ folding.
+
+  The caller must check that the CPU supports PCLMULQDQ.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data, aligned on a 16-byte boundary.
+  @param[in]  Length  The number of bytes in Buffer. It must be a multiple of
+                      16 and at least 64.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+EFIAPI
+InternalX86Crc32Pclmul (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+#endif
+
 #else
 
 #endif
 
+#if defined (MDE_CPU_AARCH64)
+
+/**
+  Updates a running CRC32 value with the Armv8 CRC32 instructions.
+
+  The caller must check that the CPU implements FEAT_CRC32.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+EFIAPI
+InternalArmCrc32 (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+#endif
+
 #endif
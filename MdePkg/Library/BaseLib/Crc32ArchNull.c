@@ -0,0 +1,31 @@
+/** @file
+  CRC32 computation for CPUs without an accelerated implementation.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+/**
+  Updates a running CRC32 value with the content of a buffer, using CPU
+  instructions that speed up the computation when the running CPU supports
+  them, and InternalCalculateCrc32() otherwise.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+InternalCalculateCrc32Arch (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  return InternalCalculateCrc32 (Crc, Buffer, Length);
+}
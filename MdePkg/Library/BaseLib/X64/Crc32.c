@@ -0,0 +1,66 @@
+/** @file
+  CRC32 computation using PCLMULQDQ on x64.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+#include <Register/Intel/Cpuid.h>
+
+//
+// CPUID is not free, and it exits to the hypervisor when running in a virtual
+// machine, so the PCLMULQDQ check is only done for buffers that are large
+// enough to pay for it. Small buffers such as table headers take the
+// slicing-by-8 path directly.
+//
+#define CRC32_PCLMUL_MIN_LENGTH  SIZE_1KB
+
+/**
+  Updates a running CRC32 value with the content of a buffer, using CPU
+  instructions that speed up the computation when the running CPU supports
+  them, and InternalCalculateCrc32() otherwise.
+
+  The x64 build of BaseLib already relies on SSE being enabled (see SetJump()),
+  so only PCLMULQDQ support has to be checked.
+
+  @param[in]  Crc     The running CRC32 value, before the final inversion.
+  @param[in]  Buffer  A pointer to the data.
+  @param[in]  Length  The number of bytes in Buffer.
+
+  @return The updated running CRC32 value.
+
+**/
+UINT32
+InternalCalculateCrc32Arch (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  CPUID_VERSION_INFO_ECX  Ecx;
+  UINTN                   Head;
+  UINTN                   Bulk;
+
+  if (Length >= CRC32_PCLMUL_MIN_LENGTH) {
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &Ecx.Uint32, NULL);
+    if (Ecx.Bits.PCLMULQDQ == 1) {
+      //
+      // The folding loop works on aligned 16-byte blocks. The unaligned head
+      // and the tail shorter than a block go through the table lookups.
+      //
+      Head    = (0 - (UINTN)Buffer) & 0xF;
+      Crc     = InternalCalculateCrc32 (Crc, Buffer, Head);
+      Buffer += Head;
+      Length -= Head;
+
+      Bulk    = Length & ~(UINTN)0xF;
+      Crc     = InternalX86Crc32Pclmul (Crc, Buffer, Bulk);
+      Buffer += Bulk;
+      Length -= Bulk;
+    }
+  }
+
+  return InternalCalculateCrc32 (Crc, Buffer, Length);
+}
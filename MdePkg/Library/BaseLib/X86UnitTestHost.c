@@ -71,6 +71,7 @@ UnitTestHostBaseLibAsmCpuid (
   RetEcx = 0;
   switch (Index) {
     case 1:
+      RetEcx |= BIT1;  /* PCLMULQDQ */
       RetEcx |= BIT30; /* RdRand */
       break;
   }
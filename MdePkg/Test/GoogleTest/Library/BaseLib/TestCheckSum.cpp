@@ -6,15 +6,89 @@
 **/
 
 #include <gtest/gtest.h>
+#include <vector>
 extern "C" {
   #include <Base.h>
   #include <Library/BaseLib.h>
 }
 
-// Precomputed crc32c and crc16-ansi for "hello" (without the null byte)
+// Precomputed crc32, crc32c and crc16-ansi for "hello" (without the null byte)
+constexpr STATIC UINT32  mHelloCrc32  = 0x3610A686;
 constexpr STATIC UINT32  mHelloCrc32c = 0x9A71BB4C;
 constexpr STATIC UINT16  mHelloCrc16  = 0x34F6;
 
+// Bit at a time CRC32 (ITU-T V.42), used as the reference implementation
+STATIC
+UINT32
+ReferenceCrc32 (
+  CONST UINT8  *Buffer,
+  UINTN        Length
+  )
+{
+  UINT32  Crc;
+  UINTN   Bit;
+
+  Crc = 0xFFFFFFFF;
+  while (Length-- != 0) {
+    Crc ^= *(Buffer++);
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (0xEDB88320 & (0 - (Crc & 1)));
+    }
+  }
+
+  return ~Crc;
+}
+
+// Deterministic pseudo random test data
+STATIC
+std::vector<UINT8>
+MakeCrcTestData (
+  UINTN  Length
+  )
+{
+  std::vector<UINT8>  Data (Length);
+  UINT32              Seed;
+
+  Seed = 0x12345678;
+  for (auto &Byte : Data) {
+    Seed = Seed * 1103515245 + 12345;
+    Byte = (UINT8)(Seed >> 16);
+  }
+
+  return Data;
+}
+
+TEST (Crc32, BasicCheck) {
+  // Note: The magic numbers below are precomputed checksums
+  EXPECT_EQ (CalculateCrc32 ((VOID *)"hello", 5), mHelloCrc32);
+  EXPECT_EQ (CalculateCrc32 ((VOID *)"123456789", 9), 0xCBF43926U);
+  EXPECT_EQ (CalculateCrc32 ((VOID *)"h", 1), 0x916B06E7U);
+
+  // Check if a checksum with no bytes correctly yields 0
+  EXPECT_EQ (CalculateCrc32 ((VOID *)"", 0), 0U);
+}
+
+TEST (Crc32, LengthsAndAlignments) {
+  // Cover every combination of unaligned head, 8-byte body and short tail,
+  // as well as buffers of 1KB or more, which take the PCLMULQDQ path on X64.
+  std::vector<UINT8>  Data;
+  UINTN               Offset;
+  UINTN               Length;
+
+  Data = MakeCrcTestData (SIZE_64KB + 64);
+  for (Offset = 0; Offset < 32; Offset++) {
+    for (Length = 0; Length < 300; Length++) {
+      ASSERT_EQ (CalculateCrc32 (&Data[Offset], Length), ReferenceCrc32 (&Data[Offset], Length))
+        << "Offset " << Offset << " Length " << Length;
+    }
+
+    for (Length = SIZE_1KB - 17; Length < SIZE_64KB; Length = Length * 3 + 5) {
+      ASSERT_EQ (CalculateCrc32 (&Data[Offset], Length), ReferenceCrc32 (&Data[Offset], Length))
+        << "Offset " << Offset << " Length " << Length;
+    }
+  }
+}
+
 TEST (Crc32c, BasicCheck) {
   // Note: The magic numbers below are precomputed checksums
   // Check for basic operation on even and odd numbers of bytes
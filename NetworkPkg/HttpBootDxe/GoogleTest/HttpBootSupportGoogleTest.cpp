@@ -0,0 +1,116 @@
+/** @file
+  Tests for the range download helpers in HttpBootSupport.c.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include "../HttpBootDxe.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define HTTP_BOOT_TEST_FILE_SIZE  10000000
+
+////////////////////////////////////////////////////////////////////////
+// HttpBootRangeCheckResponse Tests
+////////////////////////////////////////////////////////////////////////
+
+class HttpBootRangeCheckResponseTest : public ::testing::Test {
+protected:
+  EFI_HTTP_RESPONSE_DATA Response;
+  EFI_HTTP_HEADER Header;
+  EFI_HTTP_MESSAGE Message;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Message, sizeof (Message));
+    Response.StatusCode   = HTTP_STATUS_206_PARTIAL_CONTENT;
+    Header.FieldName      = (CHAR8 *)HTTP_HEADER_CONTENT_RANGE;
+    Header.FieldValue     = NULL;
+    Message.Data.Response = &Response;
+    Message.HeaderCount   = 1;
+    Message.Headers       = &Header;
+  }
+
+  EFI_STATUS
+  Check (
+    CONST CHAR8  *ContentRange,
+    UINTN        Start,
+    UINTN        End
+    )
+  {
+    Header.FieldValue = (CHAR8 *)ContentRange;
+    return HttpBootRangeCheckResponse (&Message, Start, End, HTTP_BOOT_TEST_FILE_SIZE);
+  }
+};
+
+// The first, a middle and the last range of the file.
+TEST_F (HttpBootRangeCheckResponseTest, RequestedRange) {
+  EXPECT_EQ (Check ("bytes 0-4194303/10000000", 0, 4194304), EFI_SUCCESS);
+  EXPECT_EQ (Check ("bytes 4194304-8388607/10000000", 4194304, 8388608), EFI_SUCCESS);
+  EXPECT_EQ (Check ("bytes 8388608-9999999/10000000", 8388608, 10000000), EFI_SUCCESS);
+}
+
+// A resumed range asks for the part of the range not received yet.
+TEST_F (HttpBootRangeCheckResponseTest, ResumedRange) {
+  EXPECT_EQ (Check ("bytes 4195000-8388607/10000000", 4195000, 8388608), EFI_SUCCESS);
+
+  //
+  // The server sent the whole range again.
+  //
+  EXPECT_EQ (Check ("bytes 4194304-8388607/10000000", 4195000, 8388608), EFI_UNSUPPORTED);
+}
+
+TEST_F (HttpBootRangeCheckResponseTest, WrongStart) {
+  EXPECT_EQ (Check ("bytes 1-4194303/10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0-4194303/10000000", 4194304, 8388608), EFI_UNSUPPORTED);
+}
+
+TEST_F (HttpBootRangeCheckResponseTest, WrongEnd) {
+  EXPECT_EQ (Check ("bytes 0-4194304/10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0-9999999/10000000", 0, 4194304), EFI_UNSUPPORTED);
+}
+
+// The file changed size on the server since its size was asked for.
+TEST_F (HttpBootRangeCheckResponseTest, WrongSize) {
+  EXPECT_EQ (Check ("bytes 0-4194303/10000001", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0-4194303/*", 0, 4194304), EFI_UNSUPPORTED);
+}
+
+// A server that ignores the Range header answers 200 with the whole file.
+TEST_F (HttpBootRangeCheckResponseTest, NotPartialContent) {
+  Response.StatusCode = HTTP_STATUS_200_OK;
+  EXPECT_EQ (Check ("bytes 0-4194303/10000000", 0, 4194304), EFI_UNSUPPORTED);
+
+  Message.Data.Response = NULL;
+  EXPECT_EQ (Check ("bytes 0-4194303/10000000", 0, 4194304), EFI_UNSUPPORTED);
+}
+
+TEST_F (HttpBootRangeCheckResponseTest, MissingHeader) {
+  Header.FieldName = (CHAR8 *)HTTP_HEADER_CONTENT_LENGTH;
+  EXPECT_EQ (Check ("4194304", 0, 4194304), EFI_UNSUPPORTED);
+
+  Message.HeaderCount = 0;
+  Message.Headers     = NULL;
+  EXPECT_EQ (HttpBootRangeCheckResponse (&Message, 0, 4194304, HTTP_BOOT_TEST_FILE_SIZE), EFI_UNSUPPORTED);
+}
+
+// The form a 416 response uses, and other malformed values.
+TEST_F (HttpBootRangeCheckResponseTest, Malformed) {
+  EXPECT_EQ (Check ("bytes */10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0-4194303", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0 4194303/10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes 0-4194303 10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("items 0-4194303/10000000", 0, 4194304), EFI_UNSUPPORTED);
+  EXPECT_EQ (Check ("bytes", 0, 4194304), EFI_UNSUPPORTED);
+}
@@ -597,17 +597,19 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance with the driver's station address.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to initialize.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
@@ -636,15 +638,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -902,131 +923,39 @@ HttpBootGetBootFileCallback (
 }
 
 /**
-  This function download the boot file by using UEFI HTTP protocol.
+  Build the HTTP request header list used to download the boot file.
 
-  @param[in]       Private         The pointer to the driver's private data.
-  @param[in]       HeaderOnly      Only request the response header, it could save a lot of time if
-                                   the caller only want to know the size of the requested file.
-  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
-                                   code of EFI_SUCCESS, the amount of data transferred to
-                                   Buffer. On output with a return code of EFI_BUFFER_TOO_SMALL,
-                                   the size of Buffer required to retrieve the requested file.
-  @param[out]      Buffer          The memory buffer to transfer the file to. IF Buffer is NULL,
-                                   then the size of the requested file is returned in
-                                   BufferSize.
-  @param[out]      ImageType       The image type of the downloaded file.
+  @param[in]    Private          The pointer to the driver's private data.
+  @param[in]    UseRange         Add a Range header, and an If-Match or If-Unmodified-Since
+                                 header when the first response carried a validator.
+  @param[in]    RangeStart       Offset of the first byte requested if UseRange is TRUE.
+  @param[in]    RangeEnd         Offset of the last byte requested if UseRange is TRUE.
+  @param[out]   HttpIoHeaderOut  The header list, to be freed with HttpIoFreeHeader().
 
-  @retval EFI_SUCCESS              The file was loaded.
-  @retval EFI_INVALID_PARAMETER    BufferSize is NULL or Buffer Size is not NULL but Buffer is NULL.
-  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
-  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to read the current directory entry.
-                                   BufferSize has been updated with the size needed to complete
-                                   the request.
-  @retval EFI_ACCESS_DENIED        The server needs to authenticate the client.
-  @retval EFI_NOT_READY            Data transfer has timed-out, call HttpBootGetBootFile again to resume
-                                   the download operation using HTTP Range headers.
-  @retval EFI_UNSUPPORTED          Some HTTP response header is not supported.
-  @retval Others                   Unexpected error happened.
+  @retval EFI_SUCCESS            The header list is built.
+  @retval EFI_OUT_OF_RESOURCES   Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED        The server asked for an unsupported authentication scheme.
+  @retval Others                 Unexpected error happened.
 
 **/
 EFI_STATUS
-HttpBootGetBootFile (
+HttpBootCreateRequestHeader (
   IN     HTTP_BOOT_PRIVATE_DATA  *Private,
-  IN     BOOLEAN                 HeaderOnly,
-  IN OUT UINTN                   *BufferSize,
-  OUT UINT8                      *Buffer,
-  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  IN     BOOLEAN                 UseRange,
+  IN     UINTN                   RangeStart,
+  IN     UINTN                   RangeEnd,
+  OUT    HTTP_IO_HEADER          **HttpIoHeaderOut
   )
 {
-  EFI_STATUS               Status;
-  EFI_HTTP_STATUS_CODE     StatusCode;
-  CHAR8                    *HostName;
-  EFI_HTTP_REQUEST_DATA    *RequestData;
-  HTTP_IO_RESPONSE_DATA    *ResponseData;
-  HTTP_IO_RESPONSE_DATA    ResponseBody;
-  HTTP_IO                  *HttpIo;
-  HTTP_IO_HEADER           *HttpIoHeader;
-  VOID                     *Parser;
-  HTTP_BOOT_CALLBACK_DATA  Context;
-  UINTN                    ContentLength;
-  HTTP_BOOT_CACHE_CONTENT  *Cache;
-  UINT8                    *Block;
-  UINTN                    UrlSize;
-  CHAR16                   *Url;
-  BOOLEAN                  IdentityMode;
-  UINTN                    ReceivedSize;
-  CHAR8                    BaseAuthValue[80];
-  EFI_HTTP_HEADER          *HttpHeader;
-  CHAR8                    *Data;
-  UINTN                    HeadersCount;
-  BOOLEAN                  ResumingOperation;
-  CHAR8                    *ContentRangeResponseValue;
-  CHAR8                    RangeValue[64];
-
-  ASSERT (Private != NULL);
-  ASSERT (Private->HttpCreated);
-
-  if ((BufferSize == NULL) || (ImageType == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  if ((*BufferSize != 0) && (Buffer == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // First, check whether we already cached the requested Uri.
-  //
-  UrlSize = AsciiStrSize (Private->BootFileUri);
-  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
-  if (Url == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
-  if (!HeaderOnly && (Buffer != NULL)) {
-    Status = HttpBootGetFileFromCache (Private, Url, BufferSize, Buffer, ImageType);
-    if (Status != EFI_NOT_FOUND) {
-      FreePool (Url);
-      return Status;
-    }
-  }
-
-  // Check if this is a previous download that has failed and need to be resumed
-  if ((!HeaderOnly) &&
-      (Private->PartialTransferredSize > 0) &&
-      (Private->BootFileSize == *BufferSize))
-  {
-    ResumingOperation = TRUE;
-  } else {
-    ResumingOperation = FALSE;
-  }
-
-  //
-  // Not found in cache, try to download it through HTTP.
-  //
-
-  //
-  // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
-  //
-  Cache = NULL;
-  if ((!HeaderOnly) && (*BufferSize == 0)) {
-    Cache = AllocateZeroPool (sizeof (HTTP_BOOT_CACHE_CONTENT));
-    if (Cache == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      goto ERROR_1;
-    }
-
-    Cache->ImageType = ImageTypeMax;
-    InitializeListHead (&Cache->EntityDataList);
-  }
-
-  //
-  // 2. Send HTTP request message.
-  //
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *HttpIoHeader;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+  CHAR8           RangeValue[64];
+  UINTN           HeadersCount;
 
   //
-  // 2.1 Build HTTP header for the request, 3 header is needed to download a boot file:
+  // 3 header is needed to download a boot file:
   //       Host
   //       Accept
   //       User-Agent
@@ -1039,7 +968,7 @@ HttpBootGetBootFile (
     HeadersCount++;
   }
 
-  if (ResumingOperation) {
+  if (UseRange) {
     HeadersCount++;
     if (Private->LastModifiedOrEtag) {
       HeadersCount++;
@@ -1049,8 +978,7 @@ HttpBootGetBootFile (
   HttpIoHeader = HttpIoCreateHeader (HeadersCount);
 
   if (HttpIoHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR_2;
+    return EFI_OUT_OF_RESOURCES;
   }
 
   //
@@ -1063,7 +991,7 @@ HttpBootGetBootFile (
                &HostName
                );
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ON_ERROR;
   }
 
   Status = HttpIoSetHeader (
@@ -1073,7 +1001,7 @@ HttpBootGetBootFile (
              );
   FreePool (HostName);
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ON_ERROR;
   }
 
   //
@@ -1085,7 +1013,7 @@ HttpBootGetBootFile (
              "*/*"
              );
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ON_ERROR;
   }
 
   //
@@ -1097,18 +1025,16 @@ HttpBootGetBootFile (
              HTTP_USER_AGENT_EFI_HTTP_BOOT
              );
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ON_ERROR;
   }
 
   //
   // Add HTTP header field 4: Authorization
   //
   if (Private->AuthData != NULL) {
-    ASSERT (HttpIoHeader->MaxHeaderCount == 4);
-
     if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
       Status = EFI_UNSUPPORTED;
-      goto ERROR_3;
+      goto ON_ERROR;
     }
 
     AsciiSPrint (
@@ -1125,37 +1051,27 @@ HttpBootGetBootFile (
                BaseAuthValue
                );
     if (EFI_ERROR (Status)) {
-      goto ERROR_3;
+      goto ON_ERROR;
     }
   }
 
   //
   // Add HTTP header field 5 (optional): Range
   //
-  if (ResumingOperation) {
-    // Resuming a failed download. Prepare the HTTP Range Header
-    Status = AsciiSPrint (
-               RangeValue,
-               sizeof (RangeValue),
-               "bytes=%lu-%lu",
-               Private->PartialTransferredSize,
-               Private->BootFileSize - 1
-               );
-    if (EFI_ERROR (Status)) {
-      goto ERROR_3;
-    }
+  if (UseRange) {
+    AsciiSPrint (
+      RangeValue,
+      sizeof (RangeValue),
+      "bytes=%lu-%lu",
+      (UINT64)RangeStart,
+      (UINT64)RangeEnd
+      );
 
     Status = HttpIoSetHeader (HttpIoHeader, "Range", RangeValue);
     if (EFI_ERROR (Status)) {
-      goto ERROR_3;
+      goto ON_ERROR;
     }
 
-    DEBUG (
-      (DEBUG_WARN | DEBUG_INFO,
-       "HttpBootGetBootFile: Resuming failed download. Range: %a\n",
-       RangeValue)
-      );
-
     //
     // Add HTTP header field 6 (optional): If-Match or If-Unmodified-Since
     //
@@ -1164,7 +1080,7 @@ HttpBootGetBootFile (
         // An ETag value starts with "
         DEBUG (
           (DEBUG_WARN | DEBUG_INFO,
-           "HttpBootGetBootFile: If-Match=%a\n",
+           "HttpBootCreateRequestHeader: If-Match=%a\n",
            Private->LastModifiedOrEtag)
           );
         // Add If-Match header with the ETag value got from the first request.
@@ -1172,7 +1088,7 @@ HttpBootGetBootFile (
       } else {
         DEBUG (
           (DEBUG_WARN | DEBUG_INFO,
-           "HttpBootGetBootFile: If-Unmodified-Since=%a\n",
+           "HttpBootCreateRequestHeader: If-Unmodified-Since=%a\n",
            Private->LastModifiedOrEtag)
           );
         // Add If-Unmodified-Since header with the timestamp value (Last-Modified) got from the first request.
@@ -1180,11 +1096,670 @@ HttpBootGetBootFile (
       }
 
       if (EFI_ERROR (Status)) {
-        goto ERROR_3;
+        goto ON_ERROR;
       }
     }
   }
 
+  *HttpIoHeaderOut = HttpIoHeader;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (HttpIoHeader);
+  return Status;
+}
+
+/**
+  Queue the GET request for the unfinished part of a range worker's range.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The boot file URL.
+  @param[in, out]  Worker          The range worker.
+
+  @retval EFI_SUCCESS              The request is queued.
+  @retval Others                   Failed to build or queue the request.
+
+**/
+EFI_STATUS
+HttpBootRangeSendRequest (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+
+  HttpIo = &Worker->HttpIo;
+
+  if (Worker->RequestHeader != NULL) {
+    HttpIoFreeHeader (Worker->RequestHeader);
+    Worker->RequestHeader = NULL;
+  }
+
+  Status = HttpBootCreateRequestHeader (
+             Private,
+             TRUE,
+             Worker->Start + Worker->Received,
+             Worker->End - 1,
+             &Worker->RequestHeader
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Worker->RequestData.Method = HttpMethodGet;
+  Worker->RequestData.Url    = Url;
+
+  HttpIo->ReqToken.Status                = EFI_NOT_READY;
+  HttpIo->ReqToken.Message->Data.Request = &Worker->RequestData;
+  HttpIo->ReqToken.Message->HeaderCount  = Worker->RequestHeader->HeaderCount;
+  HttpIo->ReqToken.Message->Headers      = Worker->RequestHeader->Headers;
+  HttpIo->ReqToken.Message->BodyLength   = 0;
+  HttpIo->ReqToken.Message->Body         = NULL;
+
+  //
+  // Report the request of the first range only, it stands for the whole download.
+  //
+  if ((Worker->Start == 0) && (Worker->Retries == 0) && (HttpIo->Callback != NULL)) {
+    Status = HttpIo->Callback (
+                       HttpIoRequest,
+                       HttpIo->ReqToken.Message,
+                       HttpIo->Context
+                       );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo->IsTxDone = FALSE;
+  Status           = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    return Status;
+  }
+
+  Worker->State = HttpBootRangeRequest;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a response token of a range worker, either for the response header or
+  for the next piece of the message-body, which lands directly in Buffer.
+
+  @param[in, out]  Worker          The range worker.
+  @param[in]       Buffer          The buffer the boot file is downloaded to.
+  @param[in]       RecvMsgHeader   TRUE to receive the response header.
+
+  @retval EFI_SUCCESS              The response token is queued.
+  @retval Others                   Failed to queue the response token.
+
+**/
+EFI_STATUS
+HttpBootRangeRecvResponse (
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker,
+  IN     UINT8                   *Buffer,
+  IN     BOOLEAN                 RecvMsgHeader
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+
+  HttpIo = &Worker->HttpIo;
+
+  HttpIo->RspToken.Status               = EFI_NOT_READY;
+  HttpIo->RspToken.Message->HeaderCount = 0;
+  HttpIo->RspToken.Message->Headers     = NULL;
+  if (RecvMsgHeader) {
+    HttpIo->RspToken.Message->Data.Response = &Worker->Response;
+    HttpIo->RspToken.Message->BodyLength    = 0;
+    HttpIo->RspToken.Message->Body          = NULL;
+  } else {
+    HttpIo->RspToken.Message->Data.Response = NULL;
+    HttpIo->RspToken.Message->BodyLength    = Worker->End - Worker->Start - Worker->Received;
+    HttpIo->RspToken.Message->Body          = Buffer + Worker->Start + Worker->Received;
+  }
+
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo->IsRxDone = FALSE;
+  Status           = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    return Status;
+  }
+
+  Worker->State = RecvMsgHeader ? HttpBootRangeHeader : HttpBootRangeBody;
+  return EFI_SUCCESS;
+}
+
+/**
+  Cancel any outstanding token of a range worker and release its HTTP child.
+
+  @param[in, out]  Worker          The range worker.
+
+**/
+VOID
+HttpBootRangeDestroyWorker (
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker
+  )
+{
+  if (Worker->HttpCreated) {
+    if ((Worker->State == HttpBootRangeRequest) ||
+        (Worker->State == HttpBootRangeHeader) ||
+        (Worker->State == HttpBootRangeBody))
+    {
+      Worker->HttpIo.Http->Cancel (Worker->HttpIo.Http, NULL);
+    }
+
+    HttpIoDestroyIo (&Worker->HttpIo);
+    Worker->HttpCreated = FALSE;
+  }
+
+  if (Worker->RequestHeader != NULL) {
+    HttpIoFreeHeader (Worker->RequestHeader);
+    Worker->RequestHeader = NULL;
+  }
+}
+
+/**
+  Handle a failed range. Like the single connection download, only EFI_TIMEOUT
+  and EFI_DEVICE_ERROR are resumed: the worker gets a new HTTP child and asks for
+  the part of its range not received yet after PcdHttpDelayBetweenResumeRetries.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Worker          The range worker.
+  @param[in]       Reason          The error the range failed with.
+
+  @retval EFI_SUCCESS              The range will be resumed.
+  @retval Others                   The range can't be resumed.
+
+**/
+EFI_STATUS
+HttpBootRangeResume (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker,
+  IN     EFI_STATUS              Reason
+  )
+{
+  EFI_STATUS  Status;
+
+  DEBUG (
+    (DEBUG_WARN | DEBUG_INFO,
+     "HttpBootRangeResume: Range %lu-%lu failed at byte %lu, %r.\n",
+     (UINT64)Worker->Start,
+     (UINT64)(Worker->End - 1),
+     (UINT64)(Worker->Start + Worker->Received),
+     Reason)
+    );
+
+  if ((Reason != EFI_TIMEOUT) && (Reason != EFI_DEVICE_ERROR)) {
+    return Reason;
+  }
+
+  Worker->Retries++;
+  if (Worker->Retries >= PcdGet32 (PcdMaxHttpResumeRetries)) {
+    return Reason;
+  }
+
+  HttpBootRangeDestroyWorker (Worker);
+  Worker->State = HttpBootRangeIdle;
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Worker->HttpIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Worker->HttpCreated = TRUE;
+
+  Status = gBS->SetTimer (
+                  Worker->HttpIo.TimeoutEvent,
+                  TimerRelative,
+                  MultU64x32 (TICKS_PER_SECOND, PcdGet32 (PcdHttpDelayBetweenResumeRetries))
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Worker->State = HttpBootRangeRetry;
+  return EFI_SUCCESS;
+}
+
+/**
+  Move a range worker on once its outstanding token has completed or timed out.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The boot file URL.
+  @param[in]       FileSize        The size of the boot file.
+  @param[in]       Buffer          The buffer the boot file is downloaded to.
+  @param[in, out]  Worker          The range worker.
+
+  @retval EFI_SUCCESS              The worker is still downloading, or its range is complete.
+  @retval EFI_UNSUPPORTED          The server didn't honor the Range request.
+  @retval Others                   The range failed and can't be resumed.
+
+**/
+EFI_STATUS
+HttpBootRangeProcess (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  IN     UINT8                   *Buffer,
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker
+  )
+{
+  EFI_STATUS        Status;
+  HTTP_IO           *HttpIo;
+  EFI_HTTP_MESSAGE  *Message;
+  BOOLEAN           Done;
+
+  HttpIo = &Worker->HttpIo;
+
+  switch (Worker->State) {
+    case HttpBootRangeRequest:
+    case HttpBootRangeHeader:
+    case HttpBootRangeBody:
+      Done = (Worker->State == HttpBootRangeRequest) ? HttpIo->IsTxDone : HttpIo->IsRxDone;
+      if (!Done) {
+        if (EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+          return EFI_SUCCESS;
+        }
+
+        Status = EFI_TIMEOUT;
+        break;
+      }
+
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+
+      if (Worker->State == HttpBootRangeRequest) {
+        Status = HttpIo->ReqToken.Status;
+        if (!EFI_ERROR (Status)) {
+          Status = HttpBootRangeRecvResponse (Worker, Buffer, TRUE);
+        }
+
+        break;
+      }
+
+      Message = HttpIo->RspToken.Message;
+      Status  = HttpIo->RspToken.Status;
+      if (Worker->State == HttpBootRangeHeader) {
+        if (Status == EFI_HTTP_ERROR) {
+          Status = EFI_UNSUPPORTED;
+        } else if (!EFI_ERROR (Status)) {
+          Status = HttpBootRangeCheckResponse (
+                     Message,
+                     Worker->Start + Worker->Received,
+                     Worker->End,
+                     FileSize
+                     );
+        }
+
+        //
+        // Report the response of the first range only, like its request.
+        //
+        if (!EFI_ERROR (Status) && (Worker->Start == 0) && (Worker->Retries == 0) && (HttpIo->Callback != NULL)) {
+          Status = HttpIo->Callback (
+                             HttpIoResponse,
+                             Message,
+                             HttpIo->Context
+                             );
+        }
+
+        if (Message->Headers != NULL) {
+          HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+          Message->Headers = NULL;
+        }
+
+        if (!EFI_ERROR (Status)) {
+          Status = HttpBootRangeRecvResponse (Worker, Buffer, FALSE);
+        }
+
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      if (Private->HttpBootCallback != NULL) {
+        Status = Private->HttpBootCallback->Callback (
+                                              Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)Message->BodyLength,
+                                              Message->Body
+                                              );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      Worker->Received += Message->BodyLength;
+      if (Worker->Start + Worker->Received < Worker->End) {
+        Status = HttpBootRangeRecvResponse (Worker, Buffer, FALSE);
+        break;
+      }
+
+      Worker->State = HttpBootRangeIdle;
+      return EFI_SUCCESS;
+
+    case HttpBootRangeRetry:
+      if (EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+        return EFI_SUCCESS;
+      }
+
+      Status = HttpBootRangeSendRequest (Private, Url, Worker);
+      break;
+
+    default:
+      return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+    Status = HttpBootRangeResume (Private, Worker, Status);
+  }
+
+  return Status;
+}
+
+/**
+  Download the boot file as concurrent HTTP byte ranges.
+
+  The file is split into HTTP_BOOT_RANGE_SIZE ranges which are handed out to up
+  to PcdHttpBootRangeConnections HTTP children. Each child has its own TCP
+  connection and receives its ranges directly into place in Buffer. A range that
+  times out is resumed from its last received byte on a new child, so a stalled
+  connection doesn't restart the whole file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The boot file URL.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          Range download is disabled or not worthwhile for this file,
+                                   or the server didn't honor the Range requests. The caller
+                                   should download the file with a single GET.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_ABORTED              A range timed out or failed on every resume attempt.
+  @retval Others                   A range failed and could not be resumed.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  EFI_STATUS              Status;
+  HTTP_BOOT_RANGE_WORKER  *Workers;
+  HTTP_BOOT_RANGE_WORKER  *Worker;
+  UINTN                   WorkerCount;
+  UINTN                   FileSize;
+  UINTN                   NextOffset;
+  UINTN                   Index;
+  BOOLEAN                 Busy;
+
+  FileSize    = Private->BootFileSize;
+  WorkerCount = PcdGet8 (PcdHttpBootRangeConnections);
+  if ((WorkerCount < 2) || (FileSize <= HTTP_BOOT_RANGE_SIZE) || (*BufferSize < FileSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  WorkerCount = MIN (WorkerCount, (FileSize + HTTP_BOOT_RANGE_SIZE - 1) / HTTP_BOOT_RANGE_SIZE);
+  Workers     = AllocateZeroPool (WorkerCount * sizeof (HTTP_BOOT_RANGE_WORKER));
+  if (Workers == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < WorkerCount; Index++) {
+    Status = HttpBootCreateHttpIoInstance (Private, &Workers[Index].HttpIo);
+    if (EFI_ERROR (Status)) {
+      WorkerCount = Index;
+      break;
+    }
+
+    Workers[Index].HttpCreated = TRUE;
+  }
+
+  if (WorkerCount < 2) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  DEBUG ((DEBUG_INFO, "HttpBootGetBootFileByRange: %lu bytes over %lu connections.\n", (UINT64)FileSize, (UINT64)WorkerCount));
+
+  //
+  // Every range response carries a Content-Range header, so the progress
+  // callback won't reset the progress from them: start it from the file size.
+  //
+  Private->FileSize     = FileSize;
+  Private->ReceivedSize = 0;
+  Private->Percentage   = 0;
+
+  NextOffset = 0;
+  do {
+    Busy = FALSE;
+    for (Index = 0; Index < WorkerCount; Index++) {
+      Worker = &Workers[Index];
+      if ((Worker->State == HttpBootRangeIdle) && (NextOffset < FileSize)) {
+        Worker->Start    = NextOffset;
+        Worker->End      = MIN (NextOffset + HTTP_BOOT_RANGE_SIZE, FileSize);
+        Worker->Received = 0;
+        Worker->Retries  = 0;
+        NextOffset       = Worker->End;
+
+        Status = HttpBootRangeSendRequest (Private, Url, Worker);
+        if (EFI_ERROR (Status)) {
+          Status = HttpBootRangeResume (Private, Worker, Status);
+          if (EFI_ERROR (Status)) {
+            goto ON_EXIT;
+          }
+        }
+      }
+
+      if (Worker->State == HttpBootRangeIdle) {
+        continue;
+      }
+
+      Busy = TRUE;
+      Worker->HttpIo.Http->Poll (Worker->HttpIo.Http);
+      Status = HttpBootRangeProcess (Private, Url, FileSize, Buffer, Worker);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  } while (Busy);
+
+  *BufferSize = FileSize;
+  *ImageType  = Private->ImageType;
+  Status      = EFI_SUCCESS;
+
+ON_EXIT:
+  for (Index = 0; Index < WorkerCount; Index++) {
+    HttpBootRangeDestroyWorker (&Workers[Index]);
+  }
+
+  FreePool (Workers);
+
+  //
+  // The failed range has already been resumed PcdMaxHttpResumeRetries times.
+  // Don't let the caller's resume loop restart the whole download on top.
+  //
+  if ((Status == EFI_TIMEOUT) || (Status == EFI_DEVICE_ERROR)) {
+    Status = EFI_ABORTED;
+  }
+
+  return Status;
+}
+
+/**
+  This function download the boot file by using UEFI HTTP protocol.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       HeaderOnly      Only request the response header, it could save a lot of time if
+                                   the caller only want to know the size of the requested file.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer. On output with a return code of EFI_BUFFER_TOO_SMALL,
+                                   the size of Buffer required to retrieve the requested file.
+  @param[out]      Buffer          The memory buffer to transfer the file to. IF Buffer is NULL,
+                                   then the size of the requested file is returned in
+                                   BufferSize.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_INVALID_PARAMETER    BufferSize is NULL or Buffer Size is not NULL but Buffer is NULL.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to read the current directory entry.
+                                   BufferSize has been updated with the size needed to complete
+                                   the request.
+  @retval EFI_ACCESS_DENIED        The server needs to authenticate the client.
+  @retval EFI_NOT_READY            Data transfer has timed-out, call HttpBootGetBootFile again to resume
+                                   the download operation using HTTP Range headers.
+  @retval EFI_UNSUPPORTED          Some HTTP response header is not supported.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFile (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     BOOLEAN                 HeaderOnly,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  EFI_STATUS               Status;
+  EFI_HTTP_STATUS_CODE     StatusCode;
+  EFI_HTTP_REQUEST_DATA    *RequestData;
+  HTTP_IO_RESPONSE_DATA    *ResponseData;
+  HTTP_IO_RESPONSE_DATA    ResponseBody;
+  HTTP_IO                  *HttpIo;
+  HTTP_IO_HEADER           *HttpIoHeader;
+  VOID                     *Parser;
+  HTTP_BOOT_CALLBACK_DATA  Context;
+  UINTN                    ContentLength;
+  HTTP_BOOT_CACHE_CONTENT  *Cache;
+  UINT8                    *Block;
+  UINTN                    UrlSize;
+  CHAR16                   *Url;
+  BOOLEAN                  IdentityMode;
+  UINTN                    ReceivedSize;
+  EFI_HTTP_HEADER          *HttpHeader;
+  CHAR8                    *Data;
+  BOOLEAN                  ResumingOperation;
+  CHAR8                    *ContentRangeResponseValue;
+
+  ASSERT (Private != NULL);
+  ASSERT (Private->HttpCreated);
+
+  if ((BufferSize == NULL) || (ImageType == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((*BufferSize != 0) && (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // First, check whether we already cached the requested Uri.
+  //
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+  if (!HeaderOnly && (Buffer != NULL)) {
+    Status = HttpBootGetFileFromCache (Private, Url, BufferSize, Buffer, ImageType);
+    if (Status != EFI_NOT_FOUND) {
+      FreePool (Url);
+      return Status;
+    }
+  }
+
+  // Check if this is a previous download that has failed and need to be resumed
+  if ((!HeaderOnly) &&
+      (Private->PartialTransferredSize > 0) &&
+      (Private->BootFileSize == *BufferSize))
+  {
+    ResumingOperation = TRUE;
+  } else {
+    ResumingOperation = FALSE;
+  }
+
+  //
+  // Large files are downloaded as concurrent byte ranges when the platform
+  // enables it and the server supports it, otherwise with a single GET below.
+  //
+  if (!HeaderOnly && (Buffer != NULL) && !ResumingOperation) {
+    Status = HttpBootGetBootFileByRange (Private, Url, BufferSize, Buffer, ImageType);
+    if (Status != EFI_UNSUPPORTED) {
+      FreePool (Url);
+      return Status;
+    }
+  }
+
+  //
+  // Not found in cache, try to download it through HTTP.
+  //
+
+  //
+  // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
+  //
+  Cache = NULL;
+  if ((!HeaderOnly) && (*BufferSize == 0)) {
+    Cache = AllocateZeroPool (sizeof (HTTP_BOOT_CACHE_CONTENT));
+    if (Cache == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ERROR_1;
+    }
+
+    Cache->ImageType = ImageTypeMax;
+    InitializeListHead (&Cache->EntityDataList);
+  }
+
+  //
+  // 2. Send HTTP request message.
+  //
+
+  //
+  // 2.1 Build HTTP header for the request.
+  //
+  Status = HttpBootCreateRequestHeader (
+             Private,
+             ResumingOperation,
+             Private->PartialTransferredSize,
+             Private->BootFileSize - 1,
+             &HttpIoHeader
+             );
+  if (EFI_ERROR (Status)) {
+    goto ERROR_2;
+  }
+
+  if (ResumingOperation) {
+    DEBUG (
+      (DEBUG_WARN | DEBUG_INFO,
+       "HttpBootGetBootFile: Resuming failed download from byte %lu.\n",
+       Private->PartialTransferredSize)
+      );
+  }
+
   //
   // 2.2 Build the rest of HTTP request info.
   //
@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_BLOCK_SIZE                   32000
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT          "UefiHttpBoot/1.0"
 #define HTTP_BOOT_AUTHENTICATION_INFO_MAX_LEN  255
+#define HTTP_BOOT_RANGE_SIZE                   SIZE_4MB
 
 //
 // Record the data length and start address of a data block.
@@ -58,6 +59,31 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+typedef enum {
+  HttpBootRangeIdle,          // No range assigned.
+  HttpBootRangeRequest,       // Waiting for the GET request to be sent.
+  HttpBootRangeHeader,        // Waiting for the response header.
+  HttpBootRangeBody,          // Waiting for the next piece of message-body.
+  HttpBootRangeRetry          // Waiting to resend the unfinished part of the range.
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// One HTTP child of a parallel range download. It owns the bytes
+// [Start, End) of the file, Received of them are already in the buffer.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   HttpCreated;
+  HTTP_BOOT_RANGE_STATE     State;
+  UINTN                     Start;
+  UINTN                     End;
+  UINTN                     Received;
+  UINT32                    Retries;
+  HTTP_IO_HEADER            *RequestHeader;
+  EFI_HTTP_REQUEST_DATA     RequestData;
+  EFI_HTTP_RESPONSE_DATA    Response;
+} HTTP_BOOT_RANGE_WORKER;
+
 /**
   Discover all the boot information for boot file.
 
@@ -72,6 +98,22 @@ HttpBootDiscoverBootInfo (
   IN OUT HTTP_BOOT_PRIVATE_DATA  *Private
   );
 
+/**
+  Create and configure a HttpIo instance with the driver's station address.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to initialize.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
+  );
+
 /**
   Create a HttpIo instance for the file download.
 
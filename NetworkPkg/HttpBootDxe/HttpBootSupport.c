@@ -790,3 +790,72 @@ HttpBootIsHttpRedirectStatusCode (
 
   return FALSE;
 }
+
+/**
+  Check that the response to a Range request is a 206 response carrying exactly
+  the bytes [Start, End) of a file of FileSize bytes.
+
+  @param[in]  Message              The response message, with its header.
+  @param[in]  Start                The first byte of the requested range.
+  @param[in]  End                  One past the last byte of the requested range.
+  @param[in]  FileSize             The expected size of the file.
+
+  @retval EFI_SUCCESS              The response carries the requested range.
+  @retval EFI_UNSUPPORTED          The server didn't honor the Range request.
+
+**/
+EFI_STATUS
+HttpBootRangeCheckResponse (
+  IN EFI_HTTP_MESSAGE  *Message,
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             FileSize
+  )
+{
+  EFI_HTTP_HEADER  *HttpHeader;
+  CHAR8            *Value;
+  UINTN            Number;
+
+  if ((Message->Data.Response == NULL) ||
+      (Message->Data.Response->StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  HttpHeader = HttpFindHeader (
+                 Message->HeaderCount,
+                 Message->Headers,
+                 HTTP_HEADER_CONTENT_RANGE
+                 );
+  if ((HttpHeader == NULL) ||
+      (AsciiStrnCmp (HttpHeader->FieldValue, "bytes ", 6) != 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Content-Range: bytes <range-start>-<range-end>/<size>
+  //
+  Value = HttpHeader->FieldValue + 6;
+  if (RETURN_ERROR (AsciiStrDecimalToUintnS (Value, &Value, &Number)) ||
+      (Number != Start) ||
+      (*Value != '-'))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (RETURN_ERROR (AsciiStrDecimalToUintnS (Value + 1, &Value, &Number)) ||
+      (Number != End - 1) ||
+      (*Value != '/'))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (RETURN_ERROR (AsciiStrDecimalToUintnS (Value + 1, &Value, &Number)) ||
+      (Number != FileSize))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
@@ -212,4 +212,25 @@ HttpBootIsHttpRedirectStatusCode (
   IN   EFI_HTTP_STATUS_CODE  StatusCode
   );
 
+/**
+  Check that the response to a Range request is a 206 response carrying exactly
+  the bytes [Start, End) of a file of FileSize bytes.
+
+  @param[in]  Message              The response message, with its header.
+  @param[in]  Start                The first byte of the requested range.
+  @param[in]  End                  One past the last byte of the requested range.
+  @param[in]  FileSize             The expected size of the file.
+
+  @retval EFI_SUCCESS              The response carries the requested range.
+  @retval EFI_UNSUPPORTED          The server didn't honor the Range request.
+
+**/
+EFI_STATUS
+HttpBootRangeCheckResponse (
+  IN EFI_HTTP_MESSAGE  *Message,
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             FileSize
+  );
+
 #endif
@@ -1087,7 +1087,9 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveTime       = HTTP_KEEP_ALIVE_TIME;
   Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle         = TRUE;
+  Tcp4Option->EnableTimeStamp     = TRUE;
   Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
   Tcp4CfgData->ControlOption      = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
@@ -1171,7 +1173,9 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveTime       = HTTP_KEEP_ALIVE_TIME;
   Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle         = TRUE;
+  Tcp6Option->EnableTimeStamp     = TRUE;
   Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
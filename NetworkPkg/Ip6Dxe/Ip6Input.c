@@ -743,6 +743,7 @@ Ip6PreProcessPacket (
 {
   UINT16               PayloadLen;
   UINT16               TotalLen;
+  UINT8                *ExtHdrs;
   UINT32               FormerHeadOffset;
   UINT32               HeadLen;
   IP6_FRAGMENT_HEADER  *FragmentHead;
@@ -839,23 +840,28 @@ Ip6PreProcessPacket (
   }
 
   //
-  // Check the extension headers, if exist validate them
+  // Check the extension headers, if exist validate them. Only the header
+  // chain needs a flat copy: when the upper layer header directly follows
+  // the IPv6 header there is nothing to walk, so leave the payload in the
+  // received buffer rather than copying every TCP/UDP segment out of it.
   //
-  if (PayloadLen != 0) {
+  ExtHdrs = NULL;
+  if ((PayloadLen != 0) && !IP6_IS_UPPER_LAYER_HEADER ((*Head)->NextHeader)) {
     *Payload = AllocatePool ((UINTN)PayloadLen);
     if (*Payload == NULL) {
       return EFI_INVALID_PARAMETER;
     }
 
     NetbufCopy (*Packet, sizeof (EFI_IP6_HEADER), PayloadLen, *Payload);
+    ExtHdrs = *Payload;
   }
 
   if (!Ip6IsExtsValid (
          IpSb,
          *Packet,
          &(*Head)->NextHeader,
-         *Payload,
-         (UINT32)PayloadLen,
+         ExtHdrs,
+         (ExtHdrs == NULL) ? 0 : (UINT32)PayloadLen,
          TRUE,
          &FormerHeadOffset,
          LastHead,
@@ -921,7 +927,8 @@ Ip6PreProcessPacket (
     //
     *Head      = (*Packet)->Ip.Ip6;
     PayloadLen = (*Head)->PayloadLength;
-    if (PayloadLen != 0) {
+    ExtHdrs    = NULL;
+    if ((PayloadLen != 0) && !IP6_IS_UPPER_LAYER_HEADER ((*Head)->NextHeader)) {
       if (*Payload != NULL) {
         FreePool (*Payload);
       }
@@ -932,14 +939,15 @@ Ip6PreProcessPacket (
       }
 
       NetbufCopy (*Packet, sizeof (EFI_IP6_HEADER), PayloadLen, *Payload);
+      ExtHdrs = *Payload;
     }
 
     if (!Ip6IsExtsValid (
            IpSb,
            *Packet,
            &(*Head)->NextHeader,
-           *Payload,
-           (UINT32)PayloadLen,
+           ExtHdrs,
+           (ExtHdrs == NULL) ? 0 : (UINT32)PayloadLen,
            TRUE,
            NULL,
            LastHead,
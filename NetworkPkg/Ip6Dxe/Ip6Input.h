@@ -32,6 +32,13 @@
 #define IP6_RXDATA_WRAP_SIZE(NumFrag) \
           (sizeof (IP6_RXDATA_WRAP) + sizeof (EFI_IP6_FRAGMENT_DATA) * ((NumFrag) - 1))
 
+//
+// Upper layer protocols that Ip6IsExtsValid accepts as the first next
+// header without looking at the payload.
+//
+#define IP6_IS_UPPER_LAYER_HEADER(NextHeader) \
+          (((NextHeader) == EFI_IP_PROTO_TCP) || ((NextHeader) == EFI_IP_PROTO_UDP) || ((NextHeader) == IP6_ICMP))
+
 //
 // Per packet information for input process. LinkFlag specifies whether
 // the packet is received as Link layer unicast, multicast or broadcast.
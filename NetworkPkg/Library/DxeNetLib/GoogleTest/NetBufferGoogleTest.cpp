@@ -0,0 +1,142 @@
+/** @file
+  Tests for the checksum functions in NetBuffer.c.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/NetLib.h>
+}
+
+// 16 bits at a time one's complement sum, as NetblockChecksum used to compute
+// it, used as the reference implementation. The sum is 64 bits wide here, as
+// the 32-bit sum of the original wraps for blocks larger than 128KB.
+STATIC
+UINT16
+ReferenceChecksum (
+  CONST UINT8  *Bulk,
+  UINT32       Len
+  )
+{
+  UINT64  Sum;
+  UINT16  Word;
+
+  Sum = 0;
+
+  if (Len % 2 != 0) {
+    Sum += Bulk[Len - 1];
+  }
+
+  while (Len > 1) {
+    memcpy (&Word, Bulk, sizeof (Word));
+    Sum  += Word;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return (UINT16)Sum;
+}
+
+STATIC
+std::vector<UINT8>
+MakeChecksumTestData (
+  UINTN  Size
+  )
+{
+  std::vector<UINT8>  Data (Size);
+  UINT32              Seed;
+  UINTN               Index;
+
+  Seed = 0x12345678;
+  for (Index = 0; Index < Size; Index++) {
+    Seed        = Seed * 1103515245 + 12345;
+    Data[Index] = (UINT8)(Seed >> 16);
+  }
+
+  return Data;
+}
+
+STATIC
+VOID
+EFIAPI
+ChecksumTestExtFree (
+  VOID  *Arg
+  )
+{
+}
+
+TEST (NetblockChecksum, BasicCheck) {
+  // Example from RFC 1071 section 3: the sum of these words is 0xddf2 in
+  // network byte order.
+  UINT8  Data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+
+  EXPECT_EQ (NTOHS (NetblockChecksum (Data, sizeof (Data))), 0xddf2);
+  EXPECT_EQ (NetblockChecksum (Data, 0), 0);
+}
+
+TEST (NetblockChecksum, LengthsAndAlignments) {
+  std::vector<UINT8>  Data;
+  UINT32              Offset;
+  UINT32              Length;
+
+  Data = MakeChecksumTestData (4096 + 8);
+
+  for (Offset = 0; Offset < 8; Offset++) {
+    for (Length = 0; Length <= 4096; Length += (Length < 160) ? 1 : 61) {
+      EXPECT_EQ (
+        NetblockChecksum (Data.data () + Offset, Length),
+        ReferenceChecksum (Data.data () + Offset, Length)
+        ) << "Offset " << Offset << " Length " << Length;
+    }
+  }
+}
+
+TEST (NetblockChecksum, CarryFolding) {
+  // All ones and all zeroes are the two extremes of the end-around carry.
+  std::vector<UINT8>  Data (SIZE_1MB + 3, 0xff);
+  UINT32              Length;
+
+  for (Length = SIZE_1MB; Length < SIZE_1MB + 3; Length++) {
+    EXPECT_EQ (NetblockChecksum (Data.data (), Length), ReferenceChecksum (Data.data (), Length));
+    EXPECT_EQ (NetblockChecksum (Data.data () + 1, Length), ReferenceChecksum (Data.data () + 1, Length));
+  }
+
+  std::fill (Data.begin (), Data.end (), 0);
+  EXPECT_EQ (NetblockChecksum (Data.data (), SIZE_1MB), 0);
+}
+
+TEST (NetbufChecksum, Fragments) {
+  // Fragments of odd sizes exercise the byte swap NetbufChecksum applies to
+  // blocks that start at an odd offset in the packet.
+  std::vector<UINT8>  Data;
+  NET_FRAGMENT        Fragment[4];
+  NET_BUF             *Nbuf;
+
+  Data = MakeChecksumTestData (1500);
+
+  Fragment[0].Bulk = Data.data ();
+  Fragment[0].Len  = 13;
+  Fragment[1].Bulk = Data.data () + 13;
+  Fragment[1].Len  = 600;
+  Fragment[2].Bulk = Data.data () + 613;
+  Fragment[2].Len  = 1;
+  Fragment[3].Bulk = Data.data () + 614;
+  Fragment[3].Len  = 886;
+
+  Nbuf = NetbufFromExt (Fragment, 4, 0, 0, ChecksumTestExtFree, NULL);
+  ASSERT_NE (Nbuf, nullptr);
+
+  EXPECT_EQ (NetbufChecksum (Nbuf), ReferenceChecksum (Data.data (), (UINT32)Data.size ()));
+
+  NetbufFree (Nbuf);
+}
@@ -69,6 +69,11 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // Current period of PollTimer, between MNP_SYS_POLL_MIN_INTERVAL while
+  // packets are arriving and MNP_SYS_POLL_INTERVAL when the link is idle.
+  //
+  UINT64                         PollInterval;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -1087,6 +1087,10 @@ MnpCheckMediaStatus (
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  Each tick drains up to MNP_SYS_POLL_BUDGET packets rather than one. The
+  timer period drops to MNP_SYS_POLL_MIN_INTERVAL as soon as a packet is
+  seen and doubles on every idle tick until it is back at MNP_SYS_POLL_INTERVAL.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1099,17 +1103,46 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_STATUS       Status;
+  UINTN            Count;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
-  //
-  // Try to receive packets from Snp.
-  //
-  MnpReceivePacket (MnpDeviceData);
+  for (Count = 0; Count < MNP_SYS_POLL_BUDGET; Count++) {
+    //
+    // Try to receive packets from Snp.
+    //
+    Status = MnpReceivePacket (MnpDeviceData);
 
-  //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
-  //
-  DispatchDpc ();
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events,
+    // so the upper layers can post new rx tokens before the next packet.
+    //
+    DispatchDpc ();
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  if (Count != 0) {
+    Interval = MNP_SYS_POLL_MIN_INTERVAL;
+  } else {
+    Interval = MultU64x32 (MnpDeviceData->PollInterval, 2);
+    if (Interval > MNP_SYS_POLL_INTERVAL) {
+      Interval = MNP_SYS_POLL_INTERVAL;
+    }
+  }
+
+  if (Interval != MnpDeviceData->PollInterval) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
 }
@@ -0,0 +1,172 @@
+/** @file
+  Tests for the CUBIC congestion control in TcpCongestion.c.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TCP_CUBIC_TEST_MSS  1000
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These globals are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+UINT32  mTcpTick = 1000;
+
+////////////////////////////////////////////////////////////////////////
+// TcpCubicRoot Tests
+////////////////////////////////////////////////////////////////////////
+
+TEST (TcpCubicRoot, SmallValues) {
+  EXPECT_EQ (TcpCubicRoot (0), 0U);
+  EXPECT_EQ (TcpCubicRoot (1), 1U);
+  EXPECT_EQ (TcpCubicRoot (7), 1U);
+  EXPECT_EQ (TcpCubicRoot (8), 2U);
+  EXPECT_EQ (TcpCubicRoot (26), 2U);
+  EXPECT_EQ (TcpCubicRoot (27), 3U);
+}
+
+TEST (TcpCubicRoot, RoundsDown) {
+  UINT64  Root;
+
+  for (Root = 2; Root < (1 << 21); Root = Root * 3 + 1) {
+    EXPECT_EQ (TcpCubicRoot (Root * Root * Root), Root);
+    EXPECT_EQ (TcpCubicRoot (Root * Root * Root - 1), Root - 1);
+    EXPECT_EQ (TcpCubicRoot (Root * Root * Root + 1), Root);
+  }
+
+  //
+  // The largest root the callers can ask for.
+  //
+  EXPECT_EQ (TcpCubicRoot (MAX_INT64), 2097151U);
+}
+
+////////////////////////////////////////////////////////////////////////
+// CUBIC Tests
+//
+// The example used throughout is a loss at WMax = 100 segments, so that
+// the window starts the next epoch at Beta * WMax = 70 segments. With
+// C = 0.4, RFC9438 equation (2) gives K = cbrt ((100 - 70) / 0.4) =
+// 4.2172 seconds, and equation (1) W(t) = C * (t - K)^3 + WMax.
+////////////////////////////////////////////////////////////////////////
+
+class TcpCubicTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    Tcb.SndMss     = TCP_CUBIC_TEST_MSS;
+    Tcb.CongestOps = &mTcpCubic;
+    Tcb.CongestOps->Init (&Tcb);
+  }
+};
+
+// Equation (2): the time to grow back to WMax.
+TEST_F (TcpCubicTest, EpochStartComputesK) {
+  Tcb.CubicWMax = 100 * TCP_CUBIC_TEST_MSS;
+  Tcb.CWnd      = 70 * TCP_CUBIC_TEST_MSS;
+  Tcb.Ssthresh  = Tcb.CWnd;
+
+  Tcb.CongestOps->OnAck (&Tcb, TCP_CUBIC_TEST_MSS);
+
+  EXPECT_EQ (Tcb.CubicEpochStart, mTcpTick);
+  EXPECT_EQ (Tcb.CubicK, 4217U);
+  EXPECT_EQ (Tcb.CubicOrigin, 100U * TCP_CUBIC_TEST_MSS);
+}
+
+// Above WMax, the epoch starts at the plateau with K = 0.
+TEST_F (TcpCubicTest, EpochStartAboveWMax) {
+  Tcb.CubicWMax = 50 * TCP_CUBIC_TEST_MSS;
+  Tcb.CWnd      = 70 * TCP_CUBIC_TEST_MSS;
+  Tcb.Ssthresh  = Tcb.CWnd;
+
+  Tcb.CongestOps->OnAck (&Tcb, TCP_CUBIC_TEST_MSS);
+
+  EXPECT_EQ (Tcb.CubicK, 0U);
+  EXPECT_EQ (Tcb.CubicOrigin, 70U * TCP_CUBIC_TEST_MSS);
+}
+
+// Equation (1) at a few points of the curve.
+TEST_F (TcpCubicTest, TargetFollowsCubicFunction) {
+  Tcb.CubicK      = 4217;
+  Tcb.CubicOrigin = 100 * TCP_CUBIC_TEST_MSS;
+
+  //
+  // W(0) is the window the epoch started with, up to the rounding of K.
+  //
+  EXPECT_NEAR (TcpCubicTarget (&Tcb, 0), 70 * TCP_CUBIC_TEST_MSS, TCP_CUBIC_TEST_MSS / 100);
+
+  //
+  // W(K) = WMax, then C * t^3 segments above it: 0.4 segment after one
+  // second, 400 segments after ten seconds.
+  //
+  EXPECT_EQ (TcpCubicTarget (&Tcb, 4217), 100U * TCP_CUBIC_TEST_MSS);
+  EXPECT_EQ (TcpCubicTarget (&Tcb, 4217 + 1000), 100U * TCP_CUBIC_TEST_MSS + 400);
+  EXPECT_EQ (TcpCubicTarget (&Tcb, 4217 + 10000), 500U * TCP_CUBIC_TEST_MSS);
+
+  //
+  // One second before K, symmetric to one second after.
+  //
+  EXPECT_EQ (TcpCubicTarget (&Tcb, 4217 - 1000), 100U * TCP_CUBIC_TEST_MSS - 400);
+}
+
+// The target never goes below one segment.
+TEST_F (TcpCubicTest, TargetFloor) {
+  Tcb.CubicK      = 10000;
+  Tcb.CubicOrigin = 10 * TCP_CUBIC_TEST_MSS;
+
+  EXPECT_EQ (TcpCubicTarget (&Tcb, 0), (UINT32)TCP_CUBIC_TEST_MSS);
+}
+
+// Equation (4): ssthresh is Beta = 0.7 times the flight size, and the
+// window reached is remembered as WMax.
+TEST_F (TcpCubicTest, SsthreshMultiplicativeDecrease) {
+  Tcb.SndUna = 1000;
+  Tcb.SndNxt = Tcb.SndUna + 100 * TCP_CUBIC_TEST_MSS;
+  Tcb.CWnd   = 100 * TCP_CUBIC_TEST_MSS;
+
+  EXPECT_NEAR (Tcb.CongestOps->Ssthresh (&Tcb), 70 * TCP_CUBIC_TEST_MSS, 70 * TCP_CUBIC_TEST_MSS / 1000);
+  EXPECT_EQ (Tcb.CubicWMax, 100U * TCP_CUBIC_TEST_MSS);
+  EXPECT_EQ (Tcb.CubicEpochStart, 0U);
+}
+
+// Section 4.7, fast convergence: a loss below the previous WMax sets
+// WMax to CWnd * (1 + Beta) / 2.
+TEST_F (TcpCubicTest, SsthreshFastConvergence) {
+  Tcb.SndUna        = 1000;
+  Tcb.SndNxt        = Tcb.SndUna + 80 * TCP_CUBIC_TEST_MSS;
+  Tcb.CWnd          = 80 * TCP_CUBIC_TEST_MSS;
+  Tcb.CubicWLastMax = 100 * TCP_CUBIC_TEST_MSS;
+
+  Tcb.CongestOps->Ssthresh (&Tcb);
+  EXPECT_NEAR (Tcb.CubicWMax, 68 * TCP_CUBIC_TEST_MSS, 68 * TCP_CUBIC_TEST_MSS / 1000);
+  EXPECT_EQ (Tcb.CubicWLastMax, 80U * TCP_CUBIC_TEST_MSS);
+}
+
+// Repeated timeouts of the same loss keep WMax.
+TEST_F (TcpCubicTest, SsthreshRepeatedLoss) {
+  Tcb.SndUna       = 1000;
+  Tcb.SndNxt       = Tcb.SndUna + 10 * TCP_CUBIC_TEST_MSS;
+  Tcb.CWnd         = TCP_CUBIC_TEST_MSS;
+  Tcb.CubicWMax    = 100 * TCP_CUBIC_TEST_MSS;
+  Tcb.CongestState = TCP_CONGEST_LOSS;
+
+  Tcb.CongestOps->Ssthresh (&Tcb);
+  EXPECT_EQ (Tcb.CubicWMax, 100U * TCP_CUBIC_TEST_MSS);
+}
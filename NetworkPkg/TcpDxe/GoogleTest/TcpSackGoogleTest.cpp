@@ -0,0 +1,225 @@
+/** @file
+  Tests for the SACK scoreboard in TcpSack.c.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TCP_SACK_TEST_MSS  1000
+#define TCP_SACK_TEST_UNA  10000
+#define TCP_SACK_TEST_NXT  100000
+
+////////////////////////////////////////////////////////////////////////
+// TcpSack Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpSackTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  TCP_OPTION Option;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Option, sizeof (Option));
+    Tcb.SndMss = TCP_SACK_TEST_MSS;
+    Tcb.SndUna = TCP_SACK_TEST_UNA;
+    Tcb.SndNxt = TCP_SACK_TEST_NXT;
+  }
+
+  VOID
+  ExpectBlock (
+    UINT8      Index,
+    TCP_SEQNO  Left,
+    TCP_SEQNO  Right
+    )
+  {
+    EXPECT_EQ (Tcb.SackBlock[Index].Left, Left) << "Block " << (UINTN)Index;
+    EXPECT_EQ (Tcb.SackBlock[Index].Right, Right) << "Block " << (UINTN)Index;
+  }
+
+  VOID
+  AddOptionBlock (
+    TCP_SEQNO  Left,
+    TCP_SEQNO  Right
+    )
+  {
+    ASSERT_LT (Option.SackNum, TCP_OPTION_MAX_SACK);
+    Option.Flag                       |= TCP_OPTION_RCVD_SACK;
+    Option.Sack[Option.SackNum].Left  = Left;
+    Option.Sack[Option.SackNum].Right = Right;
+    Option.SackNum++;
+  }
+};
+
+// Disjoint ranges are kept sorted, whatever the order they arrive in.
+TEST_F (TcpSackTest, InsertDisjointKeepsOrder) {
+  TcpSackInsert (&Tcb, 30000, 31000);
+  TcpSackInsert (&Tcb, 10000, 11000);
+  TcpSackInsert (&Tcb, 20000, 21000);
+
+  ASSERT_EQ (Tcb.SackNum, 3);
+  ExpectBlock (0, 10000, 11000);
+  ExpectBlock (1, 20000, 21000);
+  ExpectBlock (2, 30000, 31000);
+}
+
+// Adjacent ranges are merged into one.
+TEST_F (TcpSackTest, InsertMergesAdjacent) {
+  TcpSackInsert (&Tcb, 20000, 21000);
+  TcpSackInsert (&Tcb, 21000, 22000);
+  TcpSackInsert (&Tcb, 19000, 20000);
+
+  ASSERT_EQ (Tcb.SackNum, 1);
+  ExpectBlock (0, 19000, 22000);
+}
+
+// A range overlapping several others absorbs all of them.
+TEST_F (TcpSackTest, InsertMergesOverlapping) {
+  TcpSackInsert (&Tcb, 20000, 21000);
+  TcpSackInsert (&Tcb, 23000, 24000);
+  TcpSackInsert (&Tcb, 26000, 27000);
+  TcpSackInsert (&Tcb, 30000, 31000);
+
+  TcpSackInsert (&Tcb, 20500, 26500);
+
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ExpectBlock (0, 20000, 27000);
+  ExpectBlock (1, 30000, 31000);
+}
+
+// A range already SACKed changes nothing.
+TEST_F (TcpSackTest, InsertContained) {
+  TcpSackInsert (&Tcb, 20000, 25000);
+  TcpSackInsert (&Tcb, 21000, 22000);
+
+  ASSERT_EQ (Tcb.SackNum, 1);
+  ExpectBlock (0, 20000, 25000);
+}
+
+// When the scoreboard is full, the highest range is the one given up.
+TEST_F (TcpSackTest, InsertOverflowDropsHighest) {
+  UINT8  Index;
+
+  for (Index = 0; Index < TCP_SACK_SCOREBOARD_SIZE; Index++) {
+    TcpSackInsert (&Tcb, 20000 + Index * 2000, 21000 + Index * 2000);
+  }
+
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+
+  //
+  // Above every range: dropped.
+  //
+  TcpSackInsert (&Tcb, 50000, 51000);
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+  ExpectBlock (TCP_SACK_SCOREBOARD_SIZE - 1, 34000, 35000);
+
+  //
+  // Below every range: inserted, and the highest range drops out.
+  //
+  TcpSackInsert (&Tcb, 12000, 13000);
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+  ExpectBlock (0, 12000, 13000);
+  ExpectBlock (1, 20000, 21000);
+  ExpectBlock (TCP_SACK_SCOREBOARD_SIZE - 1, 32000, 33000);
+
+  //
+  // Merging into an existing range needs no room.
+  //
+  TcpSackInsert (&Tcb, 13000, 14000);
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+  ExpectBlock (0, 12000, 14000);
+  ExpectBlock (TCP_SACK_SCOREBOARD_SIZE - 1, 32000, 33000);
+}
+
+// Sequence numbers are compared modulo 2^32.
+TEST_F (TcpSackTest, InsertAcrossWrap) {
+  TcpSackInsert (&Tcb, 0x00000200, 0x00000400);
+  TcpSackInsert (&Tcb, 0xFFFFFE00, 0xFFFFFF00);
+  TcpSackInsert (&Tcb, 0xFFFFFF00, 0x00000100);
+
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ExpectBlock (0, 0xFFFFFE00, 0x00000100);
+  ExpectBlock (1, 0x00000200, 0x00000400);
+}
+
+// A cumulative ACK removes the ranges it covers and trims the one it
+// ends in.
+TEST_F (TcpSackTest, UpdatePrunesOnCumulativeAck) {
+  TcpSackInsert (&Tcb, 20000, 21000);
+  TcpSackInsert (&Tcb, 23000, 25000);
+  TcpSackInsert (&Tcb, 30000, 31000);
+
+  TcpSackUpdate (&Tcb, 21000, &Option);
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ExpectBlock (0, 23000, 25000);
+  ExpectBlock (1, 30000, 31000);
+
+  TcpSackUpdate (&Tcb, 24000, &Option);
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ExpectBlock (0, 24000, 25000);
+  ExpectBlock (1, 30000, 31000);
+
+  TcpSackUpdate (&Tcb, 31000, &Option);
+  EXPECT_EQ (Tcb.SackNum, 0);
+}
+
+// The blocks of a SACK option are merged in, except D-SACK blocks,
+// empty blocks and blocks beyond the data sent.
+TEST_F (TcpSackTest, UpdateMergesOptionBlocks) {
+  AddOptionBlock (30000, 31000);
+  AddOptionBlock (5000, 8000);
+  AddOptionBlock (40000, 40000);
+  AddOptionBlock (TCP_SACK_TEST_NXT, TCP_SACK_TEST_NXT + 1000);
+
+  TcpSackUpdate (&Tcb, TCP_SACK_TEST_UNA, &Option);
+  ASSERT_EQ (Tcb.SackNum, 1);
+  ExpectBlock (0, 30000, 31000);
+
+  //
+  // A block starting below the ACK only counts above it.
+  //
+  ZeroMem (&Option, sizeof (Option));
+  AddOptionBlock (19000, 22000);
+  AddOptionBlock (31000, 32000);
+
+  TcpSackUpdate (&Tcb, 20000, &Option);
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ExpectBlock (0, 20000, 22000);
+  ExpectBlock (1, 30000, 32000);
+}
+
+// The first unacknowledged segment is lost once more than two segments,
+// or three discontiguous ranges, are SACKed above it.
+TEST_F (TcpSackTest, IsLostThreshold) {
+  EXPECT_FALSE (TcpSackIsLost (&Tcb));
+
+  TcpSackInsert (&Tcb, 20000, 20000 + 2 * TCP_SACK_TEST_MSS);
+  EXPECT_FALSE (TcpSackIsLost (&Tcb));
+
+  TcpSackInsert (&Tcb, 30000, 30001);
+  EXPECT_TRUE (TcpSackIsLost (&Tcb));
+
+  TcpSackUpdate (&Tcb, 25000, &Option);
+  ASSERT_EQ (Tcb.SackNum, 1);
+  EXPECT_FALSE (TcpSackIsLost (&Tcb));
+
+  TcpSackInsert (&Tcb, 40000, 40001);
+  TcpSackInsert (&Tcb, 50000, 50001);
+  ASSERT_EQ (Tcb.SackNum, 3);
+  EXPECT_TRUE (TcpSackIsLost (&Tcb));
+}
@@ -0,0 +1,310 @@
+/** @file
+  TCP congestion control algorithms: NewReno and CUBIC.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC constants of RFC9438, fixed point with 10 fractional bits.
+// Beta is the multiplicative decrease factor 0.7, Alpha is the
+// additive increase factor 3 * (1 - Beta) / (1 + Beta) of the
+// Reno-friendly region.
+//
+#define TCP_CUBIC_SHIFT  10
+#define TCP_CUBIC_BETA   717
+#define TCP_CUBIC_ALPHA  542
+
+//
+// The cubic function uses milliseconds. C is 0.4, so K^3 in ms^3
+// is (WMax - CWnd) / SndMss * TCP_CUBIC_K_FACTOR, and the window
+// grows by (t^3 / 10^6) * SndMss / TCP_CUBIC_W_FACTOR bytes in t ms.
+//
+#define TCP_CUBIC_K_FACTOR  2500000000ULL
+#define TCP_CUBIC_W_FACTOR  2500
+#define TCP_CUBIC_MAX_TIME  (1 << 17)
+
+/**
+  Initialize the NewReno state, nothing besides the common variables.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpNewRenoInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+}
+
+/**
+  Grow the congestion window as specified in RFC5681: one SndMss per
+  ACK in slow start, one SndMss per RTT in congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of newly acknowledged bytes.
+
+**/
+VOID
+TcpNewRenoOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Halve the amount of outstanding data on a congestion event.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpNewRenoSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+  return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value    The value to compute the cube root of.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT32  Root;
+  UINT32  Bit;
+  UINT32  Try;
+
+  //
+  // The callers pass values below 2^63, so the root fits in 21 bits.
+  //
+  Root = 0;
+  for (Bit = 1 << 20; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+    if (MultU64x64 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Compute the target window of the cubic function at Time,
+  W(t) = C * (t - K)^3 + WMax.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Time     The time elapsed in the current epoch, in milliseconds.
+
+  @return The target window in bytes.
+
+**/
+UINT32
+TcpCubicTarget (
+  IN TCP_CB  *Tcb,
+  IN UINT32  Time
+  )
+{
+  UINT32  Offset;
+  UINT64  Delta;
+
+  if (Time > Tcb->CubicK) {
+    Offset = Time - Tcb->CubicK;
+  } else {
+    Offset = Tcb->CubicK - Time;
+  }
+
+  Offset = MIN (Offset, TCP_CUBIC_MAX_TIME);
+  Delta  = MultU64x64 (MultU64x32 (Offset, Offset), Offset);
+  Delta  = DivU64x32 (MultU64x32 (DivU64x32 (Delta, 1000000), Tcb->SndMss), TCP_CUBIC_W_FACTOR);
+
+  if (Time > Tcb->CubicK) {
+    Delta += Tcb->CubicOrigin;
+    return (UINT32)MIN (Delta, MAX_UINT32);
+  }
+
+  if (Delta >= Tcb->CubicOrigin) {
+    return Tcb->SndMss;
+  }
+
+  return Tcb->CubicOrigin - (UINT32)Delta;
+}
+
+/**
+  Initialize the CUBIC state.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->CubicWMax       = 0;
+  Tcb->CubicWLastMax   = 0;
+  Tcb->CubicEpochStart = 0;
+  Tcb->CubicK          = 0;
+  Tcb->CubicOrigin     = 0;
+  Tcb->CubicWEst       = 0;
+}
+
+/**
+  Grow the congestion window as specified in RFC9438. Slow start is the
+  same as NewReno; in congestion avoidance, the window follows the cubic
+  function of the time since the last congestion event, but never grows
+  slower than the Reno-friendly estimate.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of newly acknowledged bytes.
+
+**/
+VOID
+TcpCubicOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  UINT32  Time;
+  UINT32  Target;
+
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+    return;
+  }
+
+  if (Tcb->CubicEpochStart == 0) {
+    //
+    // A new congestion avoidance epoch.
+    //
+    Tcb->CubicEpochStart = mTcpTick;
+    Tcb->CubicWEst       = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK = TcpCubicRoot (
+                      DivU64x32 (
+                        MultU64x32 (TCP_CUBIC_K_FACTOR, Tcb->CubicWMax - Tcb->CWnd),
+                        Tcb->SndMss
+                        )
+                      );
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // The target is the window one RTT later. The timer ticks
+  // every TCP_TICK ms, so this is also the time granularity.
+  //
+  Time = MIN (
+           TCP_SUB_TIME (mTcpTick, Tcb->CubicEpochStart) + (Tcb->SRtt >> TCP_RTT_SHIFT),
+           TCP_CUBIC_MAX_TIME
+           ) * TCP_TICK;
+
+  Target = TcpCubicTarget (Tcb, Time);
+  Target = MIN (Target, Tcb->CWnd + (Tcb->CWnd >> 1));
+
+  if (Target > Tcb->CWnd) {
+    Tcb->CWnd += MAX (
+                   (UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Tcb->SndMss), Tcb->CWnd),
+                   1
+                   );
+  }
+
+  //
+  // Reno-friendly region: grow the estimate the way NewReno would
+  // with the CUBIC decrease factor, and use it if it is larger.
+  //
+  Tcb->CubicWEst += (UINT32)DivU64x32 (
+                              RShiftU64 (
+                                MultU64x32 (MultU64x32 (Acked, Tcb->SndMss), TCP_CUBIC_ALPHA),
+                                TCP_CUBIC_SHIFT
+                                ),
+                              Tcb->CWnd
+                              );
+
+  if (Tcb->CubicWEst > Tcb->CWnd) {
+    Tcb->CWnd = Tcb->CubicWEst;
+  }
+}
+
+/**
+  Reduce the window by the CUBIC decrease factor on a congestion event,
+  and remember the window reached for the next epoch. Repeated timeouts
+  of the same loss don't lower the remembered window.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    //
+    // Fast convergence: release bandwidth to new flows if the
+    // window keeps shrinking.
+    //
+    if (Tcb->CWnd < Tcb->CubicWLastMax) {
+      Tcb->CubicWLastMax = Tcb->CWnd;
+      Tcb->CubicWMax     = (UINT32)RShiftU64 (
+                                     MultU64x32 (Tcb->CWnd, (1 << TCP_CUBIC_SHIFT) + TCP_CUBIC_BETA),
+                                     TCP_CUBIC_SHIFT + 1
+                                     );
+    } else {
+      Tcb->CubicWLastMax = Tcb->CWnd;
+      Tcb->CubicWMax     = Tcb->CWnd;
+    }
+  }
+
+  Tcb->CubicEpochStart = 0;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+  return MAX (
+           (UINT32)RShiftU64 (MultU64x32 (FlightSize, TCP_CUBIC_BETA), TCP_CUBIC_SHIFT),
+           (UINT32)(2 * Tcb->SndMss)
+           );
+}
+
+TCP_CONGEST_OPS  mTcpNewReno = {
+  "NewReno",
+  TcpNewRenoInit,
+  TcpNewRenoOnAck,
+  TcpNewRenoSsthresh
+};
+
+TCP_CONGEST_OPS  mTcpCubic = {
+  "CUBIC",
+  TcpCubicInit,
+  TcpCubicOnAck,
+  TcpCubicSsthresh
+};
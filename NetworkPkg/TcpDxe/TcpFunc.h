@@ -354,6 +354,24 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the next hole of the SACK scoreboard, as the recovery
+  of RFC6675. A hole is a range not SACKed by the peer nor retransmitted
+  in this recovery, and below some SACKed data.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to start searching from.
+
+  @retval TRUE     A hole was found and retransmitted.
+  @retval FALSE    No hole to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -493,6 +511,93 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Merge the range [Left, Right) into the SACK scoreboard, keeping it sorted
+  and the ranges disjoint. If the scoreboard is full, the highest range is
+  dropped.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number SACKed.
+  @param[in]       Right    The sequence number following the last one SACKed.
+
+**/
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  );
+
+/**
+  Update the SACK scoreboard with an incoming ACK as specified in RFC6675.
+  Ranges cumulatively acknowledged by Ack are removed, and the blocks
+  of a SACK option are merged in.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+  @param[in]       Option   Pointer to the options of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Check whether the first unacknowledged segment is deemed lost by the
+  SACK information, that is, more than two segments or three discontiguous
+  ranges above it have been SACKed (RFC6675 IsLost).
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @retval TRUE         The first unacknowledged segment is lost.
+  @retval FALSE        There is not enough evidence of a loss.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN TCP_CB  *Tcb
+  );
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value    The value to compute the cube root of.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  );
+
+/**
+  Compute the target window of the cubic function at Time,
+  W(t) = C * (t - K)^3 + WMax.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Time     The time elapsed in the current epoch, in milliseconds.
+
+  @return The target window in bytes.
+
+**/
+UINT32
+TcpCubicTarget (
+  IN TCP_CB  *Tcb,
+  IN UINT32  Time
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -52,9 +52,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -63,6 +61,7 @@ TcpFastRecover (
     //
     // Step 2: Entering fast retransmission
     //
+    Tcb->SackHighRxt = Tcb->SndUna;
     TcpRetransmit (Tcb, Tcb->SndUna);
     Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
 
@@ -87,7 +86,13 @@ TcpFastRecover (
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    // If the peer has SACKed data above another hole, spend
+    // this ACK on retransmitting the hole instead (RFC6675).
+    //
+    if (!TcpSackRetransmit (Tcb, Tcb->SndUna)) {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +124,15 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK information,
+      // retransmit the next hole not retransmitted yet.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (Tcb->SackNum != 0) {
+        TcpSackRetransmit (Tcb, Seg->Ack);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -563,6 +574,11 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  //
+  // Remember the latest segment, the first SACK block reports it.
+  //
+  Tcb->RcvSackRecent = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1198,13 +1214,32 @@ TcpInput (
       Tcb->TsRecent    = Option.TSVal;
       Tcb->TsRecentAge = mTcpTick;
     }
+  }
 
-    TcpComputeRtt (Tcb, TCP_SUB_TIME (mTcpTick, Option.TSEcr));
-  } else if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RTT_ON)) {
-    ASSERT (Tcb->CongestState == TCP_CONGEST_OPEN);
-
-    TcpComputeRtt (Tcb, Tcb->RttMeasure);
-    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+  //
+  // Take a RTT sample only from an ACK for new data, and only once per
+  // flight: the ACK must cover RttSeq, so that the RTO estimator of RFC6298
+  // sees the samples it was designed for. With timestamps, the echoed TSEcr
+  // gives the sample even for retransmitted data, so RttSeq is moved to
+  // SndNxt to mark the end of the flight just sampled.
+  //
+  if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna) &&
+      TCP_SEQ_GT (Seg->Ack, Tcb->RttSeq))
+  {
+    if (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS) &&
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_TS) &&
+        (Option.TSEcr != 0) &&
+        TCP_TIME_LEQ (Option.TSEcr, mTcpTick))
+    {
+      TcpComputeRtt (Tcb, TCP_SUB_TIME (mTcpTick, Option.TSEcr));
+      TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+      Tcb->RttSeq = Tcb->SndNxt;
+    } else if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RTT_ON)) {
+      ASSERT (Tcb->CongestState == TCP_CONGEST_OPEN);
+
+      TcpComputeRtt (Tcb, Tcb->RttMeasure);
+      TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+    }
   }
 
   if (Seg->Ack == Tcb->SndNxt) {
@@ -1213,6 +1248,10 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1222,6 +1261,16 @@ TcpInput (
       (0 == Len))
   {
     Tcb->DupAck++;
+
+    //
+    // Enough SACKed data is as good as three duplicate ACKs.
+    //
+    if ((Tcb->CongestState == TCP_CONGEST_OPEN) &&
+        (Tcb->DupAck < 3) &&
+        TcpSackIsLost (Tcb))
+    {
+      Tcb->DupAck = 3;
+    }
   } else {
     Tcb->DupAck = 0;
   }
@@ -1233,11 +1282,7 @@ TcpInput (
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
+      Tcb->CongestOps->OnAck (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
     }
@@ -11,12 +11,15 @@
 #ifndef _TCP_MAIN_H_
 #define _TCP_MAIN_H_
 
+#include <Uefi.h>
+
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/Hash2.h>
 #include <Library/IpIoLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 
 #include "Socket.h"
 #include "TcpProto.h"
@@ -35,6 +38,9 @@ extern LIST_ENTRY  mTcpListenQue;
 extern TCP_SEQNO   mTcpGlobalSecret;
 extern UINT32      mTcpTick;
 
+extern TCP_CONGEST_OPS  mTcpNewReno;
+extern TCP_CONGEST_OPS  mTcpCubic;
+
 ///
 /// 30 seconds.
 ///
@@ -142,6 +142,19 @@ TcpInitTcbLocal (
 
   Tcb->ProbeTimerOn = FALSE;
 
+  //
+  // Select the congestion control algorithm and clear the
+  // SACK scoreboard.
+  //
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CONGESTION_CUBIC) {
+    Tcb->CongestOps = &mTcpCubic;
+  } else {
+    Tcb->CongestOps = &mTcpNewReno;
+  }
+
+  Tcb->CongestOps->Init (Tcb);
+  Tcb->SackNum = 0;
+
   return EFI_SUCCESS;
 }
 
@@ -221,6 +234,10 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
 }
 
 /**
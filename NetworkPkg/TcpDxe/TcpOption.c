@@ -160,6 +160,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option, only when configured to
+  // use SACK, and either we are doing active open or we have
+  // received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +194,83 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Collect the SACK blocks describing the out-of-order data in the
+  reassemble queue as specified in RFC2018. The first block reports
+  the most recently received segment, the rest follow in sequence order.
+
+  @param[in]   Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block   Array to store the SACK blocks.
+  @param[in]   Max     The maximum number of blocks to collect.
+
+  @return              The number of SACK blocks collected.
+
+**/
+UINT8
+TcpGetSackBlock (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           Max
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  TCP_SEQNO   Left;
+  TCP_SEQNO   Right;
+  UINT8       Num;
+  BOOLEAN     Recent;
+
+  Num    = 0;
+  Recent = FALSE;
+  Entry  = Tcb->RcvQue.ForwardLink;
+
+  while (Entry != &Tcb->RcvQue) {
+    //
+    // Coalesce the contiguous segments into one block.
+    //
+    Seg   = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    Left  = Seg->Seq;
+    Right = Seg->End;
+    Entry = Entry->ForwardLink;
+
+    while (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+      if (TCP_SEQ_GT (Seg->Seq, Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_GT (Seg->End, Right)) {
+        Right = Seg->End;
+      }
+
+      Entry = Entry->ForwardLink;
+    }
+
+    if (TCP_SEQ_LEQ (Left, Tcb->RcvNxt) || (Left == Right)) {
+      continue;
+    }
+
+    if (!Recent && TCP_SEQ_LEQ (Left, Tcb->RcvSackRecent) && TCP_SEQ_LT (Tcb->RcvSackRecent, Right)) {
+      //
+      // Put the block of the most recent segment in front.
+      //
+      Recent = TRUE;
+      CopyMem (&Block[1], &Block[0], MIN (Num, Max - 1) * sizeof (TCP_SACK_BLOCK));
+      Block[0].Left  = Left;
+      Block[0].Right = Right;
+      Num            = (UINT8)MIN (Num + 1, Max);
+    } else if (Num < Max) {
+      Block[Num].Left  = Left;
+      Block[Num].Right = Right;
+      Num++;
+    } else if (Recent) {
+      break;
+    }
+  }
+
+  return Num;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -187,8 +286,11 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK];
+  UINT8           Num;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -214,6 +316,37 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if there is out-of-order data queued. Only
+  // pure ACKs carry it, so the option never eats into the segment data.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (Nbuf->TotalSize == 0) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    Num = (UINT8)((TCP_OPTION_MAX_LEN - Len - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN);
+    Num = TcpGetSackBlock (Tcb, Block, MIN (Num, TCP_OPTION_MAX_SACK));
+
+    if (Num != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16)(Len + TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Num * TCP_OPTION_SACK_BLOCK_LEN));
+      for (Index = 0; Index < Num; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,6 +372,7 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
@@ -311,6 +445,39 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            (((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN) != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackNum = (UINT8)MIN ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN, TCP_OPTION_MAX_SACK);
+        for (Index = 0; Index < Option->SackNum; Index++) {
+          Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
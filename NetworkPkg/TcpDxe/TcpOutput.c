@@ -692,6 +692,10 @@ TcpRetransmit (
     Tcb->RetxmitSeqMax = Seq;
   }
 
+  if (TCP_SEQ_GT (TCPSEG_NETBUF (Nbuf)->End, Tcb->SackHighRxt)) {
+    Tcb->SackHighRxt = TCPSEG_NETBUF (Nbuf)->End;
+  }
+
   //
   // The retransmitted buffer may be on the SndQue,
   // trim TCP head because all the buffers on SndQue
@@ -712,6 +716,62 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the next hole of the SACK scoreboard, as the recovery
+  of RFC6675. A hole is a range not SACKed by the peer nor retransmitted
+  in this recovery, and below some SACKed data.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to start searching from.
+
+  @retval TRUE     A hole was found and retransmitted.
+  @retval FALSE    No hole to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  )
+{
+  UINT8  Index;
+
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) || (Tcb->SackNum == 0)) {
+    return FALSE;
+  }
+
+  if (TCP_SEQ_LT (Seq, Tcb->SackHighRxt)) {
+    Seq = Tcb->SackHighRxt;
+  }
+
+  //
+  // Skip over the SACKed ranges. The scoreboard is sorted,
+  // so Seq is in a hole once it is below the next range.
+  //
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Right)) {
+      Seq = Tcb->SackBlock[Index].Right;
+    }
+  }
+
+  if (Index == Tcb->SackNum) {
+    return FALSE;
+  }
+
+  DEBUG (
+    (DEBUG_NET,
+     "TcpSackRetransmit: retransmit the hole at %d for TCB %p\n",
+     Seq,
+     Tcb)
+    );
+
+  return (BOOLEAN)(TcpRetransmit (Tcb, Seq) == 0);
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
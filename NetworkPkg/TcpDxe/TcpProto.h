@@ -70,6 +70,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -123,6 +125,17 @@
 #define TCP_FIN_WAIT2_TIME_MAX    (4 * TCP_TICK_HZ)
 #define TCP_TIME_WAIT_TIME_MAX    (60 * TCP_TICK_HZ)
 
+//
+// Number of SACKed ranges the sender remembers, see RFC6675.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  8
+
+//
+// Congestion control algorithms, selected by PcdTcpCongestionControl.
+//
+#define TCP_CONGESTION_NEWRENO  0
+#define TCP_CONGESTION_CUBIC    1
+
 ///
 /// TCP_CONNECTED: both ends have synchronized their ISN.
 ///
@@ -216,6 +229,14 @@ typedef struct _TCP_SEG {
   UINT32       Wnd;  ///< TCP window size field.
 } TCP_SEG;
 
+///
+/// A block of contiguous sequence space, [Left, Right), as used by SACK.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of this block.
+  TCP_SEQNO    Right; ///< The sequence number immediately following the last one of this block.
+} TCP_SACK_BLOCK;
+
 ///
 /// Network endpoint, IP plus Port structure.
 ///
@@ -226,6 +247,60 @@ typedef struct _TCP_PEER {
 
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
+/**
+  Initialize the algorithm specific state of a congestion control algorithm.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_INIT) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Grow the congestion window on an ACK that acknowledges new data,
+  outside of fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of newly acknowledged bytes.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_ON_ACK) (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+/**
+  Compute the new slow start threshold on a congestion event, either
+  entering fast recovery or a retransmission timeout.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+typedef
+UINT32
+(*TCP_CONGEST_SSTHRESH) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+///
+/// Congestion control algorithm. Loss detection, fast retransmit and
+/// recovery are common to all algorithms; an algorithm only decides how
+/// the window grows and how much it is reduced.
+///
+typedef struct _TCP_CONGEST_OPS {
+  CHAR8                   *Name;
+  TCP_CONGEST_INIT        Init;
+  TCP_CONGEST_ON_ACK      OnAck;
+  TCP_CONGEST_SSTHRESH    Ssthresh;
+} TCP_CONGEST_OPS;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -305,6 +380,25 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               CongestState; ///< The current congestion state(RFC3782).
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
+  TCP_CONGEST_OPS     *CongestOps;  ///< The congestion control algorithm.
+
+  //
+  // RFC9438 CUBIC congestion control variables.
+  //
+  UINT32              CubicWMax;       ///< Window before the last reduction.
+  UINT32              CubicWLastMax;   ///< CubicWMax before the last reduction, for fast convergence.
+  UINT32              CubicEpochStart; ///< The tick congestion avoidance started, 0 if not started.
+  UINT32              CubicK;          ///< Time to grow back to CubicOrigin, in milliseconds.
+  UINT32              CubicOrigin;     ///< Window at the plateau of the cubic function.
+  UINT32              CubicWEst;       ///< Window estimated for Reno-friendly region.
+
+  //
+  // RFC2018 and RFC6675, selective acknowledgment.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Ranges SACKed by the peer, sorted and above SndUna.
+  UINT8               SackNum;                             ///< Number of valid ranges in SackBlock.
+  TCP_SEQNO           SackHighRxt;                         ///< Highest sequence retransmitted in recovery.
+  TCP_SEQNO           RcvSackRecent;                       ///< Sequence of the latest out-of-order segment.
 
   //
   // RFC7323
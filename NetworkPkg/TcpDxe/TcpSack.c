@@ -0,0 +1,181 @@
+/** @file
+  TCP SACK scoreboard of the sender, as specified in RFC6675.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Merge the range [Left, Right) into the SACK scoreboard, keeping it sorted
+  and the ranges disjoint. If the scoreboard is full, the highest range is
+  dropped.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number SACKed.
+  @param[in]       Right    The sequence number following the last one SACKed.
+
+**/
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  UINT8  Index;
+  UINT8  Last;
+
+  //
+  // Skip the ranges entirely before the new one, then absorb
+  // every range overlapping or adjacent to it.
+  //
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_GEQ (Tcb->SackBlock[Index].Right, Left)) {
+      break;
+    }
+  }
+
+  for (Last = Index; Last < Tcb->SackNum; Last++) {
+    if (TCP_SEQ_GT (Tcb->SackBlock[Last].Left, Right)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Tcb->SackBlock[Last].Left, Left)) {
+      Left = Tcb->SackBlock[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Tcb->SackBlock[Last].Right, Right)) {
+      Right = Tcb->SackBlock[Last].Right;
+    }
+  }
+
+  if (Last == Index) {
+    //
+    // Nothing absorbed, make room for a new range.
+    //
+    if (Tcb->SackNum == TCP_SACK_SCOREBOARD_SIZE) {
+      if (Index == Tcb->SackNum) {
+        return;
+      }
+
+      Tcb->SackNum--;
+    }
+
+    CopyMem (
+      &Tcb->SackBlock[Index + 1],
+      &Tcb->SackBlock[Index],
+      (Tcb->SackNum - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackNum++;
+  } else if (Last > Index + 1) {
+    CopyMem (
+      &Tcb->SackBlock[Index + 1],
+      &Tcb->SackBlock[Last],
+      (Tcb->SackNum - Last) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackNum = (UINT8)(Tcb->SackNum - (Last - Index - 1));
+  }
+
+  Tcb->SackBlock[Index].Left  = Left;
+  Tcb->SackBlock[Index].Right = Right;
+}
+
+/**
+  Update the SACK scoreboard with an incoming ACK as specified in RFC6675.
+  Ranges cumulatively acknowledged by Ack are removed, and the blocks
+  of a SACK option are merged in.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+  @param[in]       Option   Pointer to the options of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+  UINT8      Index;
+  UINT8      Num;
+
+  Num = 0;
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Ack)) {
+      continue;
+    }
+
+    Tcb->SackBlock[Num].Left  = Tcb->SackBlock[Index].Left;
+    Tcb->SackBlock[Num].Right = Tcb->SackBlock[Index].Right;
+    if (TCP_SEQ_LT (Tcb->SackBlock[Num].Left, Ack)) {
+      Tcb->SackBlock[Num].Left = Ack;
+    }
+
+    Num++;
+  }
+
+  Tcb->SackNum = Num;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    Left  = Option->Sack[Index].Left;
+    Right = Option->Sack[Index].Right;
+
+    //
+    // Ignore the blocks already acknowledged (D-SACK) or out of
+    // the data ever sent.
+    //
+    if (TCP_SEQ_GEQ (Left, Right) ||
+        TCP_SEQ_LEQ (Right, Ack) ||
+        TCP_SEQ_GT (Right, Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Ack)) {
+      Left = Ack;
+    }
+
+    TcpSackInsert (Tcb, Left, Right);
+  }
+}
+
+/**
+  Check whether the first unacknowledged segment is deemed lost by the
+  SACK information, that is, more than two segments or three discontiguous
+  ranges above it have been SACKed (RFC6675 IsLost).
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @retval TRUE         The first unacknowledged segment is lost.
+  @retval FALSE        There is not enough evidence of a loss.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN TCP_CB  *Tcb
+  )
+{
+  UINT32  Sacked;
+  UINT8   Index;
+
+  if (Tcb->SackNum >= 3) {
+    return TRUE;
+  }
+
+  Sacked = 0;
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    Sacked += TCP_SUB_SEQ (Tcb->SackBlock[Index].Right, Tcb->SackBlock[Index].Left);
+  }
+
+  return (BOOLEAN)(Sacked > 2 * (UINT32)Tcb->SndMss);
+}
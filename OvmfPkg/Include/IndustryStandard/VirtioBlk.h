@@ -34,6 +34,9 @@ typedef struct {
   UINT8                  Sectors;
   UINT32                 BlkSize;
   VIRTIO_BLK_TOPOLOGY    Topology;
+  UINT8                  WriteBack;
+  UINT8                  Unused0;
+  UINT16                 NumQueues;   // virtio-1.0+, with VIRTIO_BLK_F_MQ
 } VIRTIO_BLK_CONFIG;
 #pragma pack()
 
@@ -53,6 +56,7 @@ typedef struct {
 #define VIRTIO_BLK_F_SCSI      BIT7
 #define VIRTIO_BLK_F_FLUSH     BIT9  // identical to "write cache enabled"
 #define VIRTIO_BLK_F_TOPOLOGY  BIT10 // information on optimal I/O alignment
+#define VIRTIO_BLK_F_MQ        BIT12 // NumQueues request virtqueues
 
 //
 // We keep the status byte separate from the rest of the virtio-blk request
@@ -210,6 +210,147 @@ VirtioFlush (
   OUT    UINT32                  *UsedLen    OPTIONAL
   );
 
+//
+// Internal use structure for tracking descriptor chains that are submitted
+// in batches and reaped asynchronously. Unlike the VirtioPrepare() /
+// VirtioFlush() pair, this allows for multiple in-flight descriptor chains;
+// the calling driver owns the descriptor table layout.
+//
+typedef struct {
+  UINT16    NextAvailIdx; // where the next queued chain's head goes
+  UINT16    LastUsedIdx;  // the next used element to reap
+} RING_INDICES;
+
+/**
+
+  Initialize the asynchronous submission state of a virtio ring, and turn off
+  interrupt notifications from the host.
+
+  The calling driver must call this function after VirtioRingInit(), before
+  submitting the first descriptor chain with VirtioQueueChain().
+
+  @param[in,out] Ring         The virtio ring to submit descriptor chains to.
+
+  @param[out]    RingIndices  The RING_INDICES structure to initialize.
+
+**/
+VOID
+EFIAPI
+VirtioInitRingIndices (
+  IN OUT VRING         *Ring,
+  OUT    RING_INDICES  *RingIndices
+  );
+
+/**
+
+  Prepare for appending a descriptor chain at a caller-selected position of
+  the descriptor table.
+
+  The calling driver is responsible for not overlapping descriptor chains
+  that are in flight at the same time.
+
+  @param[in]  Ring         The virtio ring we intend to append descriptors
+                           to.
+
+  @param[in]  HeadDescIdx  The index of the head descriptor of the chain.
+
+  @param[out] Indices      The DESC_INDICES structure to initialize.
+
+**/
+VOID
+EFIAPI
+VirtioPrepareChain (
+  IN     VRING         *Ring,
+  IN     UINT16        HeadDescIdx,
+  OUT    DESC_INDICES  *Indices
+  );
+
+/**
+
+  Make the descriptor chain just built available to the host, without
+  notifying the host.
+
+  The chain becomes visible to the host at the next VirtioKick(), together
+  with all other chains queued since the previous VirtioKick().
+
+  @param[in,out] Ring         The virtio ring with descriptors to submit.
+
+  @param[in]     Indices      Indices->NextDescIdx is not accessed.
+                              Indices->HeadDescIdx identifies the head
+                              descriptor of the descriptor chain.
+
+  @param[in,out] RingIndices  The asynchronous submission state of Ring.
+
+**/
+VOID
+EFIAPI
+VirtioQueueChain (
+  IN OUT VRING         *Ring,
+  IN     DESC_INDICES  *Indices,
+  IN OUT RING_INDICES  *RingIndices
+  );
+
+/**
+
+  Publish all descriptor chains queued with VirtioQueueChain() since the
+  previous call, and notify the host about them with a single notification.
+
+  The notification is skipped if no chain was queued, or if the host asked
+  not to be notified.
+
+  @param[in]     VirtIo       The target virtio device to notify.
+
+  @param[in]     VirtQueueId  Identifies the queue for the target device.
+
+  @param[in,out] Ring         The virtio ring with descriptors to submit.
+
+  @param[in]     RingIndices  The asynchronous submission state of Ring.
+
+  @return              Error code from VirtIo->SetQueueNotify() if it fails.
+
+  @retval EFI_SUCCESS  Otherwise.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioKick (
+  IN     VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN     UINT16                  VirtQueueId,
+  IN OUT VRING                   *Ring,
+  IN     RING_INDICES            *RingIndices
+  );
+
+/**
+
+  Fetch the next descriptor chain that the host has processed, without
+  waiting.
+
+  @param[in]     Ring         The virtio ring to reap.
+
+  @param[in,out] RingIndices  The asynchronous submission state of Ring.
+
+  @param[out]    HeadDescIdx  The head descriptor index of the processed
+                              descriptor chain.
+
+  @param[out]    UsedLen      The total number of bytes that the host wrote
+                              to the buffers of the descriptor chain. May be
+                              NULL.
+
+  @retval EFI_SUCCESS    A processed descriptor chain has been reaped.
+
+  @retval EFI_NOT_READY  The host has not processed further descriptor
+                         chains.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioReapChain (
+  IN     VRING         *Ring,
+  IN OUT RING_INDICES  *RingIndices,
+  OUT    UINT16        *HeadDescIdx,
+  OUT    UINT32        *UsedLen      OPTIONAL
+  );
+
 /**
 
   Report the feature bits to the VirtIo 1.0 device that the VirtIo 1.0 driver
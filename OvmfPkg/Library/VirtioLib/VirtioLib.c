@@ -349,6 +349,205 @@ VirtioFlush (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Initialize the asynchronous submission state of a virtio ring, and turn off
+  interrupt notifications from the host.
+
+  The calling driver must call this function after VirtioRingInit(), before
+  submitting the first descriptor chain with VirtioQueueChain().
+
+  @param[in,out] Ring         The virtio ring to submit descriptor chains to.
+
+  @param[out]    RingIndices  The RING_INDICES structure to initialize.
+
+**/
+VOID
+EFIAPI
+VirtioInitRingIndices (
+  IN OUT VRING         *Ring,
+  OUT    RING_INDICES  *RingIndices
+  )
+{
+  //
+  // Completions are going to be polled for; the host should not send an
+  // interrupt.
+  //
+  *Ring->Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+
+  RingIndices->NextAvailIdx = *Ring->Avail.Idx;
+  RingIndices->LastUsedIdx  = *Ring->Used.Idx;
+}
+
+/**
+
+  Prepare for appending a descriptor chain at a caller-selected position of
+  the descriptor table.
+
+  The calling driver is responsible for not overlapping descriptor chains
+  that are in flight at the same time.
+
+  @param[in]  Ring         The virtio ring we intend to append descriptors
+                           to.
+
+  @param[in]  HeadDescIdx  The index of the head descriptor of the chain.
+
+  @param[out] Indices      The DESC_INDICES structure to initialize.
+
+**/
+VOID
+EFIAPI
+VirtioPrepareChain (
+  IN     VRING         *Ring,
+  IN     UINT16        HeadDescIdx,
+  OUT    DESC_INDICES  *Indices
+  )
+{
+  ASSERT (HeadDescIdx < Ring->QueueSize);
+
+  Indices->HeadDescIdx = HeadDescIdx;
+  Indices->NextDescIdx = HeadDescIdx;
+}
+
+/**
+
+  Make the descriptor chain just built available to the host, without
+  notifying the host.
+
+  The chain becomes visible to the host at the next VirtioKick(), together
+  with all other chains queued since the previous VirtioKick().
+
+  @param[in,out] Ring         The virtio ring with descriptors to submit.
+
+  @param[in]     Indices      Indices->NextDescIdx is not accessed.
+                              Indices->HeadDescIdx identifies the head
+                              descriptor of the descriptor chain.
+
+  @param[in,out] RingIndices  The asynchronous submission state of Ring.
+
+**/
+VOID
+EFIAPI
+VirtioQueueChain (
+  IN OUT VRING         *Ring,
+  IN     DESC_INDICES  *Indices,
+  IN OUT RING_INDICES  *RingIndices
+  )
+{
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
+  //
+  // The chains in flight cannot outnumber the ring entries.
+  //
+  ASSERT ((UINT16)(RingIndices->NextAvailIdx - RingIndices->LastUsedIdx) <
+          Ring->QueueSize);
+
+  Ring->Avail.Ring[RingIndices->NextAvailIdx++ % Ring->QueueSize] =
+    Indices->HeadDescIdx % Ring->QueueSize;
+}
+
+/**
+
+  Publish all descriptor chains queued with VirtioQueueChain() since the
+  previous call, and notify the host about them with a single notification.
+
+  The notification is skipped if no chain was queued, or if the host asked
+  not to be notified.
+
+  @param[in]     VirtIo       The target virtio device to notify.
+
+  @param[in]     VirtQueueId  Identifies the queue for the target device.
+
+  @param[in,out] Ring         The virtio ring with descriptors to submit.
+
+  @param[in]     RingIndices  The asynchronous submission state of Ring.
+
+  @return              Error code from VirtIo->SetQueueNotify() if it fails.
+
+  @retval EFI_SUCCESS  Otherwise.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioKick (
+  IN     VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN     UINT16                  VirtQueueId,
+  IN OUT VRING                   *Ring,
+  IN     RING_INDICES            *RingIndices
+  )
+{
+  if (*Ring->Avail.Idx == RingIndices->NextAvailIdx) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
+  //
+  MemoryFence ();
+  *Ring->Avail.Idx = RingIndices->NextAvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
+  //
+  MemoryFence ();
+  if ((*Ring->Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return VirtIo->SetQueueNotify (VirtIo, VirtQueueId);
+}
+
+/**
+
+  Fetch the next descriptor chain that the host has processed, without
+  waiting.
+
+  @param[in]     Ring         The virtio ring to reap.
+
+  @param[in,out] RingIndices  The asynchronous submission state of Ring.
+
+  @param[out]    HeadDescIdx  The head descriptor index of the processed
+                              descriptor chain.
+
+  @param[out]    UsedLen      The total number of bytes that the host wrote
+                              to the buffers of the descriptor chain. May be
+                              NULL.
+
+  @retval EFI_SUCCESS    A processed descriptor chain has been reaped.
+
+  @retval EFI_NOT_READY  The host has not processed further descriptor
+                         chains.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioReapChain (
+  IN     VRING         *Ring,
+  IN OUT RING_INDICES  *RingIndices,
+  OUT    UINT16        *HeadDescIdx,
+  OUT    UINT32        *UsedLen      OPTIONAL
+  )
+{
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  if (*Ring->Used.Idx == RingIndices->LastUsedIdx) {
+    return EFI_NOT_READY;
+  }
+
+  MemoryFence ();
+  UsedElem     = &Ring->Used.UsedElem[RingIndices->LastUsedIdx++ % Ring->QueueSize];
+  *HeadDescIdx = (UINT16)UsedElem->Id;
+  if (UsedLen != NULL) {
+    *UsedLen = UsedElem->Len;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Report the feature bits to the VirtIo 1.0 device that the VirtIo 1.0 driver
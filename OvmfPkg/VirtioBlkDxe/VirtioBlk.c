@@ -6,9 +6,9 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - Non-blocking EFI_BLOCK_IO2_PROTOCOL requests are kept in flight on up to
+    VBLK_MAX_QUEUES request virtqueues (VIRTIO_BLK_F_MQ), and completed by a
+    timer polling the used rings. Blocking requests share the same queues.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -177,92 +177,84 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
+  Complete a virtio-blk request.
 
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
-  - VerifyReadWriteRequest() (for read/write only).
-
-  Parameters handled commonly:
+  Non-blocking requests report Status through their token and are released.
+  Blocking requests are only marked completed; their submitter releases them.
 
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
+  @param[in out] Dev     The virtio-blk device the request was targeted at.
 
-  Flush request:
+  @param[in]     Req     The request to complete.
 
-    @param[in] Lba             Must be zero.
+  @param[in]     Status  The transaction status of the request.
 
-    @param[in] BufferSize      Must be zero.
+**/
+STATIC
+VOID
+VirtioBlkCompleteRequest (
+  IN OUT VBLK_DEV      *Dev,
+  IN     VBLK_REQUEST  *Req,
+  IN     EFI_STATUS    Status
+  )
+{
+  if (Req->Token != NULL) {
+    Req->Token->TransactionStatus = Status;
+    gBS->SignalEvent (Req->Token->Event);
+    FreePool (Req);
+    return;
+  }
 
-    @param[in out] Buffer      Ignored by the function.
+  Req->Status    = Status;
+  Req->Completed = TRUE;
+}
 
-    @param[in] RequestIsWrite  Must be TRUE.
+/**
 
-  Read/Write request:
+  Format a read / write / flush request as up to three consecutive virtio
+  descriptors in a free slot of a virtqueue, and make it available to the
+  host. The host is not notified; that is up to the caller.
 
-    @param[in] Lba             Logical Block Address: number of logical blocks
-                               to skip from the beginning of the device.
+  The request parameters must have been verified by
+  - specific checks in ReadBlocks[Ex]() / WriteBlocks[Ex]() /
+    FlushBlocks[Ex](), and
+  - VerifyReadWriteRequest() (for read/write only).
 
-    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
-                               is responsible to ensure this parameter is
-                               positive.
+  A flush request has zero Lba and BufferSize, and RequestIsWrite set.
 
-    @param[in out] Buffer      The guest side area to read data from the device
-                               into, or write data to the device from.
+  Must be called at TPL_NOTIFY.
 
-    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
-                               device.
+  @param[in out] Dev    The virtio-blk device the request is targeted at.
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
+  @param[in out] Queue  The virtqueue to post the request to. The queue must
+                        have a free slot.
 
+  @param[in]     Req    The request to post.
 
-  @retval EFI_SUCCESS          Transfer complete.
+  @retval EFI_SUCCESS       The request has been made available to the host.
 
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+  @retval EFI_DEVICE_ERROR  No slot of the queue is free, or failed to map the
+                            data buffer for a bus master operation. The
+                            request has not been posted.
 
 **/
 STATIC
 EFI_STATUS
-EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV  *Dev,
-  IN              EFI_LBA   Lba,
-  IN              UINTN     BufferSize,
-  IN OUT volatile VOID      *Buffer,
-  IN              BOOLEAN   RequestIsWrite
+VirtioBlkPostRequest (
+  IN OUT VBLK_DEV      *Dev,
+  IN OUT VBLK_QUEUE    *Queue,
+  IN     VBLK_REQUEST  *Req
   )
 {
-  UINT32                   BlockSize;
-  volatile VIRTIO_BLK_REQ  *Request;
-  volatile UINT8           *HostStatus;
-  VOID                     *HostStatusBuffer;
-  DESC_INDICES             Indices;
-  VOID                     *RequestMapping;
-  VOID                     *StatusMapping;
-  VOID                     *BufferMapping;
-  EFI_PHYSICAL_ADDRESS     BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     RequestDeviceAddress;
-  EFI_STATUS               Status;
-  EFI_STATUS               UnmapStatus;
+  UINT32                BlockSize;
+  UINT16                Slot;
+  DESC_INDICES          Indices;
+  VBLK_SHARED_SLOT      *Shared;
+  EFI_PHYSICAL_ADDRESS  SharedDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  EFI_STATUS            Status;
 
   BlockSize = Dev->BlockIoMedia.BlockSize;
 
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
-
   //
   // ensured by VirtioBlkInit()
   //
@@ -272,201 +264,423 @@ SynchronousRequest (
   //
   // ensured by contract above, plus VerifyReadWriteRequest()
   //
-  ASSERT (BufferSize % BlockSize == 0);
+  ASSERT (Req->BufferSize % BlockSize == 0);
+  ASSERT (Queue->FreeSlots > 0);
 
-  Request = AllocateZeroPool (sizeof (*Request));
-  if (Request == NULL) {
-    return EFI_DEVICE_ERROR;
-  }
-
-  //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request->Type = RequestIsWrite ?
-                  (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                  VIRTIO_BLK_T_IN;
-  Request->IoPrio = 0;
-  Request->Sector = MultU64x32 (Lba, BlockSize / 512);
-
-  //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeBlkRequest;
+  for (Slot = 0; Slot < Queue->NumSlots; Slot++) {
+    if (Queue->InFlight[Slot] == NULL) {
+      break;
+    }
   }
 
-  HostStatus = HostStatusBuffer;
-
   //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
+  // FreeSlots doesn't match InFlight[]
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)Request,
-             sizeof (*Request),
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
+  ASSERT (Slot < Queue->NumSlots);
+  if (Slot == Queue->NumSlots) {
+    return EFI_DEVICE_ERROR;
   }
 
   //
   // Map data buffer
   //
-  if (BufferSize > 0) {
+  BufferDeviceAddress = 0;
+  Req->BufferMapping  = NULL;
+  if (Req->BufferSize > 0) {
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
-               (RequestIsWrite ?
+               (Req->RequestIsWrite ?
                 VirtioOperationBusMasterRead :
                 VirtioOperationBusMasterWrite),
-               (VOID *)Buffer,
-               BufferSize,
+               Req->Buffer,
+               Req->BufferSize,
                &BufferDeviceAddress,
-               &BufferMapping
+               &Req->BufferMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
+      return EFI_DEVICE_ERROR;
     }
   }
 
-  //
-  // preset a host status for ourselves that we do not accept as success
-  //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
+  Queue->InFlight[Slot] = Req;
+  Queue->FreeSlots--;
+  Dev->InFlightCount++;
 
   //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
+  // Prepare virtio-blk request header, setting zero size for flush.
+  // IO Priority is homogeneously 0. Preset a host status for ourselves that
+  // we do not accept as success.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
-  }
-
-  VirtioPrepare (&Dev->Ring, &Indices);
+  Shared                 = &Queue->Shared[Slot];
+  SharedDeviceAddress    = Queue->SharedDeviceAddr + Slot * sizeof *Shared;
+  Shared->Request.Type   = Req->RequestIsWrite ?
+                           (Req->BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
+                           VIRTIO_BLK_T_IN;
+  Shared->Request.IoPrio = 0;
+  Shared->Request.Sector = MultU64x32 (Req->Lba, BlockSize / 512);
+  Shared->HostStatus     = VIRTIO_BLK_S_IOERR;
 
   //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
+  // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
   //
-  ASSERT (Dev->Ring.QueueSize >= 3);
-
-  //
-  // virtio-blk header in first desc
+  // virtio-blk header in first desc, data buffer for read/write in second
+  // desc, host status in last desc. VRING_DESC_F_WRITE is interpreted from
+  // the host's point of view.
   //
+  VirtioPrepareChain (&Queue->Ring, (UINT16)(Slot * VBLK_DESC_PER_SLOT), &Indices);
+
   VirtioAppendDesc (
-    &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof (*Request),
+    &Queue->Ring,
+    SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_SLOT, Request),
+    sizeof Shared->Request,
     VRING_DESC_F_NEXT,
     &Indices
     );
 
-  //
-  // data buffer for read/write in second desc
-  //
-  if (BufferSize > 0) {
+  if (Req->BufferSize > 0) {
     //
     // From virtio-0.9.5, 2.3.2 Descriptor Table:
     // "no descriptor chain may be more than 2^32 bytes long in total".
     //
-    // The predicate is ensured by the call contract above (for flush), or
-    // VerifyReadWriteRequest() (for read/write). It also implies that
-    // converting BufferSize to UINT32 will not truncate it.
+    // The predicate is ensured by VerifyReadWriteRequest(). It also implies
+    // that converting BufferSize to UINT32 will not truncate it.
     //
-    ASSERT (BufferSize <= SIZE_1GB);
+    ASSERT (Req->BufferSize <= SIZE_1GB);
 
-    //
-    // VRING_DESC_F_WRITE is interpreted from the host's point of view.
-    //
     VirtioAppendDesc (
-      &Dev->Ring,
+      &Queue->Ring,
       BufferDeviceAddress,
-      (UINT32)BufferSize,
-      VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
+      (UINT32)Req->BufferSize,
+      VRING_DESC_F_NEXT | (Req->RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
       &Indices
       );
   }
 
-  //
-  // host status in last (second or third) desc
-  //
   VirtioAppendDesc (
-    &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
+    &Queue->Ring,
+    SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_SLOT, HostStatus),
+    sizeof Shared->HostStatus,
     VRING_DESC_F_WRITE,
     &Indices
     );
 
   //
-  // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
+  // The host learns about the request at the next VirtioKick().
   //
-  if ((VirtioFlush (
-         Dev->VirtIo,
-         0,
-         &Dev->Ring,
-         &Indices,
-         NULL
-         ) == EFI_SUCCESS) &&
-      (*HostStatus == VIRTIO_BLK_S_OK))
-  {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
+  VirtioQueueChain (&Queue->Ring, &Indices, &Queue->RingIndices);
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Reap the requests the host has completed on a virtqueue.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev    The virtio-blk device.
+
+  @param[in out] Queue  The virtqueue to reap.
+
+**/
+STATIC
+VOID
+VirtioBlkReapQueue (
+  IN OUT VBLK_DEV    *Dev,
+  IN OUT VBLK_QUEUE  *Queue
+  )
+{
+  VBLK_REQUEST  *Req;
+  UINT16        HeadDescIdx;
+  UINT16        Slot;
+  UINT8         HostStatus;
+  EFI_STATUS    Status;
+  EFI_STATUS    UnmapStatus;
+
+  for ( ; ;) {
+    Status = VirtioReapChain (
+               &Queue->Ring,
+               &Queue->RingIndices,
+               &HeadDescIdx,
+               NULL          // UsedLen
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Slot = HeadDescIdx / VBLK_DESC_PER_SLOT;
+    if ((Slot >= Queue->NumSlots) || (Queue->InFlight[Slot] == NULL)) {
+      ASSERT (FALSE);
+      continue;
+    }
+
+    Req                   = Queue->InFlight[Slot];
+    HostStatus            = Queue->Shared[Slot].HostStatus;
+    Queue->InFlight[Slot] = NULL;
+    Queue->FreeSlots++;
+    Dev->InFlightCount--;
+
+    Status = (HostStatus == VIRTIO_BLK_S_OK) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+
+    if (Req->BufferSize > 0) {
+      UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->BufferMapping);
+      if (EFI_ERROR (UnmapStatus) && !Req->RequestIsWrite) {
+        //
+        // Data from the bus master may not reach the caller; fail the request.
+        //
+        Status = EFI_DEVICE_ERROR;
+      }
+    }
+
+    VirtioBlkCompleteRequest (Dev, Req, Status);
   }
+}
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+/**
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
+  Drive all virtqueues of a virtio-blk device: reap completed requests, post
+  pending requests to free slots, and notify the host of new requests.
+
+  Pending requests are posted in submission order, spread over the virtqueues
+  with the most free slots. A flush request is only posted after all requests
+  submitted before it have completed.
+
+  The poll timer runs while any request is outstanding.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkProcessQueues (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  VBLK_QUEUE    *Queue;
+  VBLK_REQUEST  *Req;
+  UINT16        Index;
+  EFI_STATUS    Status;
+  BOOLEAN       Outstanding;
+
+  for (Index = 0; Index < Dev->NumQueues; Index++) {
+    VirtioBlkReapQueue (Dev, &Dev->Queues[Index]);
+  }
+
+  while (!IsListEmpty (&Dev->PendingList)) {
+    Req = CR (Dev->PendingList.ForwardLink, VBLK_REQUEST, Link, VBLK_REQ_SIG);
+    if ((Req->BufferSize == 0) && (Dev->InFlightCount > 0)) {
+      break;
+    }
+
+    Queue = &Dev->Queues[0];
+    for (Index = 1; Index < Dev->NumQueues; Index++) {
+      if (Dev->Queues[Index].FreeSlots > Queue->FreeSlots) {
+        Queue = &Dev->Queues[Index];
+      }
     }
+
+    if (Queue->FreeSlots == 0) {
+      break;
+    }
+
+    RemoveEntryList (&Req->Link);
+    Status = VirtioBlkPostRequest (Dev, Queue, Req);
+    if (EFI_ERROR (Status)) {
+      VirtioBlkCompleteRequest (Dev, Req, Status);
+    }
+  }
+
+  //
+  // One notification per virtqueue covers all requests posted above.
+  //
+  for (Index = 0; Index < Dev->NumQueues; Index++) {
+    Queue = &Dev->Queues[Index];
+    VirtioKick (Dev->VirtIo, Queue->QueueIndex, &Queue->Ring, &Queue->RingIndices);
+  }
+
+  Outstanding = (BOOLEAN)(Dev->InFlightCount > 0 || !IsListEmpty (&Dev->PendingList));
+  if (Outstanding != Dev->PollTimerArmed) {
+    gBS->SetTimer (
+           Dev->PollTimer,
+           Outstanding ? TimerPeriodic : TimerCancel,
+           VBLK_POLL_PERIOD
+           );
+    Dev->PollTimerArmed = Outstanding;
+  }
+}
+
+/**
+
+  Timer notification function reaping completed requests and posting pending
+  ones.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkPollTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VirtioBlkProcessQueues (Context);
+}
+
+/**
+
+  Submit a read / write / flush request, and for blocking requests, poll for
+  the response.
+
+  The function may only be called after the request parameters have been
+  verified, see VirtioBlkPostRequest().
+
+  @param[in] Dev             The virtio-blk device the request is targeted at.
+
+  @param[in] Lba             Logical Block Address: number of logical blocks
+                             to skip from the beginning of the device. Zero for
+                             flush.
+
+  @param[in] BufferSize      Size of buffer to transfer, in bytes. Zero for
+                             flush.
+
+  @param[in out] Buffer      The guest side area to read data from the device
+                             into, or write data to the device from. Ignored
+                             for flush.
+
+  @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to device,
+                             or for flush.
+
+  @param[in out] Token       The EFI_BLOCK_IO2_TOKEN to signal on completion,
+                             for non-blocking requests. NULL for blocking
+                             requests.
+
+  Return values are appropriate to be forwarded by the EFI_BLOCK_IO_PROTOCOL
+  and EFI_BLOCK_IO2_PROTOCOL functions.
+
+  @retval EFI_SUCCESS           Transfer complete (blocking), or request
+                                queued (non-blocking).
+
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the request (non-blocking).
+
+  @retval EFI_DEVICE_ERROR      Failed to allocate the request (blocking), or
+                                failed to map Buffer for a bus master
+                                operation, or host response is not
+                                VIRTIO_BLK_S_OK, or unable to parse host
+                                response.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkSubmitRequest (
+  IN     VBLK_DEV             *Dev,
+  IN     EFI_LBA              Lba,
+  IN     UINTN                BufferSize,
+  IN OUT VOID                 *Buffer,
+  IN     BOOLEAN              RequestIsWrite,
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token OPTIONAL
+  )
+{
+  VBLK_REQUEST  *Req;
+  EFI_TPL       OldTpl;
+  BOOLEAN       Completed;
+  UINTN         PollPeriodUsecs;
+  EFI_STATUS    Status;
+
+  Req = AllocateZeroPool (sizeof *Req);
+  if (Req == NULL) {
+    return (Token != NULL) ? EFI_OUT_OF_RESOURCES : EFI_DEVICE_ERROR;
+  }
+
+  Req->Signature      = VBLK_REQ_SIG;
+  Req->Token          = Token;
+  Req->Lba            = Lba;
+  Req->BufferSize     = BufferSize;
+  Req->Buffer         = Buffer;
+  Req->RequestIsWrite = RequestIsWrite;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Dev->PendingList, &Req->Link);
+  VirtioBlkProcessQueues (Dev);
+  gBS->RestoreTPL (OldTpl);
+
+  if (Token != NULL) {
+    return EFI_SUCCESS;
   }
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  //
+  // Wait until the host processes and acknowledges the request. Keep slowing
+  // down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkProcessQueues (Dev);
+    Completed = Req->Completed;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Completed) {
+      break;
+    }
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+    gBS->Stall (PollPeriodUsecs);
 
-FreeBlkRequest:
-  FreePool ((VOID *)Request);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
 
+  Status = Req->Status;
+  FreePool (Req);
   return Status;
 }
 
+/**
+
+  Abort the requests not yet posted to a virtqueue, and wait until the host
+  completes all posted requests.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkDrain (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  VBLK_REQUEST  *Req;
+  EFI_TPL       OldTpl;
+  UINTN         InFlightCount;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (!IsListEmpty (&Dev->PendingList)) {
+    Req = CR (Dev->PendingList.ForwardLink, VBLK_REQUEST, Link, VBLK_REQ_SIG);
+    RemoveEntryList (&Req->Link);
+    VirtioBlkCompleteRequest (Dev, Req, EFI_ABORTED);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkProcessQueues (Dev);
+    InFlightCount = Dev->InFlightCount;
+    gBS->RestoreTPL (OldTpl);
+
+    if (InFlightCount == 0) {
+      break;
+    }
+
+    gBS->Stall (1024);
+  }
+}
+
 /**
 
   ReadBlocks() operation for virtio-blk.
@@ -478,7 +692,7 @@ FreeBlkRequest:
     ReadBlocksEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkSubmitRequest().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -512,12 +726,13 @@ VirtioBlkReadBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkSubmitRequest (
            Dev,
            Lba,
            BufferSize,
            Buffer,
-           FALSE       // RequestIsWrite
+           FALSE,      // RequestIsWrite
+           NULL        // Token
            );
 }
 
@@ -532,7 +747,7 @@ VirtioBlkReadBlocks (
     WriteBlockEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkSubmitRequest().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -566,12 +781,13 @@ VirtioBlkWriteBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkSubmitRequest (
            Dev,
            Lba,
            BufferSize,
            Buffer,
-           TRUE        // RequestIsWrite
+           TRUE,       // RequestIsWrite
+           NULL        // Token
            );
 }
 
@@ -601,16 +817,208 @@ VirtioBlkFlushBlocks (
 
   Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
   return Dev->BlockIoMedia.WriteCaching ?
-         SynchronousRequest (
+         VirtioBlkSubmitRequest (
            Dev,
            0,      // Lba
            0,      // BufferSize
            NULL,   // Buffer
-           TRUE    // RequestIsWrite
+           TRUE,   // RequestIsWrite
+           NULL    // Token
            ) :
          EFI_SUCCESS;
 }
 
+/**
+
+  Reset() operation for the Block I/O 2 interface of virtio-blk.
+
+  Requests that have not been posted to the device yet are aborted, and the
+  function waits until the device completes the posted ones.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  VirtioBlkDrain (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Common part of ReadBlocksEx() and WriteBlocksEx() for virtio-blk.
+
+  See
+  - UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx() and
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+
+  Parameter checks and conformant return values are implemented in
+  VerifyReadWriteRequest() and VirtioBlkSubmitRequest().
+
+  A zero BufferSize completes the request successfully right away.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkReadWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN OUT VOID                    *Buffer,
+  IN     BOOLEAN                 RequestIsWrite
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (MediaId != Dev->BlockIoMedia.MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if (Buffer == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Token != NULL) && (Token->Event == NULL)) {
+    Token = NULL;
+  }
+
+  if (BufferSize == 0) {
+    if (Token != NULL) {
+      Token->TransactionStatus = EFI_SUCCESS;
+      gBS->SignalEvent (Token->Event);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return VirtioBlkSubmitRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           RequestIsWrite,
+           Token
+           );
+}
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See VirtioBlkReadWriteBlocksEx().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  return VirtioBlkReadWriteBlocksEx (
+           This,
+           MediaId,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           FALSE     // RequestIsWrite
+           );
+}
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See VirtioBlkReadWriteBlocksEx().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  return VirtioBlkReadWriteBlocksEx (
+           This,
+           MediaId,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           TRUE      // RequestIsWrite
+           );
+}
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  The flush request is only posted to the device after all requests submitted
+  before it have completed. Without write-caching, the request completes
+  successfully right away, as in VirtioBlkFlushBlocks().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  VBLK_DEV  *Dev;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if ((Token != NULL) && (Token->Event == NULL)) {
+    Token = NULL;
+  }
+
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    if (Token != NULL) {
+      Token->TransactionStatus = EFI_SUCCESS;
+      gBS->SignalEvent (Token->Event);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  return VirtioBlkSubmitRequest (
+           Dev,
+           0,      // Lba
+           0,      // BufferSize
+           NULL,   // Buffer
+           TRUE,   // RequestIsWrite
+           Token
+           );
+}
+
 /**
 
   Device probe function for this driver.
@@ -694,6 +1102,190 @@ VirtioBlkDriverBindingSupported (
   return Status;
 }
 
+/**
+
+  Set up one request virtqueue of a virtio-blk device.
+
+  @param[in out] Dev         The driver instance being configured.
+
+  @param[in]     QueueIndex  The index of the virtqueue to set up; the
+                             corresponding element of Dev->Queues is
+                             initialized.
+
+  @retval EFI_SUCCESS           The virtqueue has been set up.
+
+  @retval EFI_UNSUPPORTED       The virtqueue is too small.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       Error codes from VirtioRingInit(),
+                                VirtioRingMap(),
+                                VirtioMapAllBytesInSharedBuffer() or the
+                                VIRTIO_DEVICE_PROTOCOL member functions.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkInitQueue (
+  IN OUT VBLK_DEV  *Dev,
+  IN     UINT16    QueueIndex
+  )
+{
+  VBLK_QUEUE  *Queue;
+  UINT16      QueueSize;
+  UINT64      RingBaseShift;
+  EFI_STATUS  Status;
+
+  Queue = &Dev->Queues[QueueIndex];
+  ZeroMem (Queue, sizeof *Queue);
+  Queue->QueueIndex = QueueIndex;
+
+  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, QueueIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (QueueSize < VBLK_DESC_PER_SLOT) {
+    //
+    // VirtioBlkPostRequest() uses three descriptors per request
+    //
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Queue->Ring);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // If anything fails from here on, we must release the ring resources
+  //
+  Status = VirtioRingMap (
+             Dev->VirtIo,
+             &Queue->Ring,
+             &RingBaseShift,
+             &Queue->RingMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto ReleaseQueue;
+  }
+
+  //
+  // Additional steps for MMIO: align the queue appropriately, and set the
+  // size. If anything fails from here on, we must unmap the ring resources.
+  //
+  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  //
+  // Report GPFN (guest-physical frame number) of queue.
+  //
+  Status = Dev->VirtIo->SetQueueAddress (
+                          Dev->VirtIo,
+                          &Queue->Ring,
+                          RingBaseShift
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  //
+  // We reap completions by polling.
+  //
+  VirtioInitRingIndices (&Queue->Ring, &Queue->RingIndices);
+
+  //
+  // Allocate and map the request headers and host status bytes of all slots
+  // at once, so that posting a request needs no further mapping beyond the
+  // data buffer.
+  //
+  Queue->NumSlots    = QueueSize / VBLK_DESC_PER_SLOT;
+  Queue->FreeSlots   = Queue->NumSlots;
+  Queue->SharedPages = EFI_SIZE_TO_PAGES (Queue->NumSlots * sizeof *Queue->Shared);
+
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Queue->SharedPages,
+                          (VOID **)&Queue->Shared
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  ZeroMem (Queue->Shared, EFI_PAGES_TO_SIZE (Queue->SharedPages));
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Queue->Shared,
+             EFI_PAGES_TO_SIZE (Queue->SharedPages),
+             &Queue->SharedDeviceAddr,
+             &Queue->SharedMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeShared;
+  }
+
+  Queue->InFlight = AllocateZeroPool (Queue->NumSlots * sizeof *Queue->InFlight);
+  if (Queue->InFlight == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto UnmapShared;
+  }
+
+  return EFI_SUCCESS;
+
+UnmapShared:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->SharedMap);
+
+FreeShared:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Queue->SharedPages, Queue->Shared);
+
+UnmapQueue:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->RingMap);
+
+ReleaseQueue:
+  VirtioRingUninit (Dev->VirtIo, &Queue->Ring);
+
+  return Status;
+}
+
+/**
+
+  Release the resources of a request virtqueue that has been successfully set
+  up with VirtioBlkInitQueue(). The device must have been reset, or must not
+  have been started yet.
+
+  @param[in out] Dev    The driver instance.
+
+  @param[in out] Queue  The virtqueue to release.
+
+**/
+STATIC
+VOID
+VirtioBlkUninitQueue (
+  IN OUT VBLK_DEV    *Dev,
+  IN OUT VBLK_QUEUE  *Queue
+  )
+{
+  FreePool (Queue->InFlight);
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->SharedMap);
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Queue->SharedPages, Queue->Shared);
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->RingMap);
+  VirtioRingUninit (Dev->VirtIo, &Queue->Ring);
+}
+
 /**
 
   Set up all BlockIo and virtio-blk aspects of this driver for the specified
@@ -708,9 +1300,8 @@ VirtioBlkDriverBindingSupported (
   @retval EFI_UNSUPPORTED  The driver is unable to work with the virtio ring or
                            virtio-blk attributes the host provides.
 
-  @return                  Error codes from VirtioRingInit() or
-                           VIRTIO_CFG_READ() / VIRTIO_CFG_WRITE or
-                           VirtioRingMap().
+  @return                  Error codes from VirtioBlkInitQueue() or
+                           VIRTIO_CFG_READ() / VIRTIO_CFG_WRITE.
 
 **/
 STATIC
@@ -729,12 +1320,13 @@ VirtioBlkInit (
   UINT8   PhysicalBlockExp;
   UINT8   AlignmentOffset;
   UINT32  OptIoSize;
-  UINT16  QueueSize;
-  UINT64  RingBaseShift;
+  UINT16  NumQueues;
+  UINT16  QueueIndex;
 
   PhysicalBlockExp = 0;
   AlignmentOffset  = 0;
   OptIoSize        = 0;
+  NumQueues        = 1;
 
   //
   // Execute virtio-0.9.5, 2.2.1 Device Initialization Sequence.
@@ -829,8 +1421,22 @@ VirtioBlkInit (
     }
   }
 
+  if (Features & VIRTIO_BLK_F_MQ) {
+    Status = VIRTIO_CFG_READ (Dev, NumQueues, &NumQueues);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+
+    if (NumQueues == 0) {
+      Status = EFI_UNSUPPORTED;
+      goto Failed;
+    }
+
+    NumQueues = MIN (NumQueues, VBLK_MAX_QUEUES);
+  }
+
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
+              VIRTIO_BLK_F_FLUSH | VIRTIO_BLK_F_MQ | VIRTIO_F_VERSION_1 |
               VIRTIO_F_IOMMU_PLATFORM;
 
   //
@@ -845,66 +1451,14 @@ VirtioBlkInit (
   }
 
   //
-  // step 4b -- allocate virtqueue
+  // step 4b, 4c -- allocate and report the request virtqueues. If anything
+  // fails from here on, we must release the ones already set up.
   //
-  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, 0);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  if (QueueSize < 3) {
-    // SynchronousRequest() uses at most three descriptors
-    Status = EFI_UNSUPPORTED;
-    goto Failed;
-  }
-
-  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  //
-  // If anything fails from here on, we must release the ring resources
-  //
-  Status = VirtioRingMap (
-             Dev->VirtIo,
-             &Dev->Ring,
-             &RingBaseShift,
-             &Dev->RingMap
-             );
-  if (EFI_ERROR (Status)) {
-    goto ReleaseQueue;
-  }
-
-  //
-  // Additional steps for MMIO: align the queue appropriately, and set the
-  // size. If anything fails from here on, we must unmap the ring resources.
-  //
-  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
-  }
-
-  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
-  }
-
-  //
-  // step 4c -- Report GPFN (guest-physical frame number) of queue.
-  //
-  Status = Dev->VirtIo->SetQueueAddress (
-                          Dev->VirtIo,
-                          &Dev->Ring,
-                          RingBaseShift
-                          );
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+  for (QueueIndex = 0; QueueIndex < NumQueues; QueueIndex++) {
+    Status = VirtioBlkInitQueue (Dev, QueueIndex);
+    if (EFI_ERROR (Status)) {
+      goto ReleaseQueues;
+    }
   }
 
   //
@@ -914,7 +1468,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto ReleaseQueues;
     }
   }
 
@@ -924,9 +1478,11 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto ReleaseQueues;
   }
 
+  Dev->NumQueues = NumQueues;
+
   //
   // Populate the exported interface's attributes; see UEFI spec v2.4, 12.9 EFI
   // Block I/O Protocol.
@@ -937,6 +1493,11 @@ VirtioBlkInit (
   Dev->BlockIo.ReadBlocks            = &VirtioBlkReadBlocks;
   Dev->BlockIo.WriteBlocks           = &VirtioBlkWriteBlocks;
   Dev->BlockIo.FlushBlocks           = &VirtioBlkFlushBlocks;
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
   Dev->BlockIoMedia.MediaId          = 0;
   Dev->BlockIoMedia.RemovableMedia   = FALSE;
   Dev->BlockIoMedia.MediaPresent     = TRUE;
@@ -952,10 +1513,11 @@ VirtioBlkInit (
 
   DEBUG ((
     DEBUG_INFO,
-    "%a: LbaSize=0x%x[B] NumBlocks=0x%Lx[Lba]\n",
+    "%a: LbaSize=0x%x[B] NumBlocks=0x%Lx[Lba] NumQueues=%u\n",
     __func__,
     Dev->BlockIoMedia.BlockSize,
-    Dev->BlockIoMedia.LastBlock + 1
+    Dev->BlockIoMedia.LastBlock + 1,
+    Dev->NumQueues
     ));
 
   if (Features & VIRTIO_BLK_F_TOPOLOGY) {
@@ -982,11 +1544,11 @@ VirtioBlkInit (
 
   return EFI_SUCCESS;
 
-UnmapQueue:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-
-ReleaseQueue:
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+ReleaseQueues:
+  while (QueueIndex > 0) {
+    QueueIndex--;
+    VirtioBlkUninitQueue (Dev, &Dev->Queues[QueueIndex]);
+  }
 
 Failed:
   //
@@ -1014,6 +1576,8 @@ VirtioBlkUninit (
   IN OUT VBLK_DEV  *Dev
   )
 {
+  UINT16  QueueIndex;
+
   //
   // Reset the virtual device -- see virtio-0.9.5, 2.2.2.1 Device Status. When
   // VIRTIO_CFG_WRITE() returns, the host will have learned to stay away from
@@ -1021,10 +1585,14 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+  for (QueueIndex = 0; QueueIndex < Dev->NumQueues; QueueIndex++) {
+    VirtioBlkUninitQueue (Dev, &Dev->Queues[QueueIndex]);
+  }
+
+  Dev->NumQueues = 0;
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
+  SetMem (&Dev->BlockIo2, sizeof Dev->BlockIo2, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1078,13 +1646,16 @@ VirtioBlkExitBoot (
 
   @retval EFI_SUCCESS           Driver instance has been created and
                                 initialized  for the virtio-blk device, it
-                                is now accessible via EFI_BLOCK_IO_PROTOCOL.
+                                is now accessible via EFI_BLOCK_IO_PROTOCOL
+                                and EFI_BLOCK_IO2_PROTOCOL.
 
   @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
 
   @return                       Error codes from the OpenProtocol() boot
                                 service, the VirtIo protocol, VirtioBlkInit(),
-                                or the InstallProtocolInterface() boot service.
+                                the CreateEvent() boot service, or the
+                                InstallMultipleProtocolInterfaces() boot
+                                service.
 
 **/
 EFI_STATUS
@@ -1103,6 +1674,8 @@ VirtioBlkDriverBindingStart (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  InitializeListHead (&Dev->PendingList);
+
   Status = gBS->OpenProtocol (
                   DeviceHandle,
                   &gVirtioDeviceProtocolGuid,
@@ -1134,22 +1707,39 @@ VirtioBlkDriverBindingStart (
     goto UninitDev;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  &VirtioBlkPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto ClosePollTimer;
   }
 
   return EFI_SUCCESS;
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1172,7 +1762,8 @@ FreeVirtioBlk:
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo and BlockIo2
+  interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -1222,15 +1813,24 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Complete the outstanding non-blocking requests before tearing down the
+  // virtqueues.
+  //
+  VirtioBlkDrain (Dev);
+  gBS->CloseEvent (Dev->PollTimer);
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
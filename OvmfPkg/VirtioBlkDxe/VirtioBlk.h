@@ -1,7 +1,7 @@
 /** @file
 
   Internal definitions for the virtio-blk driver, which produces Block I/O
-  Protocol instances for virtio-blk devices.
+  and Block I/O 2 Protocol instances for virtio-blk devices.
 
   Copyright (C) 2012, Red Hat, Inc.
 
@@ -13,33 +13,107 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
-#include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// The number of request virtqueues we drive at most, if the device offers
+// VIRTIO_BLK_F_MQ.
+//
+#define VBLK_MAX_QUEUES  4
+
+//
+// Each request occupies a "slot" of three consecutive descriptors in its
+// virtqueue: request header, data buffer (unused for flush), host status.
+//
+#define VBLK_DESC_PER_SLOT  3
+
+//
+// Period of the timer that reaps completed non-blocking requests.
+//
+#define VBLK_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+//
+// The request header and the host status of a slot, in memory shared with the
+// device. The array of these is mapped once per virtqueue.
+//
+typedef struct {
+  VIRTIO_BLK_REQ    Request;
+  UINT8             HostStatus;
+  UINT8             Reserved[15];
+} VBLK_SHARED_SLOT;
+
+#define VBLK_REQ_SIG  SIGNATURE_32 ('V', 'B', 'R', 'Q')
+
+typedef struct {
+  UINT32                 Signature;
+  //
+  // Link on VBLK_DEV.PendingList, until the request is posted to a virtqueue.
+  //
+  LIST_ENTRY             Link;
+  //
+  // NULL for blocking requests, which are freed by their submitter.
+  //
+  EFI_BLOCK_IO2_TOKEN    *Token;
+  EFI_LBA                Lba;
+  UINTN                  BufferSize;
+  VOID                   *Buffer;
+  BOOLEAN                RequestIsWrite;
+  BOOLEAN                Completed;
+  EFI_STATUS             Status;
+  VOID                   *BufferMapping;
+} VBLK_REQUEST;
+
+typedef struct {
+  //
+  //                     field                    init function       init dpth
+  //                     ---------------------    ------------------  ---------
+  UINT16                    QueueIndex;        // VirtioBlkInitQueue  2
+  VRING                     Ring;              // VirtioRingInit      3
+  VOID                      *RingMap;          // VirtioRingMap       3
+  RING_INDICES              RingIndices;       // VirtioBlkInitQueue  2
+  UINT16                    NumSlots;          // VirtioBlkInitQueue  2
+  UINT16                    FreeSlots;         // VirtioBlkInitQueue  2
+  VBLK_SHARED_SLOT          *Shared;           // VirtioBlkInitQueue  2
+  UINTN                     SharedPages;       // VirtioBlkInitQueue  2
+  VOID                      *SharedMap;        // VirtioBlkInitQueue  2
+  EFI_PHYSICAL_ADDRESS      SharedDeviceAddr;  // VirtioBlkInitQueue  2
+  VBLK_REQUEST              **InFlight;        // VirtioBlkInitQueue  2
+} VBLK_QUEUE;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
   // at various call depths. The table to the right should make it easier to
   // track them.
   //
-  //                     field                    init function       init dpth
-  //                     ---------------------    ------------------  ---------
-  UINT32                    Signature;         // DriverBindingStart  0
-  VIRTIO_DEVICE_PROTOCOL    *VirtIo;           // DriverBindingStart  0
-  EFI_EVENT                 ExitBoot;          // DriverBindingStart  0
-  VRING                     Ring;              // VirtioRingInit      2
-  EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
-  EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
-  VOID                      *RingMap;          // VirtioRingMap       2
+  //                     field                           init function       init dpth
+  //                     ----------------------------    ------------------  ---------
+  UINT32                    Signature;                // DriverBindingStart  0
+  VIRTIO_DEVICE_PROTOCOL    *VirtIo;                  // DriverBindingStart  0
+  EFI_EVENT                 ExitBoot;                 // DriverBindingStart  0
+  EFI_EVENT                 PollTimer;                // DriverBindingStart  0
+  BOOLEAN                   PollTimerArmed;           // DriverBindingStart  0
+  LIST_ENTRY                PendingList;              // DriverBindingStart  0
+  UINTN                     InFlightCount;            // DriverBindingStart  0
+  UINT16                    NumQueues;                // VirtioBlkInit       1
+  VBLK_QUEUE                Queues[VBLK_MAX_QUEUES];  // VirtioBlkInit       1
+  EFI_BLOCK_IO_PROTOCOL     BlockIo;                  // VirtioBlkInit       1
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;                 // VirtioBlkInit       1
+  EFI_BLOCK_IO_MEDIA        BlockIoMedia;             // VirtioBlkInit       1
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -176,7 +250,7 @@ VirtioBlkReset (
     ReadBlocksEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkSubmitRequest().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -204,7 +278,7 @@ VirtioBlkReadBlocks (
     WriteBlockEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkSubmitRequest().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -244,6 +318,49 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol
+//
+// Requests with a NULL Token or Token->Event are blocking. Others are posted
+// to a virtqueue (or queued until a slot is free) and completed by the
+// PollTimer, which reaps the used rings.
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
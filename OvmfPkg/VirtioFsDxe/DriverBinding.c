@@ -114,6 +114,7 @@ VirtioFsBindingStart (
     goto UninitVirtioFs;
   }
 
+  VirtioFsLookupCacheInit (VirtioFs);
   InitializeListHead (&VirtioFs->OpenFiles);
   VirtioFs->SimpleFs.Revision   = EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_REVISION;
   VirtioFs->SimpleFs.OpenVolume = VirtioFsOpenVolume;
@@ -195,6 +196,7 @@ VirtioFsBindingStop (
   Status = gBS->CloseEvent (VirtioFs->ExitBoot);
   ASSERT_EFI_ERROR (Status);
 
+  VirtioFsLookupCacheFlush (VirtioFs);
   VirtioFsUninit (VirtioFs);
 
   Status = gBS->CloseProtocol (
@@ -25,7 +25,9 @@
                            "VirtioFs->RequestId" is set to 1 on output. The
                            maximum write buffer size exposed in the FUSE_INIT
                            response is saved in "VirtioFs->MaxWrite", on
-                           output.
+                           output. The read-ahead window negotiated in the
+                           FUSE_INIT exchange is saved in
+                           "VirtioFs->ReadAheadSize", on output.
 
   @retval EFI_SUCCESS      The FUSE session has been started.
 
@@ -105,7 +107,7 @@ VirtioFsFuseInitSession (
   //
   InitReq.Major        = VIRTIO_FS_FUSE_MAJOR;
   InitReq.Minor        = VIRTIO_FS_FUSE_MINOR;
-  InitReq.MaxReadahead = 0;
+  InitReq.MaxReadahead = VIRTIO_FS_MAX_READ_AHEAD;
   InitReq.Flags        = VIRTIO_FS_FUSE_INIT_REQ_F_DO_READDIRPLUS;
 
   //
@@ -150,5 +152,19 @@ VirtioFsFuseInitSession (
   // Save the maximum write buffer size for FUSE_WRITE requests.
   //
   VirtioFs->MaxWrite = InitResp.MaxWrite;
+
+  //
+  // Save the read-ahead window for regular files. The device may only lower
+  // the window we've offered. A window smaller than a page is not worth the
+  // copying; disable read-ahead then.
+  //
+  VirtioFs->ReadAheadSize = MIN (
+                              InitResp.MaxReadahead,
+                              VIRTIO_FS_MAX_READ_AHEAD
+                              );
+  if (VirtioFs->ReadAheadSize < SIZE_4KB) {
+    VirtioFs->ReadAheadSize = 0;
+  }
+
   return EFI_SUCCESS;
 }
@@ -35,6 +35,11 @@
   @param[out] FuseAttr     The VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE object
                            describing the properties of the resolved inode.
 
+  @param[out] NodeResp     If not NULL, the VIRTIO_FS_FUSE_NODE_RESPONSE
+                           object that carries NodeId, and the timeouts for
+                           which the Virtio Filesystem device permits caching
+                           the resolution and FuseAttr.
+
   @retval EFI_SUCCESS    Filename to inode resolution successful.
 
   @retval EFI_NOT_FOUND  The Virtio Filesystem device explicitly reported
@@ -56,14 +61,15 @@ VirtioFsFuseLookup (
   IN     UINT64                           DirNodeId,
   IN     CHAR8                            *Name,
   OUT UINT64                              *NodeId,
-  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  OUT VIRTIO_FS_FUSE_NODE_RESPONSE        *NodeResp OPTIONAL
   )
 {
   VIRTIO_FS_FUSE_REQUEST         CommonReq;
   VIRTIO_FS_IO_VECTOR            ReqIoVec[2];
   VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList;
   VIRTIO_FS_FUSE_RESPONSE        CommonResp;
-  VIRTIO_FS_FUSE_NODE_RESPONSE   NodeResp;
+  VIRTIO_FS_FUSE_NODE_RESPONSE   LocalNodeResp;
   VIRTIO_FS_IO_VECTOR            RespIoVec[3];
   VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList;
   EFI_STATUS                     Status;
@@ -80,8 +86,12 @@ VirtioFsFuseLookup (
 
   RespIoVec[0].Buffer = &CommonResp;
   RespIoVec[0].Size   = sizeof CommonResp;
-  RespIoVec[1].Buffer = &NodeResp;
-  RespIoVec[1].Size   = sizeof NodeResp;
+  if (NodeResp == NULL) {
+    NodeResp = &LocalNodeResp;
+  }
+
+  RespIoVec[1].Buffer = NodeResp;
+  RespIoVec[1].Size   = sizeof *NodeResp;
   RespIoVec[2].Buffer = FuseAttr;
   RespIoVec[2].Size   = sizeof *FuseAttr;
   RespSgList.IoVec    = RespIoVec;
@@ -147,7 +157,7 @@ VirtioFsFuseLookup (
   //
   // Output the NodeId to which Name has been resolved to.
   //
-  *NodeId = NodeResp.NodeId;
+  *NodeId = NodeResp->NodeId;
   return EFI_SUCCESS;
 
 Fail:
@@ -327,6 +327,32 @@ VirtioFsExitBoot (
   VirtioFs->Virtio->SetDeviceStatus (VirtioFs->Virtio, 0);
 }
 
+/**
+  Empty the read-ahead windows of all open files that refer to NodeId, after
+  the contents or the size of the file have been changed.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose open files should
+                           be scanned.
+
+  @param[in] NodeId        The inode number of the file that has changed.
+**/
+VOID
+VirtioFsInvalidateReadAhead (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  LIST_ENTRY      *OpenFilesEntry;
+  VIRTIO_FS_FILE  *VirtioFsFile;
+
+  BASE_LIST_FOR_EACH (OpenFilesEntry, &VirtioFs->OpenFiles) {
+    VirtioFsFile = VIRTIO_FS_FILE_FROM_OPEN_FILES_ENTRY (OpenFilesEntry);
+    if (VirtioFsFile->NodeId == NodeId) {
+      VirtioFsFile->ReadAheadLength = 0;
+    }
+  }
+}
+
 /**
   Validate two VIRTIO_FS_SCATTER_GATHER_LIST objects -- list of request
   buffers, list of response buffers -- together.
@@ -1662,12 +1688,16 @@ FreeRhsPath8:
   the last pathname component (which is therefore a direct child of said parent
   directory).
 
+  Leading pathname components are resolved through the directory lookup cache
+  first; FUSE_LOOKUP is only sent for components that miss the cache, and the
+  directories so resolved are offered to the cache.
+
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
   @param[in,out] VirtioFs    The Virtio Filesystem device to send FUSE_LOOKUP
                              and FUSE_FORGET requests to. On output, the FUSE
-                             request counter "VirtioFs->RequestId" will have
+                             request counter "VirtioFs->RequestId" may have
                              been incremented several times.
 
   @param[in,out] Path        The canonical pathname (as defined in the
@@ -1678,10 +1708,8 @@ FreeRhsPath8:
 
   @param[out] DirNodeId      The NodeId of the most specific parent directory
                              identified by Path. The caller is responsible for
-                             sending a FUSE_FORGET request to the Virtio
-                             Filesystem device for DirNodeId -- unless
-                             DirNodeId equals VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID
-                             --, when DirNodeId's use ends.
+                             passing DirNodeId to VirtioFsLookupCacheRelease()
+                             when DirNodeId's use ends.
 
   @param[out] LastComponent  A pointer into Path, pointing at the start of the
                              last pathname component.
@@ -1706,6 +1734,7 @@ VirtioFsLookupMostSpecificParentDir (
   )
 {
   UINT64      ParentDirNodeId;
+  BOOLEAN     ParentDirCached;
   CHAR8       *Slash;
   EFI_STATUS  Status;
   UINT64      NextDirNodeId;
@@ -1715,10 +1744,12 @@ VirtioFsLookupMostSpecificParentDir (
   }
 
   ParentDirNodeId = VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID;
+  ParentDirCached = FALSE;
   Slash           = Path;
   for ( ; ;) {
     CHAR8                               *NextSlash;
     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  FuseAttr;
+    VIRTIO_FS_FUSE_NODE_RESPONSE        NodeResp;
     EFI_FILE_INFO                       FileInfo;
 
     //
@@ -1735,19 +1766,42 @@ VirtioFsLookupMostSpecificParentDir (
     // up.
     //
     *NextSlash = '\0';
-    Status     = VirtioFsFuseLookup (
-                   VirtioFs,
-                   ParentDirNodeId,
-                   Slash + 1,
-                   &NextDirNodeId,
-                   &FuseAttr
-                   );
+
+    //
+    // Consult the directory lookup cache first. A hit is known to be a
+    // directory, and the cache keeps owning the FUSE lookup reference on it.
+    //
+    Status = VirtioFsLookupCacheFind (
+               VirtioFs,
+               ParentDirNodeId,
+               Slash + 1,
+               &NextDirNodeId
+               );
+    if (!EFI_ERROR (Status)) {
+      *NextSlash      = '/';
+      ParentDirNodeId = NextDirNodeId;
+      ParentDirCached = TRUE;
+      Slash           = NextSlash;
+      continue;
+    }
+
+    Status = VirtioFsFuseLookup (
+               VirtioFs,
+               ParentDirNodeId,
+               Slash + 1,
+               &NextDirNodeId,
+               &FuseAttr,
+               &NodeResp
+               );
     *NextSlash = '/';
 
     //
     // We're done with the directory inode that was the basis for the lookup.
+    // (If the directory lookup cache owns it, it may be evicted from now on.)
     //
-    if (ParentDirNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
+    if (!ParentDirCached &&
+        (ParentDirNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID))
+    {
       VirtioFsFuseForget (VirtioFs, ParentDirNodeId);
     }
 
@@ -1772,6 +1826,18 @@ VirtioFsLookupMostSpecificParentDir (
       goto ForgetNextDirNodeId;
     }
 
+    //
+    // Hand the FUSE lookup reference over to the directory lookup cache, if
+    // the Virtio Filesystem device permits caching the entry.
+    //
+    ParentDirCached = VirtioFsLookupCacheInsert (
+                        VirtioFs,
+                        ParentDirNodeId,
+                        Slash + 1,
+                        (UINTN)(NextSlash - (Slash + 1)),
+                        &NodeResp
+                        );
+
     //
     // Advance.
     //
@@ -1782,8 +1848,13 @@ VirtioFsLookupMostSpecificParentDir (
   //
   // ParentDirNodeId corresponds to the last containing directory. The
   // remaining single-component filename represents a direct child under that
-  // directory. Said filename starts at (Slash + 1).
+  // directory. Said filename starts at (Slash + 1). If the directory lookup
+  // cache owns ParentDirNodeId, pin it until the caller releases it.
   //
+  if (ParentDirCached) {
+    VirtioFsLookupCachePin (VirtioFs, ParentDirNodeId);
+  }
+
   *DirNodeId     = ParentDirNodeId;
   *LastComponent = Slash + 1;
   return EFI_SUCCESS;
@@ -0,0 +1,572 @@
+/** @file
+  Directory lookup cache for the Virtio Filesystem device driver.
+
+  Copyright (c) 2026, TianoCore contributors.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Library/BaseLib.h>                   // AsciiStrLen()
+#include <Library/BaseMemoryLib.h>             // CompareMem()
+#include <Library/MemoryAllocationLib.h>       // AllocatePool()
+#include <Library/UefiBootServicesTableLib.h>  // gBS
+
+#include "VirtioFsDxe.h"
+
+/**
+  Convert the entry timeout reported by the Virtio Filesystem device to 100ns
+  units, rounding down, and saturating at MAX_UINT32 seconds.
+
+  @param[in] NodeResp  The VIRTIO_FS_FUSE_NODE_RESPONSE object carrying the
+                       EntryValid and EntryValidNsec fields.
+
+  @return  The time for which the entry may be cached, in 100ns units.
+**/
+STATIC
+UINT64
+EntryTimeoutTo100ns (
+  IN VIRTIO_FS_FUSE_NODE_RESPONSE  *NodeResp
+  )
+{
+  if (NodeResp->EntryValid > MAX_UINT32) {
+    return MultU64x32 (MAX_UINT32, 10000000);
+  }
+
+  return MultU64x32 (NodeResp->EntryValid, 10000000) +
+         NodeResp->EntryValidNsec / 100;
+}
+
+/**
+  Check whether a directory lookup cache entry is usable for resolving a
+  pathname component.
+
+  The expiry timer of the entry reports the expiry only once, so an expired
+  entry is marked stale here; the caller is responsible for freeing it if it
+  is not pinned.
+
+  @param[in,out] Entry  The cache entry to check.
+
+  @retval TRUE   Entry is occupied, not stale, and not expired.
+
+  @retval FALSE  Otherwise.
+**/
+STATIC
+BOOLEAN
+IsEntryLive (
+  IN OUT VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry
+  )
+{
+  if ((Entry->Name == NULL) || Entry->Stale) {
+    return FALSE;
+  }
+
+  if (!EFI_ERROR (gBS->CheckEvent (Entry->ExpiryTimer))) {
+    Entry->Stale = TRUE;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Check whether a directory lookup cache entry maps the (ParentNodeId, Name)
+  pair.
+**/
+STATIC
+BOOLEAN
+IsEntryMatch (
+  IN VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry,
+  IN UINT64                        ParentNodeId,
+  IN CHAR8                         *Name,
+  IN UINTN                         NameLen
+  )
+{
+  return (BOOLEAN)(Entry->Name != NULL &&
+                   Entry->ParentNodeId == ParentNodeId &&
+                   Entry->NameLen == NameLen &&
+                   CompareMem (Entry->Name, Name, NameLen) == 0);
+}
+
+/**
+  Free a directory lookup cache entry, and drop the FUSE lookup reference that
+  the entry owns.
+
+  The entries that are keyed on the inode being forgotten are invalidated too,
+  as the Virtio Filesystem device may reuse the inode number afterwards.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_FORGET
+                           request to.
+
+  @param[in,out] Entry     The occupied, unpinned cache entry to free.
+**/
+STATIC
+VOID
+DropEntry (
+  IN OUT VIRTIO_FS                     *VirtioFs,
+  IN OUT VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry
+  )
+{
+  UINT64                        NodeId;
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Child;
+
+  ASSERT (Entry->Name != NULL);
+  ASSERT (Entry->PinCount == 0);
+
+  NodeId = Entry->NodeId;
+  VirtioFsFuseForget (VirtioFs, NodeId);
+  gBS->CloseEvent (Entry->ExpiryTimer);
+  FreePool (Entry->Name);
+  ZeroMem (Entry, sizeof *Entry);
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Child = &VirtioFs->LookupCache.Entry[Index];
+    if ((Child->Name == NULL) || (Child->ParentNodeId != NodeId)) {
+      continue;
+    }
+
+    if (Child->PinCount > 0) {
+      Child->Stale = TRUE;
+    } else {
+      DropEntry (VirtioFs, Child);
+    }
+  }
+}
+
+/**
+  Check whether the directory lookup cache owns a FUSE lookup reference on
+  NodeId.
+**/
+STATIC
+BOOLEAN
+IsNodeCached (
+  IN VIRTIO_FS  *VirtioFs,
+  IN UINT64     NodeId
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    if ((VirtioFs->LookupCache.Entry[Index].Name != NULL) &&
+        (VirtioFs->LookupCache.Entry[Index].NodeId == NodeId))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Check whether the directory lookup cache entry that owns NodeId is an
+  ancestor of the directory DescendantNodeId, or is DescendantNodeId itself.
+  Freeing such an entry would free the entry of DescendantNodeId too.
+**/
+STATIC
+BOOLEAN
+IsNodeAncestor (
+  IN VIRTIO_FS  *VirtioFs,
+  IN UINT64     NodeId,
+  IN UINT64     DescendantNodeId
+  )
+{
+  UINTN  Depth;
+  UINTN  Index;
+
+  //
+  // Walk up from DescendantNodeId through the cached parents. The depth is
+  // bounded by the number of entries.
+  //
+  for (Depth = 0; Depth <= VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Depth++) {
+    if (DescendantNodeId == NodeId) {
+      return TRUE;
+    }
+
+    for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+      if ((VirtioFs->LookupCache.Entry[Index].Name != NULL) &&
+          (VirtioFs->LookupCache.Entry[Index].NodeId == DescendantNodeId))
+      {
+        break;
+      }
+    }
+
+    if (Index == VIRTIO_FS_LOOKUP_CACHE_ENTRIES) {
+      return FALSE;
+    }
+
+    DescendantNodeId = VirtioFs->LookupCache.Entry[Index].ParentNodeId;
+  }
+
+  return FALSE;
+}
+
+/**
+  Invalidate all entries that map the (ParentNodeId, Name) pair. Unpinned
+  entries are freed; pinned entries are marked stale.
+**/
+STATIC
+VOID
+InvalidateEntries (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     ParentNodeId,
+  IN     CHAR8      *Name,
+  IN     UINTN      NameLen
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if (!IsEntryMatch (Entry, ParentNodeId, Name, NameLen)) {
+      continue;
+    }
+
+    if (Entry->PinCount > 0) {
+      Entry->Stale = TRUE;
+    } else {
+      DropEntry (VirtioFs, Entry);
+    }
+  }
+}
+
+/**
+  Initialize the directory lookup cache to empty.
+
+  @param[out] VirtioFs  The Virtio Filesystem device whose cache should be
+                        initialized.
+**/
+VOID
+VirtioFsLookupCacheInit (
+  OUT VIRTIO_FS  *VirtioFs
+  )
+{
+  ZeroMem (&VirtioFs->LookupCache, sizeof VirtioFs->LookupCache);
+}
+
+/**
+  Free all entries of the directory lookup cache, dropping the FUSE lookup
+  references that they own.
+
+  The function may only be called while no VIRTIO_FS_FILE objects are open,
+  and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose cache should be
+                           flushed.
+**/
+VOID
+VirtioFsLookupCacheFlush (
+  IN OUT VIRTIO_FS  *VirtioFs
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if (Entry->Name != NULL) {
+      DropEntry (VirtioFs, Entry);
+    }
+  }
+}
+
+/**
+  Look up a directory in the directory lookup cache.
+
+  An expired entry that matches the (ParentNodeId, Name) pair is freed (or
+  marked stale, if it is pinned), and not reported.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose cache should be
+                           searched.
+
+  @param[in] ParentNodeId  The inode number of the directory in which Name
+                           should be resolved.
+
+  @param[in] Name          The NUL-terminated, single-component filename to
+                           resolve.
+
+  @param[out] NodeId       The inode number of the directory that Name has been
+                           resolved to. The FUSE lookup reference on NodeId
+                           remains owned by the cache; the caller may use
+                           NodeId only until the next call to
+                           VirtioFsLookupCacheInsert(), unless it pins NodeId
+                           with VirtioFsLookupCachePin().
+
+  @retval EFI_SUCCESS    Name has been resolved to a directory.
+
+  @retval EFI_NOT_FOUND  The cache has no live entry for (ParentNodeId, Name).
+**/
+EFI_STATUS
+VirtioFsLookupCacheFind (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     ParentNodeId,
+  IN     CHAR8      *Name,
+  OUT UINT64        *NodeId
+  )
+{
+  UINTN                         NameLen;
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+
+  NameLen = AsciiStrLen (Name);
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if (!IsEntryMatch (Entry, ParentNodeId, Name, NameLen) || Entry->Stale) {
+      continue;
+    }
+
+    if (!IsEntryLive (Entry)) {
+      if (Entry->PinCount == 0) {
+        DropEntry (VirtioFs, Entry);
+      }
+
+      continue;
+    }
+
+    Entry->LastUse = ++VirtioFs->LookupCache.UseCounter;
+    *NodeId        = Entry->NodeId;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Offer a directory, freshly resolved by FUSE_LOOKUP or FUSE_READDIRPLUS, to
+  the directory lookup cache.
+
+  The entry is cached for the entry timeout that the Virtio Filesystem device
+  reported in NodeResp. If there is no free slot, the expired or least
+  recently used unpinned entry is evicted, except the entries of ParentNodeId
+  and of its ancestors, as freeing those would free ParentNodeId's entry.
+
+  Entries are only accepted under the root directory, or under a directory
+  that the cache owns; this keeps ParentNodeId from being forgotten (and
+  reused by the Virtio Filesystem device) while the entry is in the cache.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose cache should be
+                           updated.
+
+  @param[in] ParentNodeId  The inode number of the directory in which Name has
+                           been resolved.
+
+  @param[in] Name          The single-component filename that has been
+                           resolved. Name need not be NUL-terminated.
+
+  @param[in] NameLen       The number of CHAR8 elements in Name.
+
+  @param[in] NodeResp      The VIRTIO_FS_FUSE_NODE_RESPONSE object that the
+                           Virtio Filesystem device reported for Name. The
+                           caller is responsible for ensuring that
+                           NodeResp->NodeId is a directory.
+
+  @retval TRUE   The entry has been cached. The FUSE lookup reference on
+                 NodeResp->NodeId is now owned by the cache; see
+                 VirtioFsLookupCacheFind() about the use of NodeId.
+
+  @retval FALSE  The entry has not been cached, because the entry timeout was
+                 zero, because ParentNodeId was not cached, because every slot
+                 was pinned, or because resource allocation failed. The FUSE
+                 lookup reference on NodeResp->NodeId remains owned by the
+                 caller.
+**/
+BOOLEAN
+VirtioFsLookupCacheInsert (
+  IN OUT VIRTIO_FS                     *VirtioFs,
+  IN     UINT64                        ParentNodeId,
+  IN     CHAR8                         *Name,
+  IN     UINTN                         NameLen,
+  IN     VIRTIO_FS_FUSE_NODE_RESPONSE  *NodeResp
+  )
+{
+  EFI_STATUS                    Status;
+  UINT64                        Timeout;
+  CHAR8                         *NameCopy;
+  EFI_EVENT                     ExpiryTimer;
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Victim;
+
+  Timeout = EntryTimeoutTo100ns (NodeResp);
+  if (Timeout == 0) {
+    return FALSE;
+  }
+
+  if ((ParentNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) &&
+      !IsNodeCached (VirtioFs, ParentNodeId))
+  {
+    return FALSE;
+  }
+
+  //
+  // Replace any previous mapping for the same name.
+  //
+  InvalidateEntries (VirtioFs, ParentNodeId, Name, NameLen);
+
+  //
+  // Prefer a free slot, then an expired unpinned slot, then the least recently
+  // used unpinned slot.
+  //
+  Victim = NULL;
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if (Entry->Name == NULL) {
+      Victim = Entry;
+      break;
+    }
+
+    if ((Entry->PinCount > 0) || IsNodeAncestor (VirtioFs, Entry->NodeId, ParentNodeId)) {
+      continue;
+    }
+
+    if (!IsEntryLive (Entry)) {
+      DropEntry (VirtioFs, Entry);
+      Victim = Entry;
+      break;
+    }
+
+    if ((Victim == NULL) || (Entry->LastUse < Victim->LastUse)) {
+      Victim = Entry;
+    }
+  }
+
+  if (Victim == NULL) {
+    return FALSE;
+  }
+
+  NameCopy = AllocatePool (NameLen + 1);
+  if (NameCopy == NULL) {
+    return FALSE;
+  }
+
+  CopyMem (NameCopy, Name, NameLen);
+  NameCopy[NameLen] = '\0';
+
+  //
+  // The timer has no notification function; IsEntryLive() checks it.
+  //
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &ExpiryTimer);
+  if (EFI_ERROR (Status)) {
+    goto FreeNameCopy;
+  }
+
+  Status = gBS->SetTimer (ExpiryTimer, TimerRelative, Timeout);
+  if (EFI_ERROR (Status)) {
+    goto CloseExpiryTimer;
+  }
+
+  if (Victim->Name != NULL) {
+    DropEntry (VirtioFs, Victim);
+  }
+
+  Victim->ParentNodeId = ParentNodeId;
+  Victim->NodeId       = NodeResp->NodeId;
+  Victim->Name         = NameCopy;
+  Victim->NameLen      = NameLen;
+  Victim->ExpiryTimer  = ExpiryTimer;
+  Victim->LastUse      = ++VirtioFs->LookupCache.UseCounter;
+  return TRUE;
+
+CloseExpiryTimer:
+  gBS->CloseEvent (ExpiryTimer);
+
+FreeNameCopy:
+  FreePool (NameCopy);
+  return FALSE;
+}
+
+/**
+  Invalidate the directory lookup cache entry for (ParentNodeId, Name), after
+  Name has been removed from, or renamed in or out of, the directory
+  identified by ParentNodeId.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose cache should be
+                           updated.
+
+  @param[in] ParentNodeId  The inode number of the directory that contains (or
+                           used to contain) Name.
+
+  @param[in] Name          The NUL-terminated, single-component filename.
+**/
+VOID
+VirtioFsLookupCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     ParentNodeId,
+  IN     CHAR8      *Name
+  )
+{
+  InvalidateEntries (VirtioFs, ParentNodeId, Name, AsciiStrLen (Name));
+}
+
+/**
+  Pin the directory lookup cache entry that owns NodeId, so that NodeId remain
+  valid across subsequent cache insertions.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose cache should be
+                           updated.
+
+  @param[in] NodeId        The inode number that VirtioFsLookupCacheFind() has
+                           output, or that VirtioFsLookupCacheInsert() has
+                           accepted, with no intervening cache insertion.
+**/
+VOID
+VirtioFsLookupCachePin (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if ((Entry->Name != NULL) && !Entry->Stale && (Entry->NodeId == NodeId)) {
+      Entry->PinCount++;
+      return;
+    }
+  }
+
+  ASSERT (FALSE);
+}
+
+/**
+  Release a directory inode that VirtioFsLookupMostSpecificParentDir() has
+  output.
+
+  If the inode is pinned in the directory lookup cache, the pin is released.
+  Otherwise, the caller owns a FUSE lookup reference on the inode, and a
+  FUSE_FORGET request is sent for it. The root directory is never forgotten.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device that NodeId belongs to.
+
+  @param[in] NodeId        The inode number to release.
+**/
+VOID
+VirtioFsLookupCacheRelease (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY  *Entry;
+
+  if (NodeId == VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
+    return;
+  }
+
+  for (Index = 0; Index < VIRTIO_FS_LOOKUP_CACHE_ENTRIES; Index++) {
+    Entry = &VirtioFs->LookupCache.Entry[Index];
+    if ((Entry->Name != NULL) && (Entry->PinCount > 0) &&
+        (Entry->NodeId == NodeId))
+    {
+      Entry->PinCount--;
+      if ((Entry->PinCount == 0) && Entry->Stale) {
+        DropEntry (VirtioFs, Entry);
+      }
+
+      return;
+    }
+  }
+
+  VirtioFsFuseForget (VirtioFs, NodeId);
+}
@@ -68,9 +68,8 @@ VirtioFsSimpleFileDelete (
                );
     if (!EFI_ERROR (Status)) {
       //
-      // Attempt the actual removal. Regardless of the outcome, ParentNodeId
-      // must be forgotten right after (unless it stands for the root
-      // directory).
+      // Attempt the actual removal. Regardless of the outcome, drop any cached
+      // resolution of LastComponent, and release ParentNodeId right after.
       //
       Status = VirtioFsFuseRemoveFileOrDir (
                  VirtioFs,
@@ -78,9 +77,8 @@ VirtioFsSimpleFileDelete (
                  LastComponent,
                  VirtioFsFile->IsDirectory
                  );
-      if (ParentNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
-        VirtioFsFuseForget (VirtioFs, ParentNodeId);
-      }
+      VirtioFsLookupCacheInvalidate (VirtioFs, ParentNodeId, LastComponent);
+      VirtioFsLookupCacheRelease (VirtioFs, ParentNodeId);
     }
 
     if (EFI_ERROR (Status)) {
@@ -111,6 +109,10 @@ VirtioFsSimpleFileDelete (
     FreePool (VirtioFsFile->FileInfoArray);
   }
 
+  if (VirtioFsFile->ReadAheadBuffer != NULL) {
+    FreePool (VirtioFsFile->ReadAheadBuffer);
+  }
+
   FreePool (VirtioFsFile);
   return Status;
 }
@@ -158,7 +158,8 @@ OpenExistentFileOrDirectory (
              DirNodeId,
              Name,
              &ResolvedNodeId,
-             &FuseAttr
+             &FuseAttr,
+             NULL
              );
   if (EFI_ERROR (Status)) {
     return Status;
@@ -523,9 +524,7 @@ VirtioFsSimpleFileOpen (
   //
   // Regardless of the branch taken, we're done with DirNodeId.
   //
-  if (DirNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
-    VirtioFsFuseForget (VirtioFs, DirNodeId);
-  }
+  VirtioFsLookupCacheRelease (VirtioFs, DirNodeId);
 
   if (EFI_ERROR (Status)) {
     goto FreeNewCanonicalPath;
@@ -557,6 +556,9 @@ VirtioFsSimpleFileOpen (
   NewVirtioFsFile->SingleFileInfoSize     = 0;
   NewVirtioFsFile->NumFileInfo            = 0;
   NewVirtioFsFile->NextFileInfo           = 0;
+  NewVirtioFsFile->ReadAheadBuffer        = NULL;
+  NewVirtioFsFile->ReadAheadOffset        = 0;
+  NewVirtioFsFile->ReadAheadLength        = 0;
 
   //
   // One more file is now open for the filesystem.
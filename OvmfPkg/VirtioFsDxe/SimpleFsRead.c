@@ -163,9 +163,10 @@ RefillFileInfoCache (
     }
 
     //
-    // Iterate over all records in DirentBuf. Primarily, forget them all.
-    // Secondarily, if a record proves transformable to EFI_FILE_INFO, add it
-    // to the EFI_FILE_INFO cache (unless the cache is full).
+    // Iterate over all records in DirentBuf. Primarily, forget them all (or
+    // hand them over to the directory lookup cache). Secondarily, if a record
+    // proves transformable to EFI_FILE_INFO, add it to the EFI_FILE_INFO cache
+    // (unless the cache is full).
     //
     Consumed = 0;
     while (Remaining >= sizeof (VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE)) {
@@ -239,13 +240,33 @@ RefillFileInfoCache (
       }
 
       //
-      // Make the Virtio Filesystem device forget the NodeId in this directory
-      // entry, as we'll need it no more. (The "." and ".." entries need no
-      // FUSE_FORGET requests, when returned by FUSE_READDIRPLUS -- and so the
-      // Virtio Filesystem device reports their NodeId fields as zero.)
+      // If this directory entry is a subdirectory, offer it to the directory
+      // lookup cache; opening a pathname through it will then need no
+      // FUSE_LOOKUP. Otherwise, make the Virtio Filesystem device forget the
+      // NodeId in this directory entry, as we'll need it no more. (The "." and
+      // ".." entries need no FUSE_FORGET requests, when returned by
+      // FUSE_READDIRPLUS -- and so the Virtio Filesystem device reports their
+      // NodeId fields as zero.)
       //
       if (Dirent->NodeResp.NodeId != 0) {
-        VirtioFsFuseForget (VirtioFs, Dirent->NodeResp.NodeId);
+        BOOLEAN  Cached;
+
+        Cached = FALSE;
+        if ((Dirent->AttrResp.Mode & VIRTIO_FS_FUSE_MODE_TYPE_MASK) ==
+            VIRTIO_FS_FUSE_MODE_TYPE_DIR)
+        {
+          Cached = VirtioFsLookupCacheInsert (
+                     VirtioFs,
+                     VirtioFsFile->NodeId,
+                     (CHAR8 *)(Dirent + 1),
+                     Dirent->Namelen,
+                     &Dirent->NodeResp
+                     );
+        }
+
+        if (!Cached) {
+          VirtioFsFuseForget (VirtioFs, Dirent->NodeResp.NodeId);
+        }
       }
 
       //
@@ -362,8 +383,109 @@ ReadFileInfoCache (
   return EFI_SUCCESS;
 }
 
+/**
+  Copy data from the read-ahead window of a regular file, if the window covers
+  the requested file position.
+
+  @param[in] VirtioFsFile  The regular file to read from.
+
+  @param[in] Position      The file position to read from.
+
+  @param[in] Size          The maximum number of bytes to copy.
+
+  @param[out] Buffer       The buffer to copy to.
+
+  @return  The number of bytes copied to Buffer. Zero if the window does not
+           cover Position.
+**/
+STATIC
+UINTN
+ReadFromReadAhead (
+  IN  VIRTIO_FS_FILE  *VirtioFsFile,
+  IN  UINT64          Position,
+  IN  UINTN           Size,
+  OUT VOID            *Buffer
+  )
+{
+  UINTN  Skip;
+  UINTN  Copy;
+
+  if ((Position < VirtioFsFile->ReadAheadOffset) ||
+      (Position - VirtioFsFile->ReadAheadOffset >=
+       VirtioFsFile->ReadAheadLength))
+  {
+    return 0;
+  }
+
+  Skip = (UINTN)(Position - VirtioFsFile->ReadAheadOffset);
+  Copy = MIN (Size, VirtioFsFile->ReadAheadLength - Skip);
+  CopyMem (Buffer, VirtioFsFile->ReadAheadBuffer + Skip, Copy);
+  return Copy;
+}
+
+/**
+  Refill the read-ahead window of a regular file with a single FUSE_READ
+  request, starting at the requested file position.
+
+  @param[in,out] VirtioFsFile  The regular file whose read-ahead window should
+                               be refilled. The window is empty on error.
+
+  @param[in] Position          The file position to read from.
+
+  @retval EFI_SUCCESS           The window has been refilled. The window may be
+                                empty if Position is at the end of the file.
+
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the window.
+
+  @return                       Error codes propagated from
+                                VirtioFsFuseReadFileOrDir().
+**/
+STATIC
+EFI_STATUS
+RefillReadAhead (
+  IN OUT VIRTIO_FS_FILE  *VirtioFsFile,
+  IN     UINT64          Position
+  )
+{
+  VIRTIO_FS   *VirtioFs;
+  UINT32      ReadSize;
+  EFI_STATUS  Status;
+
+  VirtioFs = VirtioFsFile->OwnerFs;
+  if (VirtioFsFile->ReadAheadBuffer == NULL) {
+    VirtioFsFile->ReadAheadBuffer = AllocatePool (VirtioFs->ReadAheadSize);
+    if (VirtioFsFile->ReadAheadBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  VirtioFsFile->ReadAheadLength = 0;
+
+  ReadSize = VirtioFs->ReadAheadSize;
+  Status   = VirtioFsFuseReadFileOrDir (
+               VirtioFs,
+               VirtioFsFile->NodeId,
+               VirtioFsFile->FuseHandle,
+               FALSE,                                    // IsDir
+               Position,
+               &ReadSize,
+               VirtioFsFile->ReadAheadBuffer
+               );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  VirtioFsFile->ReadAheadOffset = Position;
+  VirtioFsFile->ReadAheadLength = ReadSize;
+  return EFI_SUCCESS;
+}
+
 /**
   Read from a regular file.
+
+  Requests smaller than the read-ahead window are served from the window,
+  which is refilled with a single FUSE_READ request when needed. Larger
+  requests are sent to the Virtio Filesystem device directly.
 **/
 STATIC
 EFI_STATUS
@@ -380,35 +502,68 @@ ReadRegularFile (
   UINTN                               Left;
 
   VirtioFs = VirtioFsFile->OwnerFs;
+  Left     = *BufferSize;
+
+  //
+  // Serve the head of the request from the read-ahead window, if the window
+  // covers the file position.
   //
-  // The UEFI spec forbids reads that start beyond the end of the file.
+  Transferred = ReadFromReadAhead (
+                  VirtioFsFile,
+                  VirtioFsFile->FilePosition,
+                  Left,
+                  Buffer
+                  );
+  Left -= Transferred;
+
   //
-  Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
-  if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
-    return EFI_DEVICE_ERROR;
+  // The UEFI spec forbids reads that start beyond the end of the file. (If the
+  // read-ahead window covered the file position, then the position is known
+  // to be inside the file.)
+  //
+  if (Transferred == 0) {
+    Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
+    if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
+      return EFI_DEVICE_ERROR;
+    }
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
+  Status = EFI_SUCCESS;
   while (Left > 0) {
     UINT32  ReadSize;
 
-    //
-    // FUSE_READ cannot express a >=4GB buffer size.
-    //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status   = VirtioFsFuseReadFileOrDir (
-                 VirtioFs,
-                 VirtioFsFile->NodeId,
-                 VirtioFsFile->FuseHandle,
-                 FALSE,                                  // IsDir
-                 VirtioFsFile->FilePosition + Transferred,
-                 &ReadSize,
-                 (UINT8 *)Buffer + Transferred
+    if (Left < VirtioFs->ReadAheadSize) {
+      Status = RefillReadAhead (
+                 VirtioFsFile,
+                 VirtioFsFile->FilePosition + Transferred
                  );
-    if (EFI_ERROR (Status) || (ReadSize == 0)) {
-      break;
+      if (EFI_ERROR (Status) || (VirtioFsFile->ReadAheadLength == 0)) {
+        break;
+      }
+
+      ReadSize = (UINT32)ReadFromReadAhead (
+                           VirtioFsFile,
+                           VirtioFsFile->FilePosition + Transferred,
+                           Left,
+                           (UINT8 *)Buffer + Transferred
+                           );
+    } else {
+      //
+      // FUSE_READ cannot express a >=4GB buffer size.
+      //
+      ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
+      Status   = VirtioFsFuseReadFileOrDir (
+                   VirtioFs,
+                   VirtioFsFile->NodeId,
+                   VirtioFsFile->FuseHandle,
+                   FALSE,                                // IsDir
+                   VirtioFsFile->FilePosition + Transferred,
+                   &ReadSize,
+                   (UINT8 *)Buffer + Transferred
+                   );
+      if (EFI_ERROR (Status) || (ReadSize == 0)) {
+        break;
+      }
     }
 
     Transferred += ReadSize;
@@ -290,7 +290,7 @@ Rename (
              &NewLastComponent
              );
   if (EFI_ERROR (Status)) {
-    goto ForgetOldParentDirNodeId;
+    goto ReleaseOldParentDirNodeId;
   }
 
   //
@@ -304,9 +304,18 @@ Rename (
              NewLastComponent
              );
   if (EFI_ERROR (Status)) {
-    goto ForgetNewParentDirNodeId;
+    goto ReleaseNewParentDirNodeId;
   }
 
+  //
+  // The old name no longer resolves in the old parent directory.
+  //
+  VirtioFsLookupCacheInvalidate (
+    VirtioFs,
+    OldParentDirNodeId,
+    OldLastComponent
+    );
+
   //
   // Swap in the new canonical pathname.
   //
@@ -318,15 +327,11 @@ Rename (
   //
   // Fall through.
   //
-ForgetNewParentDirNodeId:
-  if (NewParentDirNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
-    VirtioFsFuseForget (VirtioFs, NewParentDirNodeId);
-  }
+ReleaseNewParentDirNodeId:
+  VirtioFsLookupCacheRelease (VirtioFs, NewParentDirNodeId);
 
-ForgetOldParentDirNodeId:
-  if (OldParentDirNodeId != VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID) {
-    VirtioFsFuseForget (VirtioFs, OldParentDirNodeId);
-  }
+ReleaseOldParentDirNodeId:
+  VirtioFsLookupCacheRelease (VirtioFs, OldParentDirNodeId);
 
 FreeDestination:
   if (Destination != NULL) {
@@ -457,6 +462,10 @@ UpdateAttributes (
              UpdateMtime    ? &Mtime    : NULL,
              UpdateMode     ? &Mode     : NULL
              );
+  if (UpdateFileSize) {
+    VirtioFsInvalidateReadAhead (VirtioFs, VirtioFsFile->NodeId);
+  }
+
   return Status;
 }
 
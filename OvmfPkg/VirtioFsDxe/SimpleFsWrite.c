@@ -33,6 +33,11 @@ VirtioFsSimpleFileWrite (
     return EFI_ACCESS_DENIED;
   }
 
+  //
+  // Any read-ahead window covering this file is about to go stale.
+  //
+  VirtioFsInvalidateReadAhead (VirtioFs, VirtioFsFile->NodeId);
+
   Status      = EFI_SUCCESS;
   Transferred = 0;
   Left        = *BufferSize;
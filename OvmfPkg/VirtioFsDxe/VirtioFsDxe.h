@@ -52,6 +52,18 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Upper limit for the per-file read-ahead window, negotiated with the Virtio
+// Filesystem device in FUSE_INIT. The window actually used is
+// "VIRTIO_FS.ReadAheadSize".
+//
+#define VIRTIO_FS_MAX_READ_AHEAD  SIZE_1MB
+
+//
+// Number of entries in the directory lookup cache.
+//
+#define VIRTIO_FS_LOOKUP_CACHE_ENTRIES  64
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -59,6 +71,37 @@
 //
 typedef CHAR16 VIRTIO_FS_LABEL[VIRTIO_FS_TAG_BYTES + 1];
 
+//
+// An entry in the directory lookup cache. The entry maps the (ParentNodeId,
+// Name) pair to NodeId, and it owns one FUSE lookup reference on NodeId. Only
+// directories are cached; the cache short-circuits the FUSE_LOOKUP requests
+// that VirtioFsLookupMostSpecificParentDir() would otherwise send for the
+// leading components of a pathname.
+//
+// An entry is free if Name is NULL. An entry is expired once its ExpiryTimer
+// has been signaled; the timer is set to the entry timeout that the Virtio
+// Filesystem device reported for the directory, and it is only checked when
+// the entry is looked up or considered for eviction. A
+// pinned entry (PinCount > 0) is in use by an EFI_FILE_PROTOCOL member
+// function, and cannot be evicted; if it is invalidated meanwhile, it is only
+// marked Stale, and freed when the last pin is released.
+//
+typedef struct {
+  UINT64       ParentNodeId;
+  UINT64       NodeId;
+  CHAR8        *Name;
+  UINTN        NameLen;
+  EFI_EVENT    ExpiryTimer;
+  UINT32       PinCount;
+  BOOLEAN      Stale;
+  UINT64       LastUse;
+} VIRTIO_FS_LOOKUP_CACHE_ENTRY;
+
+typedef struct {
+  UINT64                          UseCounter;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY    Entry[VIRTIO_FS_LOOKUP_CACHE_ENTRIES];
+} VIRTIO_FS_LOOKUP_CACHE;
+
 //
 // Main context structure, expressing an EFI_SIMPLE_FILE_SYSTEM_PROTOCOL
 // interface on top of the Virtio Filesystem device.
@@ -69,19 +112,21 @@ typedef struct {
   // at various call depths. The table to the right should make it easier to
   // track them.
   //
-  //                              field         init function       init depth
-  //                              -----------   ------------------  ----------
-  UINT64                             Signature; // DriverBindingStart  0
-  VIRTIO_DEVICE_PROTOCOL             *Virtio;   // DriverBindingStart  0
-  VIRTIO_FS_LABEL                    Label;     // VirtioFsInit        1
-  UINT16                             QueueSize; // VirtioFsInit        1
-  VRING                              Ring;      // VirtioRingInit      2
-  VOID                               *RingMap;  // VirtioRingMap       2
-  UINT64                             RequestId; // FuseInitSession     1
-  UINT32                             MaxWrite;  // FuseInitSession     1
-  EFI_EVENT                          ExitBoot;  // DriverBindingStart  0
-  LIST_ENTRY                         OpenFiles; // DriverBindingStart  0
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;  // DriverBindingStart  0
+  //                              field             init function       init depth
+  //                              ---------------   ------------------  ----------
+  UINT64                             Signature;     // DriverBindingStart  0
+  VIRTIO_DEVICE_PROTOCOL             *Virtio;       // DriverBindingStart  0
+  VIRTIO_FS_LABEL                    Label;         // VirtioFsInit        1
+  UINT16                             QueueSize;     // VirtioFsInit        1
+  VRING                              Ring;          // VirtioRingInit      2
+  VOID                               *RingMap;      // VirtioRingMap       2
+  UINT64                             RequestId;     // FuseInitSession     1
+  UINT32                             MaxWrite;      // FuseInitSession     1
+  UINT32                             ReadAheadSize; // FuseInitSession     1
+  EFI_EVENT                          ExitBoot;      // DriverBindingStart  0
+  VIRTIO_FS_LOOKUP_CACHE             LookupCache;   // DriverBindingStart  0
+  LIST_ENTRY                         OpenFiles;     // DriverBindingStart  0
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;      // DriverBindingStart  0
 } VIRTIO_FS;
 
 #define VIRTIO_FS_FROM_SIMPLE_FS(SimpleFsReference) \
@@ -174,6 +219,20 @@ typedef struct {
   UINTN    SingleFileInfoSize;
   UINTN    NumFileInfo;
   UINTN    NextFileInfo;
+  //
+  // Read-ahead window for a regular file.
+  //
+  // EFI_FILE_PROTOCOL.Read() invocations that are smaller than
+  // "VIRTIO_FS.ReadAheadSize" are served from this buffer. When the buffer
+  // does not cover the file position, it is refilled with a single FUSE_READ
+  // of "VIRTIO_FS.ReadAheadSize" bytes. ReadAheadBuffer is allocated at the
+  // first such refill. The window holds ReadAheadLength bytes of the file,
+  // starting at ReadAheadOffset. Writes and size changes through any
+  // VIRTIO_FS_FILE that refers to the same NodeId empty the window.
+  //
+  UINT8     *ReadAheadBuffer;
+  UINT64    ReadAheadOffset;
+  UINTN     ReadAheadLength;
 } VIRTIO_FS_FILE;
 
 #define VIRTIO_FS_FILE_FROM_SIMPLE_FILE(SimpleFileReference) \
@@ -204,6 +263,58 @@ VirtioFsExitBoot (
   IN VOID       *VirtioFsAsVoid
   );
 
+VOID
+VirtioFsLookupCacheInit (
+  OUT VIRTIO_FS  *VirtioFs
+  );
+
+VOID
+VirtioFsLookupCacheFlush (
+  IN OUT VIRTIO_FS  *VirtioFs
+  );
+
+EFI_STATUS
+VirtioFsLookupCacheFind (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     ParentNodeId,
+  IN     CHAR8      *Name,
+  OUT UINT64        *NodeId
+  );
+
+BOOLEAN
+VirtioFsLookupCacheInsert (
+  IN OUT VIRTIO_FS                     *VirtioFs,
+  IN     UINT64                        ParentNodeId,
+  IN     CHAR8                         *Name,
+  IN     UINTN                         NameLen,
+  IN     VIRTIO_FS_FUSE_NODE_RESPONSE  *NodeResp
+  );
+
+VOID
+VirtioFsLookupCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     ParentNodeId,
+  IN     CHAR8      *Name
+  );
+
+VOID
+VirtioFsLookupCachePin (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
+VOID
+VirtioFsLookupCacheRelease (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
+VOID
+VirtioFsInvalidateReadAhead (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
 EFI_STATUS
 VirtioFsSgListsValidate (
   IN     VIRTIO_FS                      *VirtioFs,
@@ -318,7 +429,8 @@ VirtioFsFuseLookup (
   IN     UINT64                           DirNodeId,
   IN     CHAR8                            *Name,
   OUT UINT64                              *NodeId,
-  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  OUT VIRTIO_FS_FUSE_NODE_RESPONSE        *NodeResp OPTIONAL
   );
 
 EFI_STATUS
@@ -9,6 +9,7 @@
 
 **/
 
+#include <Library/UefiBootServicesTableLib.h>
 #include <Library/VirtioLib.h>
 
 #include "VirtioGpu.h"
@@ -118,7 +119,9 @@ VirtioGpuInit (
 
   //
   // We implement each VirtIo GPU command that we use with two descriptors:
-  // request, response.
+  // request, response. The asynchronous transfer + flush batch needs two more
+  // commands in flight; it is only enabled if the queue is large enough (see
+  // VGPU_MIN_ASYNC_QUEUE).
   //
   if (QueueSize < 2) {
     Status = EFI_UNSUPPORTED;
@@ -158,17 +161,49 @@ VirtioGpuInit (
     goto UnmapQueue;
   }
 
+  VirtioInitRingIndices (&VgpuDev->Ring, &VgpuDev->RingIndices);
+
+  //
+  // Set up the buffers for the asynchronous transfer + flush batch.
+  //
+  VgpuDev->AsyncBatch    = NULL;
+  VgpuDev->AsyncInFlight = 0;
+  VgpuDev->SyncInFlight  = FALSE;
+  if (QueueSize >= VGPU_MIN_ASYNC_QUEUE) {
+    Status = VirtioGpuAllocateZeroAndMapBackingStore (
+               VgpuDev,
+               EFI_SIZE_TO_PAGES (sizeof (VGPU_ASYNC_BATCH)),
+               (VOID **)&VgpuDev->AsyncBatch,
+               &VgpuDev->AsyncBatchDeviceAddress,
+               &VgpuDev->AsyncBatchMap
+               );
+    if (EFI_ERROR (Status)) {
+      goto UnmapQueue;
+    }
+  }
+
   //
   // 8. Set the DRIVER_OK status bit.
   //
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = VgpuDev->VirtIo->SetDeviceStatus (VgpuDev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto FreeAsyncBatch;
   }
 
   return EFI_SUCCESS;
 
+FreeAsyncBatch:
+  if (VgpuDev->AsyncBatch != NULL) {
+    VirtioGpuUnmapAndFreeBackingStore (
+      VgpuDev,
+      EFI_SIZE_TO_PAGES (sizeof (VGPU_ASYNC_BATCH)),
+      VgpuDev->AsyncBatch,
+      VgpuDev->AsyncBatchMap
+      );
+    VgpuDev->AsyncBatch = NULL;
+  }
+
 UnmapQueue:
   VgpuDev->VirtIo->UnmapSharedBuffer (VgpuDev->VirtIo, VgpuDev->RingMap);
 
@@ -208,6 +243,16 @@ VirtioGpuUninit (
   // configuration.
   //
   VgpuDev->VirtIo->SetDeviceStatus (VgpuDev->VirtIo, 0);
+  if (VgpuDev->AsyncBatch != NULL) {
+    VirtioGpuUnmapAndFreeBackingStore (
+      VgpuDev,
+      EFI_SIZE_TO_PAGES (sizeof (VGPU_ASYNC_BATCH)),
+      VgpuDev->AsyncBatch,
+      VgpuDev->AsyncBatchMap
+      );
+    VgpuDev->AsyncBatch = NULL;
+  }
+
   VgpuDev->VirtIo->UnmapSharedBuffer (VgpuDev->VirtIo, VgpuDev->RingMap);
   VirtioRingUninit (VgpuDev->VirtIo, &VgpuDev->Ring);
 }
@@ -333,9 +378,9 @@ VirtioGpuUnmapAndFreeBackingStore (
 }
 
 /**
-  EFI_EVENT_NOTIFY function for the VGPU_DEV.ExitBoot event. It resets the
-  VirtIo device, causing it to release its resources and to forget its
-  configuration.
+  EFI_EVENT_NOTIFY function for the VGPU_DEV.ExitBoot event. It presents the
+  damage that Blt() has accumulated, then resets the VirtIo device, causing it
+  to release its resources and to forget its configuration.
 
   This function may only be called (that is, VGPU_DEV.ExitBoot may only be
   signaled) after VirtioGpuInit() returns and before VirtioGpuUninit() is
@@ -352,13 +397,150 @@ VirtioGpuExitBoot (
   IN VOID       *Context
   )
 {
-  VGPU_DEV  *VgpuDev;
+  VGPU_DEV    *VgpuDev;
+  VGPU_GOP    *VgpuGop;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
 
   DEBUG ((DEBUG_VERBOSE, "%a: Context=0x%p\n", __func__, Context));
   VgpuDev = Context;
+  VgpuGop = VgpuDev->Child;
+
+  //
+  // The device is reset below, so the flush timer must not fire anymore. Let
+  // the batch in flight complete, then submit the remaining damage and wait
+  // for it too, so that the last Blt() operations reach the display. A host
+  // that doesn't complete a batch in time is reset all the same.
+  //
+  if (VgpuDev->AsyncBatch != NULL) {
+    if (VgpuGop != NULL) {
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      gBS->SetTimer (VgpuGop->FlushTimer, TimerCancel, 0);
+      gBS->RestoreTPL (OldTpl);
+    }
+
+    Status = VirtioGpuWaitAsync (VgpuDev);
+
+    if (!EFI_ERROR (Status) && (VgpuGop != NULL)) {
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      VirtioGpuFlushDamage (NULL, VgpuGop);
+      gBS->RestoreTPL (OldTpl);
+
+      Status = VirtioGpuWaitAsync (VgpuDev);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: %r\n", __func__, Status));
+    }
+  }
+
   VgpuDev->VirtIo->SetDeviceStatus (VgpuDev->VirtIo, 0);
 }
 
+/**
+  Internal utility function that fills in the VIRTIO_GPU_CONTROL_HEADER of a
+  request.
+
+  @param[in,out] VgpuDev      The VGPU_DEV object that represents the VirtIo
+                              GPU device.
+
+  @param[in]     RequestType  The type of the request.
+
+  @param[in]     Fence        Whether to enable fencing for this request. If
+                              Fence is TRUE, then VgpuDev->FenceId is consumed,
+                              and incremented.
+
+  @param[out]    Header       The header to initialize.
+**/
+STATIC
+VOID
+VirtioGpuInitHeader (
+  IN OUT VGPU_DEV                            *VgpuDev,
+  IN     VIRTIO_GPU_CONTROL_TYPE             RequestType,
+  IN     BOOLEAN                             Fence,
+  OUT    volatile VIRTIO_GPU_CONTROL_HEADER  *Header
+  )
+{
+  Header->Type = RequestType;
+  if (Fence) {
+    Header->Flags   = VIRTIO_GPU_FLAG_FENCE;
+    Header->FenceId = VgpuDev->FenceId++;
+  } else {
+    Header->Flags   = 0;
+    Header->FenceId = 0;
+  }
+
+  Header->CtxId   = 0;
+  Header->Padding = 0;
+}
+
+/**
+  Internal utility function that collects all descriptor chains that the host
+  has processed on the control queue, without waiting.
+
+  Completed commands of the asynchronous transfer + flush batch are accounted
+  for in VgpuDev->AsyncInFlight; their errors are logged on the DEBUG_ERROR
+  level, as there is no caller to report them to.
+
+  The completion of the synchronous command is recorded in
+  VgpuDev->SyncInFlight and VgpuDev->SyncUsedLen.
+
+  @param[in,out] VgpuDev  The VGPU_DEV object that represents the VirtIo GPU
+                          device. The function must be called at TPL_NOTIFY.
+**/
+STATIC
+VOID
+VirtioGpuReap (
+  IN OUT VGPU_DEV  *VgpuDev
+  )
+{
+  UINT16                              HeadDescIdx;
+  UINT32                              UsedLen;
+  volatile VIRTIO_GPU_CONTROL_HEADER  *Response;
+
+  while (!EFI_ERROR (
+            VirtioReapChain (
+              &VgpuDev->Ring,
+              &VgpuDev->RingIndices,
+              &HeadDescIdx,
+              &UsedLen
+              )
+            ))
+  {
+    switch (HeadDescIdx) {
+      case VGPU_SYNC_HEAD_DESC:
+        VgpuDev->SyncInFlight = FALSE;
+        VgpuDev->SyncUsedLen  = UsedLen;
+        continue;
+      case VGPU_TRANSFER_HEAD_DESC:
+        Response = &VgpuDev->AsyncBatch->TransferResponse;
+        break;
+      case VGPU_FLUSH_HEAD_DESC:
+        Response = &VgpuDev->AsyncBatch->FlushResponse;
+        break;
+      default:
+        ASSERT (FALSE);
+        continue;
+    }
+
+    ASSERT (VgpuDev->AsyncInFlight > 0);
+    VgpuDev->AsyncInFlight--;
+
+    if ((UsedLen != sizeof *Response) ||
+        (Response->Type != VirtioGpuRespOkNodata))
+    {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: HeadDescIdx=%u UsedLen=%u Response=0x%x\n",
+        __func__,
+        HeadDescIdx,
+        UsedLen,
+        Response->Type
+        ));
+    }
+  }
+}
+
 /**
   Internal utility function that sends a request to the VirtIo GPU device
   model, awaits the answer from the host, and returns a status.
@@ -430,21 +612,17 @@ VirtioGpuSendCommandWithReply (
   VOID                  *RequestMap;
   EFI_PHYSICAL_ADDRESS  ResponseDeviceAddress;
   VOID                  *ResponseMap;
+  EFI_TPL               OldTpl;
+  UINTN                 PollPeriodUsecs;
+  BOOLEAN               Done;
 
   //
-  // Initialize Header.
+  // Initialize Header. The FenceId counter is shared with the asynchronous
+  // batch, which is submitted from a TPL_NOTIFY event.
   //
-  Header->Type = RequestType;
-  if (Fence) {
-    Header->Flags   = VIRTIO_GPU_FLAG_FENCE;
-    Header->FenceId = VgpuDev->FenceId++;
-  } else {
-    Header->Flags   = 0;
-    Header->FenceId = 0;
-  }
-
-  Header->CtxId   = 0;
-  Header->Padding = 0;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  VirtioGpuInitHeader (VgpuDev, RequestType, Fence, Header);
+  gBS->RestoreTPL (OldTpl);
 
   ASSERT (RequestSize >= sizeof *Header);
   ASSERT (RequestSize <= MAX_UINT32);
@@ -476,10 +654,32 @@ VirtioGpuSendCommandWithReply (
     goto UnmapRequest;
   }
 
+  //
+  // The ring is shared with the asynchronous batch. Let the batch complete
+  // first, so that synchronous commands retain their ordering guarantees
+  // with respect to it. The ring is only accessed at TPL_NOTIFY, but the
+  // function stalls at the caller's TPL, so that timer notifications keep
+  // running while the host works.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioGpuReap (VgpuDev);
+    if ((VgpuDev->AsyncInFlight == 0) && !VgpuDev->SyncInFlight) {
+      break;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+
   //
   // Compose the descriptor chain.
   //
-  VirtioPrepare (&VgpuDev->Ring, &Indices);
+  VirtioPrepareChain (&VgpuDev->Ring, VGPU_SYNC_HEAD_DESC, &Indices);
   VirtioAppendDesc (
     &VgpuDev->Ring,
     RequestDeviceAddress,
@@ -496,19 +696,42 @@ VirtioGpuSendCommandWithReply (
     );
 
   //
-  // Send the command.
+  // Send the command, and wait for the host to process it.
   //
-  Status = VirtioFlush (
-             VgpuDev->VirtIo,
-             VIRTIO_GPU_CONTROL_QUEUE,
-             &VgpuDev->Ring,
-             &Indices,
-             &ResponseSizeRet
-             );
+  VirtioQueueChain (&VgpuDev->Ring, &Indices, &VgpuDev->RingIndices);
+  VgpuDev->SyncInFlight = TRUE;
+  Status                = VirtioKick (
+                            VgpuDev->VirtIo,
+                            VIRTIO_GPU_CONTROL_QUEUE,
+                            &VgpuDev->Ring,
+                            &VgpuDev->RingIndices
+                            );
+  if (EFI_ERROR (Status)) {
+    VgpuDev->SyncInFlight = FALSE;
+  }
+
+  gBS->RestoreTPL (OldTpl);
   if (EFI_ERROR (Status)) {
     goto UnmapResponse;
   }
 
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioGpuReap (VgpuDev);
+    Done            = !VgpuDev->SyncInFlight;
+    ResponseSizeRet = VgpuDev->SyncUsedLen;
+    gBS->RestoreTPL (OldTpl);
+    if (Done) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+
   //
   // Verify response size.
   //
@@ -848,3 +1071,159 @@ VirtioGpuGetDisplayInfo (
            sizeof *Response
            );
 }
+
+EFI_STATUS
+VirtioGpuTransferAndFlushAsync (
+  IN OUT VGPU_DEV  *VgpuDev,
+  IN     UINT32    X,
+  IN     UINT32    Y,
+  IN     UINT32    Width,
+  IN     UINT32    Height,
+  IN     UINT64    Offset,
+  IN     UINT32    ResourceId
+  )
+{
+  VGPU_ASYNC_BATCH      *Batch;
+  EFI_PHYSICAL_ADDRESS  BatchAddress;
+  DESC_INDICES          Indices;
+  UINT16                NextAvailIdx;
+  EFI_STATUS            Status;
+
+  ASSERT (VgpuDev->AsyncBatch != NULL);
+  if (ResourceId == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The request and response buffers can only be reused once the host is done
+  // with the previous batch.
+  //
+  if (VgpuDev->AsyncInFlight > 0) {
+    VirtioGpuReap (VgpuDev);
+    if (VgpuDev->AsyncInFlight > 0) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  Batch        = VgpuDev->AsyncBatch;
+  BatchAddress = VgpuDev->AsyncBatchDeviceAddress;
+
+  //
+  // The transfer need not be fenced: the host processes the control queue in
+  // order, so fencing the flush covers both commands.
+  //
+  VirtioGpuInitHeader (
+    VgpuDev,
+    VirtioGpuCmdTransferToHost2d,
+    FALSE,                        // Fence
+    &Batch->Transfer.Header
+    );
+  Batch->Transfer.Rectangle.X      = X;
+  Batch->Transfer.Rectangle.Y      = Y;
+  Batch->Transfer.Rectangle.Width  = Width;
+  Batch->Transfer.Rectangle.Height = Height;
+  Batch->Transfer.Offset           = Offset;
+  Batch->Transfer.ResourceId       = ResourceId;
+  Batch->Transfer.Padding          = 0;
+
+  VirtioGpuInitHeader (
+    VgpuDev,
+    VirtioGpuCmdResourceFlush,
+    TRUE,                         // Fence
+    &Batch->Flush.Header
+    );
+  Batch->Flush.Rectangle.X      = X;
+  Batch->Flush.Rectangle.Y      = Y;
+  Batch->Flush.Rectangle.Width  = Width;
+  Batch->Flush.Rectangle.Height = Height;
+  Batch->Flush.ResourceId       = ResourceId;
+  Batch->Flush.Padding          = 0;
+
+  NextAvailIdx = VgpuDev->RingIndices.NextAvailIdx;
+
+  VirtioPrepareChain (&VgpuDev->Ring, VGPU_TRANSFER_HEAD_DESC, &Indices);
+  VirtioAppendDesc (
+    &VgpuDev->Ring,
+    BatchAddress + OFFSET_OF (VGPU_ASYNC_BATCH, Transfer),
+    sizeof Batch->Transfer,
+    VRING_DESC_F_NEXT,
+    &Indices
+    );
+  VirtioAppendDesc (
+    &VgpuDev->Ring,
+    BatchAddress + OFFSET_OF (VGPU_ASYNC_BATCH, TransferResponse),
+    sizeof Batch->TransferResponse,
+    VRING_DESC_F_WRITE,
+    &Indices
+    );
+  VirtioQueueChain (&VgpuDev->Ring, &Indices, &VgpuDev->RingIndices);
+
+  VirtioPrepareChain (&VgpuDev->Ring, VGPU_FLUSH_HEAD_DESC, &Indices);
+  VirtioAppendDesc (
+    &VgpuDev->Ring,
+    BatchAddress + OFFSET_OF (VGPU_ASYNC_BATCH, Flush),
+    sizeof Batch->Flush,
+    VRING_DESC_F_NEXT,
+    &Indices
+    );
+  VirtioAppendDesc (
+    &VgpuDev->Ring,
+    BatchAddress + OFFSET_OF (VGPU_ASYNC_BATCH, FlushResponse),
+    sizeof Batch->FlushResponse,
+    VRING_DESC_F_WRITE,
+    &Indices
+    );
+  VirtioQueueChain (&VgpuDev->Ring, &Indices, &VgpuDev->RingIndices);
+
+  VgpuDev->AsyncInFlight = 2;
+  Status                 = VirtioKick (
+                             VgpuDev->VirtIo,
+                             VIRTIO_GPU_CONTROL_QUEUE,
+                             &VgpuDev->Ring,
+                             &VgpuDev->RingIndices
+                             );
+  if (EFI_ERROR (Status)) {
+    //
+    // The host has not been notified. Withdraw the batch, so that the next
+    // flush, and the synchronous commands, don't wait for it forever.
+    //
+    *VgpuDev->Ring.Avail.Idx          = NextAvailIdx;
+    VgpuDev->RingIndices.NextAvailIdx = NextAvailIdx;
+    VgpuDev->AsyncInFlight            = 0;
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+VirtioGpuWaitAsync (
+  IN OUT VGPU_DEV  *VgpuDev
+  )
+{
+  UINTN    PollPeriodUsecs;
+  UINTN    WaitedUsecs;
+  EFI_TPL  OldTpl;
+  BOOLEAN  Done;
+
+  PollPeriodUsecs = 1;
+  WaitedUsecs     = 0;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioGpuReap (VgpuDev);
+    Done = (BOOLEAN)(VgpuDev->AsyncInFlight == 0);
+    gBS->RestoreTPL (OldTpl);
+    if (Done) {
+      return EFI_SUCCESS;
+    }
+
+    if (WaitedUsecs >= VGPU_ASYNC_WAIT_TIMEOUT) {
+      return EFI_TIMEOUT;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    WaitedUsecs += PollPeriodUsecs;
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+}
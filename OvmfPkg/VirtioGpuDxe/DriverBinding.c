@@ -421,6 +421,21 @@ InitVgpuGop (
 
   ASSERT (ParentVirtIo == ParentBus->VirtIo);
 
+  //
+  // Create the timer that flushes the damage accumulated by Blt() to the
+  // display.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  VirtioGpuFlushDamage,
+                  VgpuGop,
+                  &VgpuGop->FlushTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseVirtIoByChild;
+  }
+
   //
   // Initialize our Graphics Output Protocol.
   //
@@ -430,7 +445,7 @@ InitVgpuGop (
   CopyMem (&VgpuGop->Gop, &mGopTemplate, sizeof mGopTemplate);
   Status = VgpuGop->Gop.SetMode (&VgpuGop->Gop, 0);
   if (EFI_ERROR (Status)) {
-    goto CloseVirtIoByChild;
+    goto CloseFlushTimer;
   }
 
   //
@@ -456,6 +471,9 @@ InitVgpuGop (
 UninitGop:
   ReleaseGopResources (VgpuGop, TRUE /* DisableHead */);
 
+CloseFlushTimer:
+  gBS->CloseEvent (VgpuGop->FlushTimer);
+
 CloseVirtIoByChild:
   gBS->CloseProtocol (
          ParentBusController,
@@ -524,10 +542,13 @@ UninitVgpuGop (
   ASSERT_EFI_ERROR (Status);
 
   //
-  // Uninitialize VgpuGop->Gop.
+  // Uninitialize VgpuGop->Gop. Pending damage is dropped.
   //
   ReleaseGopResources (VgpuGop, TRUE /* DisableHead */);
 
+  Status = gBS->CloseEvent (VgpuGop->FlushTimer);
+  ASSERT_EFI_ERROR (Status);
+
   Status = gBS->CloseProtocol (
                   ParentBusController,
                   &gVirtioDeviceProtocolGuid,
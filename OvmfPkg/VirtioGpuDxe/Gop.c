@@ -10,6 +10,7 @@
 
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "VirtioGpu.h"
 
@@ -28,7 +29,8 @@
 
                          On output, resources will be released, and
                          VgpuGop->BackingStore and VgpuGop->ResourceId will be
-                         nulled.
+                         nulled. Damage that has not been flushed to the
+                         display yet is dropped.
 
   param[in] DisableHead  Whether this head (scanout) currently references the
                          resource identified by VgpuGop->ResourceId. Only pass
@@ -43,10 +45,24 @@ ReleaseGopResources (
   )
 {
   EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
 
   ASSERT (VgpuGop->ResourceId != 0);
   ASSERT (VgpuGop->BackingStore != NULL);
 
+  //
+  // Forget about the damage accumulated for the resource. The commands below
+  // wait for the asynchronous transfer + flush batch, if any is in flight,
+  // before the resource is destroyed.
+  //
+  OldTpl           = gBS->RaiseTPL (TPL_NOTIFY);
+  VgpuGop->Damaged = FALSE;
+  if (VgpuGop->FlushTimer != NULL) {
+    gBS->SetTimer (VgpuGop->FlushTimer, TimerCancel, 0);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
   //
   // If any of the following host-side destruction steps fail, we can't get out
   // of an inconsistent state, so we'll hang. In general errors in object
@@ -569,6 +585,7 @@ GopBlt (
   UINTN       SegmentSize;
   UINTN       Y;
   UINTN       ResourceOffset;
+  EFI_TPL     OldTpl;
   EFI_STATUS  Status;
 
   VgpuGop           = VGPU_GOP_FROM_GOP (This);
@@ -735,39 +752,146 @@ GopBlt (
       return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // For operations that wrote to the display, submit the updated area to the
-  // host -- update the host resource from guest memory.
-  //
-  ResourceOffset = sizeof (UINT32) * (DestinationY * CurrentHorizontal +
-                                      DestinationX);
-  Status = VirtioGpuTransferToHost2d (
+  if ((Width == 0) || (Height == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  if (VgpuGop->ParentBus->AsyncBatch == NULL) {
+    //
+    // The control queue is too small for the asynchronous batch. Submit the
+    // updated area to the host -- update the host resource from guest memory
+    // -- and flush it to the display, waiting for both.
+    //
+    ResourceOffset = sizeof (UINT32) * (DestinationY * CurrentHorizontal +
+                                        DestinationX);
+    Status = VirtioGpuTransferToHost2d (
+               VgpuGop->ParentBus,   // VgpuDev
+               (UINT32)DestinationX, // X
+               (UINT32)DestinationY, // Y
+               (UINT32)Width,        // Width
+               (UINT32)Height,       // Height
+               ResourceOffset,       // Offset
+               VgpuGop->ResourceId   // ResourceId
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    return VirtioGpuResourceFlush (
              VgpuGop->ParentBus,   // VgpuDev
              (UINT32)DestinationX, // X
              (UINT32)DestinationY, // Y
              (UINT32)Width,        // Width
              (UINT32)Height,       // Height
-             ResourceOffset,       // Offset
              VgpuGop->ResourceId   // ResourceId
              );
-  if (EFI_ERROR (Status)) {
-    return Status;
   }
 
   //
-  // Flush the updated resource to the display.
-  //
-  Status = VirtioGpuResourceFlush (
-             VgpuGop->ParentBus,   // VgpuDev
-             (UINT32)DestinationX, // X
-             (UINT32)DestinationY, // Y
-             (UINT32)Width,        // Width
-             (UINT32)Height,       // Height
-             VgpuGop->ResourceId   // ResourceId
-             );
+  // For operations that wrote to the display, add the updated area to the
+  // damage. Submitting it to the host -- updating the host resource from guest
+  // memory, and flushing the resource to the display -- is left to
+  // VirtioGpuFlushDamage(), so that a series of small Blt() operations results
+  // in a single transfer + flush.
+  //
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (!VgpuGop->Damaged) {
+    VgpuGop->DamageX1 = (UINT32)DestinationX;
+    VgpuGop->DamageY1 = (UINT32)DestinationY;
+    VgpuGop->DamageX2 = (UINT32)(DestinationX + Width);
+    VgpuGop->DamageY2 = (UINT32)(DestinationY + Height);
+
+    Status = gBS->SetTimer (
+                    VgpuGop->FlushTimer,
+                    TimerRelative,
+                    VGPU_FLUSH_DELAY
+                    );
+    VgpuGop->Damaged = !EFI_ERROR (Status);
+  } else {
+    VgpuGop->DamageX1 = MIN (VgpuGop->DamageX1, (UINT32)DestinationX);
+    VgpuGop->DamageY1 = MIN (VgpuGop->DamageY1, (UINT32)DestinationY);
+    VgpuGop->DamageX2 = MAX (
+                          VgpuGop->DamageX2,
+                          (UINT32)(DestinationX + Width)
+                          );
+    VgpuGop->DamageY2 = MAX (
+                          VgpuGop->DamageY2,
+                          (UINT32)(DestinationY + Height)
+                          );
+  }
+
+  gBS->RestoreTPL (OldTpl);
   return Status;
 }
 
+/**
+  EFI_EVENT_NOTIFY function for the VGPU_GOP.FlushTimer event. It submits the
+  damage accumulated by Blt() to the host as an asynchronous transfer + flush
+  batch, without waiting for the host. If the previous batch is still in
+  flight, the timer is re-armed, and the damage keeps accumulating.
+
+  The function runs at TPL_NOTIFY, and never stalls.
+
+  @param[in] Event    Event whose notification function is being invoked, or
+                      NULL if the function is called directly.
+
+  @param[in] Context  Pointer to the associated VGPU_GOP object.
+**/
+VOID
+EFIAPI
+VirtioGpuFlushDamage (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  VGPU_GOP    *VgpuGop;
+  VGPU_DEV    *VgpuDev;
+  UINT32      X;
+  UINT32      Y;
+  UINT32      Width;
+  UINT32      Height;
+  UINT64      ResourceOffset;
+  EFI_STATUS  Status;
+
+  VgpuGop = Context;
+  VgpuDev = VgpuGop->ParentBus;
+  if (!VgpuGop->Damaged) {
+    return;
+  }
+
+  X              = VgpuGop->DamageX1;
+  Y              = VgpuGop->DamageY1;
+  Width          = VgpuGop->DamageX2 - X;
+  Height         = VgpuGop->DamageY2 - Y;
+  ResourceOffset = sizeof (UINT32) *
+                   ((UINT64)Y * VgpuGop->GopModeInfo.HorizontalResolution + X);
+
+  Status = VirtioGpuTransferAndFlushAsync (
+             VgpuDev,
+             X,
+             Y,
+             Width,
+             Height,
+             ResourceOffset,
+             VgpuGop->ResourceId
+             );
+  if (Status == EFI_NOT_READY) {
+    //
+    // The host is still working on the previous batch; keep accumulating
+    // damage, and retry later.
+    //
+    gBS->SetTimer (VgpuGop->FlushTimer, TimerRelative, VGPU_FLUSH_DELAY);
+    return;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %r\n", __func__, Status));
+  }
+
+  VgpuGop->Damaged = FALSE;
+}
+
 //
 // Template for initializing VGPU_GOP.Gop.
 //
@@ -15,6 +15,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiLib.h>
+#include <Library/VirtioLib.h>
 #include <Protocol/GraphicsOutput.h>
 #include <Protocol/VirtioDevice.h>
 
@@ -23,6 +24,43 @@
 //
 typedef struct VGPU_GOP_STRUCT VGPU_GOP;
 
+//
+// Descriptor chain layout on the control queue. Synchronous commands use a
+// two-descriptor chain at VGPU_SYNC_HEAD_DESC. The asynchronous transfer +
+// flush batch (see VGPU_ASYNC_BATCH) uses two further two-descriptor chains.
+//
+#define VGPU_SYNC_HEAD_DESC      0
+#define VGPU_TRANSFER_HEAD_DESC  2
+#define VGPU_FLUSH_HEAD_DESC     4
+#define VGPU_MIN_ASYNC_QUEUE     6
+
+//
+// Delay between the first Blt() that damages the display and the
+// asynchronous transfer + flush batch that presents the damage. The timer is
+// dispatched at TPL_NOTIFY, so the batch is also postponed until the TPL
+// drops below TPL_NOTIFY.
+//
+#define VGPU_FLUSH_DELAY  EFI_TIMER_PERIOD_MILLISECONDS (16)
+
+//
+// The longest VirtioGpuWaitAsync() waits for the host to complete the batch in
+// flight, in microseconds.
+//
+#define VGPU_ASYNC_WAIT_TIMEOUT  1000000
+
+//
+// Request and response buffers for the asynchronous transfer + flush batch.
+// The host writes the responses after the driver has returned from Blt(), so
+// the buffers are mapped for bus master common buffer operation, for the
+// lifetime of the control queue.
+//
+typedef struct {
+  VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D    Transfer;
+  VIRTIO_GPU_CONTROL_HEADER             TransferResponse;
+  VIRTIO_GPU_RESOURCE_FLUSH             Flush;
+  VIRTIO_GPU_CONTROL_HEADER             FlushResponse;
+} VGPU_ASYNC_BATCH;
+
 //
 // The abstraction that directly corresponds to a Virtio GPU device.
 //
@@ -66,6 +104,34 @@ typedef struct {
   //
   UINT64                      FenceId;
 
+  //
+  // Submission state of Ring. All descriptor chains are queued with
+  // VirtioQueueChain() and reaped with VirtioReapChain(), so that the
+  // asynchronous batch can be in flight while Blt() returns. Ring is only
+  // accessed at TPL_NOTIFY.
+  //
+  RING_INDICES                RingIndices;
+
+  //
+  // Buffers of the asynchronous transfer + flush batch, and their bus master
+  // device address and mapping token. AsyncBatch is NULL if the control queue
+  // is too small for the batch; damage is then presented synchronously.
+  // AsyncInFlight counts the commands of the batch that the host has not
+  // completed yet.
+  //
+  VGPU_ASYNC_BATCH            *AsyncBatch;
+  EFI_PHYSICAL_ADDRESS        AsyncBatchDeviceAddress;
+  VOID                        *AsyncBatchMap;
+  UINTN                       AsyncInFlight;
+
+  //
+  // Whether a synchronous command is in flight, and the number of bytes that
+  // the host wrote to its response once it is completed. The completion may
+  // be reaped by the asynchronous batch, so it is recorded here.
+  //
+  BOOLEAN                     SyncInFlight;
+  UINT32                      SyncUsedLen;
+
   //
   // The Child field references the GOP wrapper structure. If this pointer is
   // NULL, then the hybrid driver has bound (i.e., started) the
@@ -157,6 +223,20 @@ struct VGPU_GOP_STRUCT {
   //
   UINT32                                  NativeXRes;
   UINT32                                  NativeYRes;
+
+  //
+  // Damage accumulator. Blt() operations that write to the display only
+  // update BackingStore, and grow the bounding rectangle [DamageX1, DamageX2)
+  // x [DamageY1, DamageY2). When Damaged becomes TRUE, FlushTimer is armed;
+  // when it expires, the rectangle is transferred to the host resource and
+  // flushed to the display. The accumulator is only accessed at TPL_NOTIFY.
+  //
+  EFI_EVENT                               FlushTimer;
+  BOOLEAN                                 Damaged;
+  UINT32                                  DamageX1;
+  UINT32                                  DamageY1;
+  UINT32                                  DamageX2;
+  UINT32                                  DamageY2;
 };
 
 //
@@ -378,6 +458,82 @@ VirtioGpuGetDisplayInfo (
   volatile VIRTIO_GPU_RESP_DISPLAY_INFO  *Response
   );
 
+/**
+  Submit a VirtioGpuCmdTransferToHost2d command and a fenced
+  VirtioGpuCmdResourceFlush command for the same rectangle, as a batch with a
+  single notification, and return without waiting for the host.
+
+  Completion is collected by later calls to this function, by
+  VirtioGpuWaitAsync(), and by the synchronous commands. Damage is only
+  flushed with this function if VgpuDev->AsyncBatch is not NULL; otherwise
+  Blt() presents it synchronously.
+
+  @param[in,out] VgpuDev  The VGPU_DEV object that represents the VirtIo GPU
+                          device. VgpuDev->AsyncBatch must not be NULL. The
+                          function must be called at TPL_NOTIFY.
+
+  @retval EFI_SUCCESS    The batch has been submitted.
+
+  @retval EFI_NOT_READY  The previous batch is still in flight; nothing has
+                         been submitted.
+
+  @return                Codes for unexpected errors in VirtIo messaging. The
+                         batch is withdrawn from the ring, and a new batch can
+                         be submitted.
+
+  For the rest of the parameters, please refer to VirtioGpuTransferToHost2d()
+  and VirtioGpuResourceFlush().
+**/
+EFI_STATUS
+VirtioGpuTransferAndFlushAsync (
+  IN OUT VGPU_DEV  *VgpuDev,
+  IN     UINT32    X,
+  IN     UINT32    Y,
+  IN     UINT32    Width,
+  IN     UINT32    Height,
+  IN     UINT64    Offset,
+  IN     UINT32    ResourceId
+  );
+
+/**
+  Wait until the host completes the asynchronous transfer + flush batch, if
+  any is in flight, for at most VGPU_ASYNC_WAIT_TIMEOUT microseconds.
+
+  The function raises the TPL to TPL_NOTIFY only to collect completions; it
+  stalls between polls at the caller's TPL.
+
+  @param[in,out] VgpuDev  The VGPU_DEV object that represents the VirtIo GPU
+                          device. The function must be called below
+                          TPL_NOTIFY.
+
+  @retval EFI_SUCCESS  No batch is in flight.
+
+  @retval EFI_TIMEOUT  The host didn't complete the batch in time.
+**/
+EFI_STATUS
+VirtioGpuWaitAsync (
+  IN OUT VGPU_DEV  *VgpuDev
+  );
+
+/**
+  EFI_EVENT_NOTIFY function for the VGPU_GOP.FlushTimer event. It submits the
+  damage accumulated by Blt() to the host as an asynchronous transfer + flush
+  batch, without waiting for the host.
+
+  The function is also called directly, at TPL_NOTIFY, to flush the remaining
+  damage at ExitBootServices().
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the associated VGPU_GOP object.
+**/
+VOID
+EFIAPI
+VirtioGpuFlushDamage (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Release guest-side and host-side resources that are related to an initialized
   VGPU_GOP.Gop.
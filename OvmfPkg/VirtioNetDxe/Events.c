@@ -56,7 +56,7 @@ VirtioNetIsPacketAvailable (
   RxCurUsed = *Dev->RxRing.Used.Idx;
   MemoryFence ();
 
-  if (Dev->RxLastUsed != RxCurUsed) {
+  if (Dev->RxRingIndices.LastUsedIdx != RxCurUsed) {
     gBS->SignalEvent (Dev->Snp.WaitForPacket);
   }
 }
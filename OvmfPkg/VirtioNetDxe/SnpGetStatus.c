@@ -107,7 +107,7 @@ VirtioNetGetStatus (
     // report the transmit interrupt if we have transmitted at least one buffer
     //
     *InterruptStatus = 0;
-    if (Dev->RxLastUsed != RxCurUsed) {
+    if (Dev->RxRingIndices.LastUsedIdx != RxCurUsed) {
       *InterruptStatus |= EFI_SIMPLE_NETWORK_RECEIVE_INTERRUPT;
     }
 
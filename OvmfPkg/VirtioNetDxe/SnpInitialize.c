@@ -155,7 +155,6 @@ VirtioNetInitTx (
   IN OUT VNET_DEV  *Dev
   )
 {
-  UINTN                 TxSharedReqSize;
   UINTN                 PktIdx;
   EFI_STATUS            Status;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
@@ -212,14 +211,6 @@ VirtioNetInitTx (
 
   Dev->TxSharedReq = TxSharedReqBuffer;
 
-  //
-  // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
-  //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
-                    sizeof (Dev->TxSharedReq->V0_9_5) :
-                    sizeof *Dev->TxSharedReq;
-
   for (PktIdx = 0; PktIdx < Dev->TxMaxPending; ++PktIdx) {
     UINT16  DescIdx;
 
@@ -231,7 +222,7 @@ VirtioNetInitTx (
     // (unmodified by the host) virtio-net request header.
     //
     Dev->TxRing.Desc[DescIdx].Addr  = DeviceAddress;
-    Dev->TxRing.Desc[DescIdx].Len   = (UINT32)TxSharedReqSize;
+    Dev->TxRing.Desc[DescIdx].Len   = Dev->NetReqSize;
     Dev->TxRing.Desc[DescIdx].Flags = VRING_DESC_F_NEXT;
     Dev->TxRing.Desc[DescIdx].Next  = (UINT16)(DescIdx + 1);
 
@@ -249,7 +240,8 @@ VirtioNetInitTx (
   Dev->TxSharedReq->V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_NONE;
 
   //
-  // For VirtIo 1.0 only -- the field exists, but it is unused
+  // For VirtIo 1.0 and VIRTIO_NET_F_MRG_RXBUF only -- the field exists, but it
+  // is unused
   //
   Dev->TxSharedReq->NumBuffers = 0;
 
@@ -294,7 +286,8 @@ FreeTxFreeStack:
     packet data into,
   - select polling over RX interrupt,
   - fully populate the RX queue with a static pattern of virtio descriptor
-    chains.
+    chains (single descriptors if VIRTIO_NET_F_MRG_RXBUF has been
+    negotiated).
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
@@ -313,37 +306,37 @@ VirtioNetInitRx (
   )
 {
   EFI_STATUS            Status;
-  UINTN                 VirtioNetReqSize;
   UINTN                 RxBufSize;
+  UINT16                DescsPerPkt;
   UINT16                RxAlwaysPending;
   UINTN                 PktIdx;
-  UINT16                DescIdx;
+  DESC_INDICES          Indices;
   UINTN                 NumBytes;
   EFI_PHYSICAL_ADDRESS  RxBufDeviceAddress;
   VOID                  *RxBuffer;
 
   //
-  // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
-  //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
-                     sizeof (VIRTIO_NET_REQ) :
-                     sizeof (VIRTIO_1_0_NET_REQ);
-
+  // For each incoming packet we must supply room for:
+  // - the virtio-net request header, plus
+  // - the network data (which consists of Ethernet header and Ethernet
+  //   payload).
   //
-  // For each incoming packet we must supply two descriptors:
-  // - the recipient for the virtio-net request header, plus
-  // - the recipient for the network data (which consists of Ethernet header
-  //   and Ethernet payload).
+  // Without VIRTIO_NET_F_MRG_RXBUF, these must be two separate descriptors.
+  // With it, the header is placed at the start of the (first) buffer, and one
+  // descriptor suffices.
   //
-  RxBufSize = VirtioNetReqSize +
+  RxBufSize = Dev->NetReqSize +
               (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
 
+  DescsPerPkt = Dev->RxMergeable ? 1 : 2;
+
   //
-  // Limit the number of pending RX packets if the queue is big. The division
-  // by two is due to the above "two descriptors per packet" trait.
+  // Limit the number of pending RX packets if the queue is big.
   //
-  RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  RxAlwaysPending = (UINT16)MIN (
+                              Dev->RxRing.QueueSize / DescsPerPkt,
+                              VNET_MAX_PENDING
+                              );
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -378,64 +371,78 @@ VirtioNetInitRx (
 
   Dev->RxBuf = RxBuffer;
 
-  //
-  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
-  //
-  MemoryFence ();
-  Dev->RxLastUsed = *Dev->RxRing.Used.Idx;
-  ASSERT (Dev->RxLastUsed == 0);
-
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device:
   // the host should not send interrupts, we'll poll in VirtioNetReceive()
   // and VirtioNetIsPacketAvailable().
   //
-  *Dev->RxRing.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+  MemoryFence ();
+  VirtioInitRingIndices (&Dev->RxRing, &Dev->RxRingIndices);
+  ASSERT (Dev->RxRingIndices.LastUsedIdx == 0);
 
   //
-  // now set up a separate, two-part descriptor chain for each RX packet, and
-  // link each chain into (from) the available ring as well
+  // now set up a separate descriptor chain for each RX packet, and link each
+  // chain into (from) the available ring as well
   //
-  DescIdx            = 0;
   RxBufDeviceAddress = Dev->RxBufDeviceBase;
   for (PktIdx = 0; PktIdx < RxAlwaysPending; ++PktIdx) {
     //
-    // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
-    // invisible to the host until we update the Index Field
+    // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
     //
-    Dev->RxRing.Avail.Ring[PktIdx] = DescIdx;
+    VirtioPrepareChain (
+      &Dev->RxRing,
+      (UINT16)(PktIdx * DescsPerPkt),
+      &Indices
+      );
+    if (Dev->RxMergeable) {
+      VirtioAppendDesc (
+        &Dev->RxRing,
+        RxBufDeviceAddress,
+        (UINT32)RxBufSize,
+        VRING_DESC_F_WRITE,
+        &Indices
+        );
+    } else {
+      VirtioAppendDesc (
+        &Dev->RxRing,
+        RxBufDeviceAddress,
+        Dev->NetReqSize,
+        VRING_DESC_F_WRITE | VRING_DESC_F_NEXT,
+        &Indices
+        );
+      VirtioAppendDesc (
+        &Dev->RxRing,
+        RxBufDeviceAddress + Dev->NetReqSize,
+        (UINT32)(RxBufSize - Dev->NetReqSize),
+        VRING_DESC_F_WRITE,
+        &Indices
+        );
+    }
+
+    RxBufDeviceAddress += RxBufSize;
 
     //
-    // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
+    // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
+    // invisible to the host until we update the Index Field
     //
-    Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
-    Dev->RxRing.Desc[DescIdx].Len   = (UINT32)VirtioNetReqSize;
-    Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE | VRING_DESC_F_NEXT;
-    Dev->RxRing.Desc[DescIdx].Next  = (UINT16)(DescIdx + 1);
-    RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
-
-    Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
-    Dev->RxRing.Desc[DescIdx].Len   = (UINT32)(RxBufSize - VirtioNetReqSize);
-    Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
-    RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+    VirtioQueueChain (&Dev->RxRing, &Indices, &Dev->RxRingIndices);
   }
 
-  //
-  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
-  //
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = RxAlwaysPending;
-
   //
   // At this point reception may already be running. In order to make it sure,
   // kick the hypervisor. If we fail to kick it, we must first abort reception
   // before tearing down anything, because reception may have been already
   // running even without the kick.
   //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
   // virtio-0.9.5, 2.4.1.4 Notifying the Device
   //
-  MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+  Status = VirtioKick (
+             Dev->VirtIo,
+             VIRTIO_NET_Q_RX,
+             &Dev->RxRing,
+             &Dev->RxRingIndices
+             );
   if (EFI_ERROR (Status)) {
     Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
     goto UnmapSharedBuffer;
@@ -557,9 +564,23 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
-  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
+  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS |
+              VIRTIO_NET_F_MRG_RXBUF | VIRTIO_F_VERSION_1 |
               VIRTIO_F_IOMMU_PLATFORM;
 
+  //
+  // In VirtIo 1.0, the NumBuffers field of the virtio-net request header is
+  // mandatory. In 0.9.5, it depends on VIRTIO_NET_F_MRG_RXBUF.
+  //
+  Dev->RxMergeable = (BOOLEAN)((Features & VIRTIO_NET_F_MRG_RXBUF) != 0);
+  if (Dev->RxMergeable ||
+      (Dev->VirtIo->Revision >= VIRTIO_SPEC_REVISION (1, 0, 0)))
+  {
+    Dev->NetReqSize = sizeof (VIRTIO_1_0_NET_REQ);
+  } else {
+    Dev->NetReqSize = sizeof (VIRTIO_NET_REQ);
+  }
+
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
   // discovery, and the device can also reject the selected set of features.
@@ -15,6 +15,44 @@
 
 #include "VirtioNet.h"
 
+/**
+  Locate the receive buffer that the host returned in a Used Ring Element.
+
+  @param[in]  Dev      The VNET_DEV driver instance.
+  @param[in]  UsedIdx  The (free-running) index of the Used Ring Element.
+  @param[out] DescIdx  The head descriptor index from the Used Ring Element.
+  @param[out] Len      The number of bytes the host wrote, from the Used Ring
+                       Element.
+
+  @return  The start of the receive buffer in the Receive Destination Area.
+**/
+STATIC
+UINT8 *
+VirtioNetRxUsedBuffer (
+  IN  VNET_DEV  *Dev,
+  IN  UINT16    UsedIdx,
+  OUT UINT16    *DescIdx,
+  OUT UINT32    *Len
+  )
+{
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+
+  UsedElem = &Dev->RxRing.Used.UsedElem[UsedIdx % Dev->RxRing.QueueSize];
+  *DescIdx = (UINT16)UsedElem->Id;
+  *Len     = UsedElem->Len;
+
+  //
+  // the host must not have filled in more data than requested
+  //
+  ASSERT (
+    *Len <= Dev->RxRing.Desc[*DescIdx].Len +
+    (Dev->RxMergeable ? 0 : Dev->RxRing.Desc[*DescIdx + 1].Len)
+    );
+
+  return Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[*DescIdx].Addr -
+                              Dev->RxBufDeviceBase);
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -64,18 +102,20 @@ VirtioNetReceive (
   OUT UINT16                      *Protocol   OPTIONAL
   )
 {
-  VNET_DEV    *Dev;
-  EFI_TPL     OldTpl;
-  EFI_STATUS  Status;
-  UINT16      RxCurUsed;
-  UINT16      UsedElemIdx;
-  UINT32      DescIdx;
-  UINT32      RxLen;
-  UINTN       OrigBufferSize;
-  UINT8       *RxPtr;
-  UINT16      AvailIdx;
-  EFI_STATUS  NotifyStatus;
-  UINTN       RxBufOffset;
+  VNET_DEV            *Dev;
+  EFI_TPL             OldTpl;
+  EFI_STATUS          Status;
+  UINT16              RxCurUsed;
+  UINT16              NumBuffers;
+  UINT16              BufIdx;
+  UINT16              DescIdx;
+  UINT32              UsedLen;
+  UINTN               RxLen;
+  UINTN               OrigBufferSize;
+  UINT8               *RxPtr;
+  VIRTIO_1_0_NET_REQ  *RxReq;
+  DESC_INDICES        Indices;
+  EFI_STATUS          NotifyStatus;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -101,24 +141,57 @@ VirtioNetReceive (
   RxCurUsed = *Dev->RxRing.Used.Idx;
   MemoryFence ();
 
-  if (Dev->RxLastUsed == RxCurUsed) {
+  if (Dev->RxRingIndices.LastUsedIdx == RxCurUsed) {
+    //
+    // publish the RX buffers recycled but held back earlier
+    //
     Status = EFI_NOT_READY;
-    goto Exit;
+    goto NotifyHost;
   }
 
-  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
-  DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
-  RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
-
   //
   // the virtio-net request header must be complete; we skip it
   //
-  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
-  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
+  RxPtr = VirtioNetRxUsedBuffer (
+            Dev,
+            Dev->RxRingIndices.LastUsedIdx,
+            &DescIdx,
+            &UsedLen
+            );
+  ASSERT (UsedLen >= Dev->NetReqSize);
+  RxReq = (VIRTIO_1_0_NET_REQ *)RxPtr;
+
   //
-  // the host must not have filled in more data than requested
+  // With VIRTIO_NET_F_MRG_RXBUF, the packet may span several buffers, each
+  // reported in a separate Used Ring Element. The header is only present in
+  // the first one. The host publishes all buffers of a packet at once, and
+  // can't use more buffers than VirtioNetInitRx() keeps pending on the queue;
+  // waiting for more would stall reception for good.
   //
-  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  NumBuffers = Dev->RxMergeable ? RxReq->NumBuffers : 1;
+  if ((NumBuffers == 0) ||
+      (NumBuffers > MIN (Dev->RxRing.QueueSize, VNET_MAX_PENDING)))
+  {
+    NumBuffers = 1;
+    Status     = EFI_DEVICE_ERROR;
+    goto RecycleDesc; // drop malformed packet
+  }
+
+  if (NumBuffers > (UINT16)(RxCurUsed - Dev->RxRingIndices.LastUsedIdx)) {
+    Status = EFI_NOT_READY;
+    goto NotifyHost;
+  }
+
+  RxLen = UsedLen - Dev->NetReqSize;
+  for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+    VirtioNetRxUsedBuffer (
+      Dev,
+      (UINT16)(Dev->RxRingIndices.LastUsedIdx + BufIdx),
+      &DescIdx,
+      &UsedLen
+      );
+    RxLen += UsedLen;
+  }
 
   OrigBufferSize = *BufferSize;
   *BufferSize    = RxLen;
@@ -133,14 +206,31 @@ VirtioNetReceive (
     goto RecycleDesc; // drop useless short packet
   }
 
+  //
+  // gather the packet data
+  //
+  RxLen = 0;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    RxPtr = VirtioNetRxUsedBuffer (
+              Dev,
+              (UINT16)(Dev->RxRingIndices.LastUsedIdx + BufIdx),
+              &DescIdx,
+              &UsedLen
+              );
+    if (BufIdx == 0) {
+      RxPtr   += Dev->NetReqSize;
+      UsedLen -= Dev->NetReqSize;
+    }
+
+    CopyMem ((UINT8 *)Buffer + RxLen, RxPtr, UsedLen);
+    RxLen += UsedLen;
+  }
+
   if (HeaderSize != NULL) {
     *HeaderSize = Dev->Snm.MediaHeaderSize;
   }
 
-  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
-                        Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
-  CopyMem (Buffer, RxPtr, RxLen);
+  RxPtr = Buffer;
 
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
@@ -163,20 +253,38 @@ VirtioNetReceive (
   Status = EFI_SUCCESS;
 
 RecycleDesc:
-  ++Dev->RxLastUsed;
-
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    VirtioNetRxUsedBuffer (
+      Dev,
+      Dev->RxRingIndices.LastUsedIdx++,
+      &DescIdx,
+      &UsedLen
+      );
+    VirtioPrepareChain (&Dev->RxRing, DescIdx, &Indices);
+    VirtioQueueChain (&Dev->RxRing, &Indices, &Dev->RxRingIndices);
+  }
 
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
+  //
+  // Notify the host about the recycled buffers in batches, and when we've
+  // caught up with the Used Ring.
+  //
+  if (((UINT16)(Dev->RxRingIndices.NextAvailIdx - *Dev->RxRing.Avail.Idx) <
+       VNET_RX_REFILL_BATCH) &&
+      (Dev->RxRingIndices.LastUsedIdx != RxCurUsed))
+  {
+    goto Exit;
+  }
 
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+NotifyHost:
+  NotifyStatus = VirtioKick (
+                   Dev->VirtIo,
+                   VIRTIO_NET_Q_RX,
+                   &Dev->RxRing,
+                   &Dev->RxRingIndices
+                   );
   if (!EFI_ERROR (Status)) {
     // earlier error takes precedence
     Status = NotifyStatus;
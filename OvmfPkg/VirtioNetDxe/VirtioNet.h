@@ -29,6 +29,12 @@
 //
 #define VNET_MAX_PENDING  64
 
+//
+// number of recycled RX buffers that VirtioNetReceive() collects before
+// notifying the host about them, unless the Used Ring is drained earlier
+//
+#define VNET_RX_REFILL_BATCH  16
+
 //
 // State diagram:
 //
@@ -76,12 +82,14 @@ typedef struct {
   EFI_EVENT                      ExitBoot;       // VirtioNetSnpPopulate
   EFI_DEVICE_PATH_PROTOCOL       *MacDevicePath; // VirtioNetDriverBindingStart
   EFI_HANDLE                     MacHandle;      // VirtioNetDriverBindingStart
+  UINT16                         NetReqSize;     // VirtioNetInitialize
+  BOOLEAN                        RxMergeable;    // VirtioNetInitialize
 
   VRING                          RxRing;          // VirtioNetInitRing
   VOID                           *RxRingMap;      // VirtioRingMap and
                                                   // VirtioNetInitRing
   UINT8                          *RxBuf;          // VirtioNetInitRx
-  UINT16                         RxLastUsed;      // VirtioNetInitRx
+  RING_INDICES                   RxRingIndices;   // VirtioNetInitRx
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx